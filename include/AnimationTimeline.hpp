@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Rodzaje efektów na osi czasu
+enum class EffectKind : std::uint8_t
+{
+    Blink,     // Widoczny / niewidoczny co `period` sekund (zaczyna widoczny)
+    Highlight, // Stały efekt przez czas trwania
+    Fade,      // Zanikanie: alpha = 1 - postęp
+    FloatUp,   // Przesunięcie z (fromX, fromY) do (toX, toY), np. latające punkty
+    Travel     // Ruch po łamanej z puli punktów (ścieżka kulki)
+};
+
+// Wspólna oś czasu dla animacji planszy. Efekty żyją w stałej puli, w układzie SoA
+// (osobna tablica na każde pole), więc advance() to jedna pętla po ciągłych tablicach,
+// a wygasły efekt jest usuwany w O(1) przez zamianę z ostatnim.
+// Uchwyty zawierają generację - uchwyt usuniętego efektu nie wskaże nowego.
+// Oś czasu nie zależy od SFML; czas podaje wywołujący (advance(dt)).
+class AnimationTimeline
+{
+public:
+    using Handle = std::uint32_t;
+    static const Handle InvalidHandle = 0;
+
+    explicit AnimationTimeline(size_t capacity = 1024);
+
+    // duration <= 0: efekt trwa do remove(). delay: efekt zaczyna się później (postęp 0).
+    // Zwraca InvalidHandle, gdy pula jest pełna.
+    Handle add(EffectKind kind, float duration, float fromX = 0.0f, float fromY = 0.0f,
+               float toX = 0.0f, float toY = 0.0f, int value = 0, float period = 0.0f, float delay = 0.0f);
+    // Travel po punktach (x0, y0, x1, y1, ...) ze stałą prędkością na odcinek
+    Handle addTravel(const std::vector<float>& points, float duration, int value);
+    void remove(Handle handle);
+    void clear();
+
+    // Przesuwa wszystkie efekty o dt sekund i usuwa zakończone
+    void advance(float dt);
+
+    bool isAlive(Handle handle) const;
+    bool isStarted(Handle handle) const;
+    // Dla Blink: czy w tej chwili widoczny; nieżywy uchwyt - zawsze widoczny
+    bool isVisible(Handle handle) const;
+
+    // Iteracja po żywych efektach (indeksy 0..size()-1 zmieniają się po advance/remove)
+    size_t size() const { return kinds.size(); }
+    size_t capacity() const { return maxEffects; }
+    EffectKind kind(size_t i) const { return kinds[i]; }
+    int value(size_t i) const { return values[i]; }
+    bool started(size_t i) const { return elapsed[i] >= 0.0f; }
+    float progress(size_t i) const;
+    float alpha(size_t i) const { return 1.0f - progress(i); }
+    void position(size_t i, float& x, float& y) const;
+
+private:
+    size_t maxEffects;
+
+    // Efekty - SoA, gęsto upakowane
+    std::vector<EffectKind> kinds;
+    std::vector<float> elapsed;   // Ujemne = jeszcze czeka (delay)
+    std::vector<float> durations;
+    std::vector<float> periods;
+    std::vector<float> fromXs, fromYs, toXs, toYs;
+    std::vector<int> values;
+    std::vector<std::uint32_t> pathStarts, pathCounts; // Travel: zakres w pathPoints
+    std::vector<std::uint32_t> slots;                  // Efekt -> slot uchwytu
+
+    // Uchwyty: slot -> indeks efektu i generacja; wolne sloty na stosie
+    std::vector<std::uint32_t> slotIndex;
+    std::vector<std::uint16_t> slotGeneration;
+    std::vector<std::uint32_t> freeSlots;
+
+    // Punkty ścieżek; czyszczone, gdy nie ma żadnego Travel
+    std::vector<float> pathPoints;
+    size_t travelCount;
+
+    int indexOf(Handle handle) const;
+    void removeAt(size_t index);
+    static Handle makeHandle(std::uint32_t slot, std::uint16_t generation);
+};
@@ -1,15 +1,13 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include "BallColor.hpp"
 
-enum class BallColor {
-    Red,
-    Green,
-    Blue,
-    Yellow,
-    Purple,
-    Orange
-};
+inline sf::Color toSFMLColor(BallColor color)
+{
+    BallRgb rgb = ballRgb(color);
+    return sf::Color(rgb.r, rgb.g, rgb.b);
+}
 
 class Ball {
 private:
@@ -17,13 +15,11 @@ private:
     sf::Vector2f position;
     BallColor color;
 
-    sf::Color getSFMLColor(BallColor ballColor) const;
-
 public:
     Ball(BallColor color, sf::Vector2f position);
     ~Ball();
 
-    void draw(sf::RenderWindow &window);
+    void draw(sf::RenderTarget &window);
     void update();
 
     BallColor getColor() const;
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+// Kolory kulek - osobny nagłówek, żeby logika gry nie zależała od SFML
+enum class BallColor {
+    Red,
+    Green,
+    Blue,
+    Yellow,
+    Purple,
+    Orange
+};
+
+struct BallRgb
+{
+    std::uint8_t r, g, b;
+};
+
+// Jedyna paleta kulek - korzystają z niej Board, ściana plansz, widok dużej planszy
+// i renderer programowy (wersja SFML: toSFMLColor w Ball.hpp)
+inline BallRgb ballRgb(BallColor color)
+{
+    switch (color)
+    {
+        case BallColor::Red: return {255, 0, 0};
+        case BallColor::Green: return {0, 255, 0};
+        case BallColor::Blue: return {0, 0, 255};
+        case BallColor::Yellow: return {255, 255, 0};
+        case BallColor::Purple: return {255, 0, 255}; // SFML nie ma Purple - Magenta
+        case BallColor::Orange: return {255, 165, 0};
+    }
+    return {255, 255, 255};
+}
@@ -4,6 +4,13 @@
 #include <random>
 #include <SFML/Graphics.hpp>
 #include "Ball.hpp"
+#include "BoardState.hpp"
+#include "BoardObserver.hpp"
+#include "PuzzleGenerator.hpp"
+#include "Snapshot.hpp"
+#include "AnimationTimeline.hpp"
+#include "LiveGameFile.hpp"
+#include "TextRenderer.hpp"
 
 class Board
 {
@@ -18,41 +25,73 @@ private:
     float cellSize;
     float offsetX, offsetY;
     
-    // Random generation
-    std::mt19937 rng;
+    // Random generation (licznik pobrań pozwala cofać stan generatora)
+    unsigned int gameSeed;     // Ziarno bieżącej gry - HeadlessGame::reset(gameSeed) odtwarza ją ruch po ruchu
+    unsigned long gameNumber;  // Zmienia się przy każdej nowej grze (reset, zagadka, wznowienie)
+    CountingRng rng;
     std::uniform_int_distribution<int> colorDist;
     
     // Game logic
     int selectedX, selectedY;
     bool hasBallSelected;
-    sf::Clock blinkClock;
-    bool blinkState;
     
     // Line detection and animation
     std::vector<std::vector<bool>> lineMarked;
-    sf::Clock lineAnimationClock;
-    sf::Clock blinkTimer; // Oddzielny timer dla migania
     bool lineAnimationActive;
-    int animationPhase; // 0=highlight, 1=fast_blink, 2=remove
-    bool fastBlinkState;
     
     // Scoring system
     int score;
     int comboMultiplier;
-    std::vector<std::pair<sf::Vector2f, int>> floatingScores; // pozycja, punkty
-    sf::Clock scoreAnimationClock;
+
+    // Wszystkie animacje (miganie, linie, latające punkty, ruch kulki) na jednej osi czasu
+    AnimationTimeline timeline;
+    sf::Clock frameClock;
+    AnimationTimeline::Handle selectionBlink;
+    AnimationTimeline::Handle lineHighlight; // Faza 1: podświetlenie linii
+    AnimationTimeline::Handle lineBlink;     // Faza 2: szybkie miganie, potem usunięcie
+    AnimationTimeline::Handle travelEffect;  // Kulka w drodze do (travelX, travelY)
+    int travelX, travelY;
     
     // New balls system
     std::vector<BallColor> nextBalls; // 2 następne kulki
     bool gameOver;
     int ballsToAdd; // Ile kulek dodać po ruchu
 
-    // UI Elements
-    sf::Font font;
-    sf::Text scoreText;
-    sf::Text gameOverText;
-    sf::Text restartText;
-    bool fontLoaded;
+    // UI Elements - napisy z wbudowanej czcionki
+    TextRenderer text;
+    int personalBest; // Z bazy wyników; -1 = jeszcze nie wczytany
+    int turnCount;
+
+    // Podpowiedź ruchu i wersja stanu (zmienia się przy każdej mutacji planszy)
+    unsigned long stateVersion;
+    Move hintMove;
+    unsigned long hintVersion;
+
+    // Obserwatorzy zmian stanu (eksport danych itp.)
+    std::vector<BoardObserver*> observers;
+
+    // Tryb zagadki: bez dokładania kulek, limit ruchów i cel w liniach
+    bool puzzleMode;
+    int puzzleMovesLeft;
+    int puzzleGoal;
+    int puzzleLines;
+
+    // Tryb turbo: animacje linii rozstrzygane natychmiast, bez latających punktów
+    bool turboMode;
+
+    // Drzewo BFS od wybranej kulki: rodzic każdego osiągalnego pola (-1 = nieosiągalne).
+    // Ważne, dopóki plansza się nie zmieni (reachVersion == stateVersion).
+    std::vector<int> reachParent;
+    int reachSourceX, reachSourceY;
+    unsigned long reachVersion;
+    std::vector<int> reachQueue;
+    int hoverX, hoverY; // Pole pod kursorem - podgląd ścieżki
+
+    // Stan po każdej zakończonej turze - cofanie i ponawianie ruchów
+    SnapshotHistory history;
+
+    // Bieżąca gra w zmapowanym pliku - aktualizowana po każdej mutacji (nullptr = bez zapisu)
+    LiveGameFile* liveFile;
 
 public:
     Board(int w, int h);
@@ -60,14 +99,18 @@ public:
 
     void initialize();
     void reset();
-    void draw(sf::RenderWindow &window);
+    void reset(unsigned int seed); // Powtarzalna gra - np. odtwarzanie nagranego wejścia
+    void clearState(); // Pusta plansza, zerowy wynik, bez zaznaczenia i animacji - wspólne dla reset i loadPuzzle
+    unsigned int getGameSeed() const { return gameSeed; }
+    unsigned long getGameNumber() const { return gameNumber; }
+    void draw(sf::RenderTarget &window);
     void initializeGraphics();
-    void drawGrid(sf::RenderWindow &window);
+    void drawGrid(sf::RenderTarget &window);
     void update(); // Nowa metoda do aktualizacji logiki
     
     // Ball management
     void generateBalls();
-    void drawBalls(sf::RenderWindow &window);
+    void drawBalls(sf::RenderTarget &window);
     void placeBallAt(int x, int y, BallColor color);
     BallColor getRandomColor();
     
@@ -79,20 +122,24 @@ public:
     void moveBall(int fromX, int fromY, int toX, int toY);
     void selectBall(int x, int y);
     void deselectBall();
+    void computeReachable(int fromX, int fromY);
+    void ensureReachable(int fromX, int fromY);
+    void handleMouseMove(float mouseX, float mouseY);
+    void drawPathPreview(sf::RenderTarget& window);
     
     // Line detection system
     std::vector<std::vector<std::pair<int, int>>> findAllLines();
     std::vector<std::pair<int, int>> checkDirection(int startX, int startY, int dx, int dy, BallColor color);
     void markLinesForRemoval(const std::vector<std::vector<std::pair<int, int>>>& lines);
     void startLineAnimation();
+    void stopLineAnimation();
     void updateLineAnimation();
     void removeLinesAndUpdateScore();
     bool hasMarkedLines();
     
     // Scoring and effects
     void addScore(int points, sf::Vector2f position);
-    void updateFloatingScores();
-    void drawFloatingScores(sf::RenderWindow& window);
+    void drawEffects(sf::RenderTarget& window);
     int calculateLineScore(int lineLength);
     
     // New balls system
@@ -101,18 +148,58 @@ public:
     std::vector<std::pair<int, int>> getEmptyPositions();
     bool hasAvailableMoves();
     void checkGameOver();
-    void drawNextBalls(sf::RenderWindow& window);
+    void drawNextBalls(sf::RenderTarget& window);
+
+    // Hint system
+    BoardState snapshot() const;
+    bool isSettled() const { return !lineAnimationActive && !gameOver; }
+    unsigned long getStateVersion() const { return stateVersion; }
+    void showHint(const Move& move);
+    void drawHint(sf::RenderTarget& window);
+
+    // Observers
+    void addObserver(BoardObserver* observer);
+    void removeObserver(BoardObserver* observer);
+    void notifyScore();
+
+    // Puzzle mode
+    bool loadPuzzle(const Puzzle& puzzle);
+    void checkPuzzleEnd();
+    void drawPuzzleStatus(sf::RenderTarget& window);
+    void drawGameOverText(sf::RenderTarget& window, const std::string& title, sf::Color color,
+                          const std::string& hint = "Press R to Restart");
+    bool isPuzzleMode() const { return puzzleMode; }
+    bool isPuzzleSolved() const { return puzzleMode && puzzleLines >= puzzleGoal; }
+
+    // Turbo autoplay
+    void setTurbo(bool enabled);
+    bool isTurbo() const { return turboMode; }
+    void settleAnimations();
+
+    // Undo / redo
+    void captureTurn();
+    bool undo();
+    bool redo();
+    void restoreTurn(const BoardSnapshot& target, const BoardSnapshot* from);
+    const SnapshotHistory& getHistory() const { return history; }
+
+    // Wznawianie po awarii: zapis stanu do pliku i odtworzenie z niego
+    void attachLiveFile(LiveGameFile* file);
+    void saveLive();
+    bool resumeLive(const LiveGameRecord& record);
 
     // Helpers
     sf::Color getBallColor(int ballType);
-    sf::Color getSFMLColorFromBallColor(BallColor ballColor) const;
     sf::Vector2f getCellPosition(int x, int y) const;
+    sf::Vector2f getCellCenter(int x, int y) const;
     bool isValidPosition(int x, int y) const;
     bool isEmpty(int x, int y) const;
     
     // Getters
     int getScore() const { return score; }
     int getCombo() const { return comboMultiplier; }
+    int getTurn() const { return turnCount; }
+    void setPersonalBest(int best) { personalBest = best; }
     const std::vector<BallColor>& getNextBalls() const { return nextBalls; }
     bool isGameOver() const { return gameOver; }
 
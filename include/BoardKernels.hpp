@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+#include "BoardState.hpp"
+
+// Plansza w układzie dla jąder: bajt na pole, wiersze co stride = width + 1 bajtów
+// (ostatnia kolumna to ściana) i wiersz ścian nad oraz pod planszą. Dzięki ścianom
+// sąsiedzi i okna linii nigdy nie wychodzą poza bufor ani nie przechodzą do następnego wiersza.
+// Za planszą jest zapas ścian na jeden wektor, więc pętle wektorowe nie potrzebują końcówek.
+struct KernelBoard
+{
+    static constexpr std::uint8_t Wall = 0xFF;
+    static const int Padding = 64;
+
+    int width = 0;
+    int height = 0;
+    int stride = 1;
+    std::vector<std::uint8_t> cells;
+
+    // Bufory wyników jąder - przydzielane raz na rozmiar planszy
+    std::vector<std::uint8_t> marked;  // 0xFF = pole w linii
+    std::vector<std::uint8_t> reach;   // 0xFF = puste pole osiągalne
+    std::vector<std::uint32_t> empty;  // Indeksy pustych pól, wiersz po wierszu
+
+    void resize(int w, int h);
+    void load(const BoardState& state);
+    void clear();
+
+    int index(int x, int y) const { return (y + 1) * stride + x; }
+    int xOf(int index) const { return index % stride; }
+    int yOf(int index) const { return index / stride - 1; }
+    int size() const { return static_cast<int>(cells.size()) - Padding; } // Bez zapasu
+    void set(int x, int y, int value) { cells[index(x, y)] = static_cast<std::uint8_t>(value); }
+};
+
+// Gorące jądra silnika (linie, osiągalność, puste pola, koniec gry) w kilku wersjach
+// zestawu instrukcji: skalarnej, SSE4.2, AVX2 i AVX-512. Wersje wektorowe to ten sam kod
+// kompilowany z różnym atrybutem target; wybór następuje raz, przy pierwszym użyciu (cpuid),
+// osobno dla każdego jądra - wersja wektorowa tylko tam, gdzie na danym zestawie jest szybsza.
+// Wyniki wszystkich wersji są identyczne - sprawdza to selfTest.
+class BoardKernels
+{
+public:
+    // Zaznacza w board.marked pola wszystkich linii z co najmniej lineLength kulek
+    // (te same pola co BoardState::findAllLines), zwraca ich liczbę
+    static int markLines(KernelBoard& board, int lineLength);
+    // Puste pola osiągalne z kulki na `from` (indeks KernelBoard) do board.reach.
+    // Kończy wcześniej, gdy dotrze do `to`; zwraca, czy `to` jest osiągalne (to < 0: zawsze false).
+    static bool fillReachable(KernelBoard& board, int from, int to = -1);
+    // Puste pola do board.empty, zwraca ich liczbę
+    static int collectEmpty(KernelBoard& board);
+    // Czy jakakolwiek kulka ma pustego sąsiada
+    static bool hasMobileBall(const KernelBoard& board);
+
+    static const char* variantName();
+    // Porównuje każdą wersję dostępną na tym procesorze z wersją skalarną i z BoardState
+    // na losowych planszach; wypisuje raport, zwraca false przy pierwszej różnicy
+    static bool selfTest(std::ostream& out);
+};
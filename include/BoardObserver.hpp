@@ -0,0 +1,36 @@
+#pragma once
+#include <utility>
+#include <vector>
+#include "BoardState.hpp"
+
+// Powiadomienia z miejsc, w których zmienia się stan gry
+// (moveBall, addNewBalls, removeLinesAndUpdateScore, checkGameOver).
+// Wywoływane w wątku, który prowadzi daną grę.
+class BoardObserver
+{
+public:
+    virtual ~BoardObserver() = default;
+
+    // Stan sprzed ruchu i sam ruch
+    virtual void onMove(const BoardState&, const Move&) {}
+    // Stan po dołożeniu kulek i ich pozycje
+    virtual void onBallsAdded(const BoardState&, const std::vector<std::pair<int, int>>&) {}
+    // Stan tuż przed usunięciem linii (kulki z linii jeszcze na planszy)
+    virtual void onLinesFound(const BoardState&) {}
+    // Stan po usunięciu linii, liczba usuniętych kulek i zdobyte punkty
+    virtual void onLinesRemoved(const BoardState&, int, int) {}
+    virtual void onGameOver(const BoardState&) {}
+
+    // Drobne zmiany pojedynczych elementów stanu (strumień delt dla widzów).
+    // Pole (x, y) ma nową wartość: 0 = puste, 1-6 = kolor
+    virtual void onCellChanged(int, int, int) {}
+    // Wybrana kulka; (-1, -1) = brak wyboru
+    virtual void onSelectionChanged(int, int) {}
+    // Pola oznaczone do usunięcia (pusta lista = brak oznaczeń)
+    virtual void onLinesMarked(const std::vector<std::pair<int, int>>&) {}
+    // Wynik i mnożnik combo
+    virtual void onScoreChanged(int, int) {}
+    virtual void onNextBalls(const std::vector<BallColor>&) {}
+    // Cały stan zastąpiony (restart, wczytana zagadka)
+    virtual void onReset(const BoardState&) {}
+};
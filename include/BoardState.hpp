@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "BallColor.hpp"
+
+// Ruch kulki z (fromX, fromY) na (toX, toY)
+struct Move
+{
+    int fromX, fromY;
+    int toX, toY;
+};
+
+// Lekka kopia stanu planszy bez obiektów SFML.
+// Można ją bezpiecznie przekazać do innego wątku (np. do analizy ruchów).
+class BoardState
+{
+public:
+    int width;
+    int height;
+    std::vector<int> cells; // wiersz po wierszu: 0 = puste, 1-6 = kolor
+    std::vector<BallColor> nextBalls;
+    int score;
+    int combo;
+    int lineLength; // Najkrótsza usuwana linia (Board: 3)
+
+    BoardState();
+    BoardState(int w, int h);
+
+    int at(int x, int y) const { return cells[y * width + x]; }
+    void set(int x, int y, int value) { cells[y * width + x] = value; }
+    bool isValidPosition(int x, int y) const;
+    bool isEmpty(int x, int y) const;
+
+    // Wszystkie puste pola osiągalne z (x, y) - jeden BFS
+    std::vector<std::pair<int, int>> reachableFrom(int x, int y) const;
+    // Numer spójnego obszaru pustych pól dla każdego pola (-1 dla kulek), zwraca liczbę obszarów
+    int labelEmptyRegions(std::vector<int>& labels) const;
+    bool canReach(const std::vector<int>& labels, const Move& move) const;
+    std::vector<Move> legalMoves() const;
+    std::vector<std::pair<int, int>> getEmptyPositions() const;
+
+    // Te same zasady co Board::findAllLines / Board::checkDirection (przy lineLength = 3)
+    std::vector<std::vector<std::pair<int, int>>> findAllLines() const;
+    std::vector<std::pair<int, int>> checkDirection(int startX, int startY, int dx, int dy, int value) const;
+    int longestRunThrough(int x, int y) const;
+    int runLength(int x, int y, int dx, int dy) const; // Bez alokacji - długość ciągu przez (x, y)
+    // Kierunki, w których przez (x, y) biegnie linia (co najmniej lineLength kulek). Na planszy bez linii
+    // przed ruchem to liczba linii zrobionych ruchem na (x, y) - skrzyżowanie liczy się jako dwie.
+    // Tą samą regułą liczą zagadki PuzzleGenerator i Board.
+    int linesThrough(int x, int y) const;
+
+    void applyMove(const Move& move);
+    int clearLines(); // Usuwa wszystkie linie, zwraca liczbę usuniętych kulek
+    bool hasAvailableMoves() const;
+
+    // Punkty za usunięcie kulek przy danym combo - ta sama reguła co w Board.
+    // Premia za długość trafia do wyniku dwa razy (tak zawsze liczyła gra).
+    static int pointsForClear(int removed, int combo);
+};
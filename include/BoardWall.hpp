@@ -0,0 +1,50 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <random>
+#include <vector>
+#include "HeadlessGame.hpp"
+
+// Ściana z wieloma symulowanymi grami w jednym oknie (monitoring botów).
+// Geometria wszystkich kafelków jest liczona raz i rysowana jednym wywołaniem draw;
+// co klatkę przepisywane są tylko kolory pól, które zmieniły się od poprzedniej klatki.
+class BoardWall
+{
+private:
+    struct Tile
+    {
+        std::unique_ptr<HeadlessGame> game;
+        std::vector<int> drawnCells; // Co jest aktualnie w wierzchołkach
+        bool drawnGameOver = false;
+        int gameOverFrames = 0;      // Jak długo skończona gra jest już pokazana
+        size_t firstVertex = 0;
+    };
+
+    int columns;
+    int rows;
+    int boardWidth;
+    int boardHeight;
+    std::vector<Tile> tiles;
+    std::vector<sf::Vertex> vertices;
+    std::mt19937 botRng;
+    size_t nextTile;          // Gra, od której zaczyna się kolejna porcja symulacji
+    unsigned long movesPlayed;
+    unsigned long cellsUpdated;
+
+    void buildGeometry(float left, float top, float width, float height);
+    void setQuadColor(size_t firstVertex, sf::Color color);
+    void refreshTile(Tile& tile);
+
+public:
+    BoardWall(int cols, int rowCount, int w = 10, int h = 10, unsigned int seed = 1);
+
+    // Rozmieszcza kafelki w prostokącie okna
+    void layout(float left, float top, float width, float height);
+    // Gra ruchy po kolei we wszystkich grach, aż skończy się budżet czasu klatki
+    void update(sf::Time budget);
+    void draw(sf::RenderTarget& window);
+
+    unsigned long takeMovesPlayed();
+    unsigned long takeCellsUpdated();
+    size_t size() const { return tiles.size(); }
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include "HeadlessGame.hpp"
+
+// Tekstowy protokół dla zewnętrznych silników (w duchu UCI), jedna komenda na linię.
+// Plansza to napis o stałej długości width*height, wiersz po wierszu:
+// '.' = puste pole, '1'-'6' = kolor. Następne kulki: dwie cyfry '1'-'6'.
+//
+//   kulki                      -> id name kulki / id size <w> <h> / kulkiok
+//   isready                    -> readyok
+//   newgame [seed]             -> position <plansza> <następne> <wynik> <tura> <koniec 0/1>
+//   position                   -> position ...
+//   move fx fy tx ty           -> moved <punkty>, potem position ... | illegal
+//   legal [plansza]            -> moves <n> fx fy tx ty ...
+//   apply <plansza> fx fy tx ty -> result <usunięte> <punkty> <plansza> | illegal
+//   batch <n>                  -> n kolejnych linii legal/apply, odpowiedzi w jednym zapisie, batchok
+//   quit
+//
+// apply nie dokłada kulek (to wymaga losowania), więc wynik jest deterministyczny.
+// Wszystkie bufory są używane ponownie - po rozgrzaniu komendy nie alokują pamięci.
+class BotProtocol
+{
+private:
+    HeadlessGame game;
+    BoardState scratch;         // Plansza dla zapytań legal/apply
+    std::vector<int> labels;
+    std::string line;
+    std::string out;
+    int pendingBatch;           // Ile linii paczki jeszcze zostało
+
+    bool readLine(std::FILE* input);
+    void flush(std::FILE* output);
+
+    bool parseBoard(std::string_view text, BoardState& state) const;
+    static bool parseInt(std::string_view& text, int& value);
+    static std::string_view nextToken(std::string_view& text);
+
+    void appendInt(int value);
+    void appendBoard(const BoardState& state);
+    void appendPosition();
+
+    void handleMove(std::string_view args);
+    void handleLegal(std::string_view args);
+    void handleApply(std::string_view args);
+    void handleBatchLine(std::string_view query);
+
+public:
+    BotProtocol(int width, int height, unsigned int seed);
+
+    // Przetwarza komendy ze strumienia do "quit" albo końca wejścia
+    int run(std::FILE* input = stdin, std::FILE* output = stdout);
+
+    // Jedna linia wejścia (komenda albo kolejna linia paczki); false dla "quit".
+    // Odpowiedź jest dopisywana do bufora output() - wysyła ją wywołujący.
+    bool handleCommand(std::string_view command);
+    std::string& output() { return out; }
+
+    // Nowa gra i czyste bufory - np. gdy sesja z puli obsługuje nowe połączenie
+    void reset(unsigned int seed);
+
+    // Usypianie sesji: tylko między komendami - bez niedokończonej paczki i niewysłanej odpowiedzi
+    bool isIdle() const { return pendingBatch == 0 && out.empty(); }
+    bool hibernate(CompactGame& compact) const { return isIdle() && game.hibernate(compact); }
+    // Budzi uśpioną grę w tym obiekcie (bufory zostają, ale są czyszczone)
+    bool restore(const CompactGame& compact);
+};
@@ -0,0 +1,134 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BoardObserver.hpp"
+
+// Format pliku (little-endian):
+//   nagłówek: "KDS1", uint32 version, uint32 width, uint32 height
+//   bloki:    uint32 recordCount, potem kolejne kolumny, każda jako
+//             uint32 rawSize, uint32 storedSize, uint8 codec (0 = surowe, 1 = LZ), dane
+// Kolumny w bloku:
+//   gameId      - varint (zigzag), różnica względem poprzedniego rekordu
+//   turn        - varint (zigzag), różnica względem poprzedniego rekordu
+//   board       - 3 bity na pole, XOR z poprzednim rekordem tej samej gry
+//   nextBalls   - 1 bajt: kolor+1 w bitach 0-2 i 3-5
+//   move        - 4 bajty: fromX, fromY, toX, toY
+//   scoreDelta  - varint (zigzag)
+//   outcome     - varint, końcowy wynik gry
+
+// Jeden rekord po odczycie
+struct DatasetRecord
+{
+    std::uint64_t gameId;
+    std::uint32_t turn;
+    std::vector<std::uint8_t> cells;
+    std::vector<BallColor> nextBalls;
+    Move move;
+    std::int32_t scoreDelta;
+    std::int32_t outcome;
+};
+
+// Rekordy jednej gry w układzie kolumnowym
+struct GameRecord
+{
+    std::uint64_t gameId = 0;
+    std::int32_t outcome = 0;
+    std::vector<std::uint32_t> turns;
+    std::vector<std::uint8_t> cells; // width*height bajtów na rekord
+    std::vector<std::uint8_t> nextBalls;
+    std::vector<std::uint8_t> moves; // 4 bajty na rekord
+    std::vector<std::int32_t> scoreDeltas;
+
+    size_t size() const { return turns.size(); }
+    void clear();
+};
+
+// Zbiera (stan, ruch, zmiana wyniku) z jednej gry; wynik końcowy dopisuje przy game over
+class GameRecorder : public BoardObserver
+{
+private:
+    GameRecord record;
+    int scoreBefore;
+    bool finished;
+
+public:
+    GameRecorder();
+
+    void start(std::uint64_t gameId);
+    bool isFinished() const { return finished; }
+    GameRecord& getRecord() { return record; }
+
+    void onMove(const BoardState& before, const Move& move) override;
+    void onGameOver(const BoardState& finalState) override;
+};
+
+// Strumieniowy zapis rekordów z wielu równoległych gier.
+// Pełne bloki trafiają do ograniczonej kolejki; kompresją i zapisem zajmują się wątki w tle.
+class DatasetWriter
+{
+private:
+    struct Block
+    {
+        GameRecord columns;
+        std::vector<std::uint64_t> gameIds;
+        std::vector<std::int32_t> outcomes;
+    };
+
+    std::ofstream file;
+    int width;
+    int height;
+    size_t recordsPerBlock;
+    size_t maxPendingBlocks;
+
+    std::mutex mutex;
+    std::condition_variable queueChanged;
+    Block current;
+    std::deque<Block> pending;
+    bool closing;
+
+    std::mutex fileMutex;
+    std::vector<std::thread> ioThreads;
+    std::uint64_t recordsWritten;
+    std::uint64_t bytesWritten;
+
+    void ioLoop();
+    std::vector<std::uint8_t> encodeBlock(const Block& block) const;
+
+public:
+    DatasetWriter(int w, int h, size_t blockSize = 65536, size_t maxPending = 8);
+    ~DatasetWriter();
+
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    bool open(const std::string& path, int threads = 1);
+    void submit(const GameRecord& game);
+    void close();
+
+    std::uint64_t getRecordsWritten();
+    std::uint64_t getBytesWritten();
+};
+
+// Odczyt pliku zapisanego przez DatasetWriter - blok po bloku
+class DatasetReader
+{
+private:
+    std::ifstream file;
+    int width;
+    int height;
+
+public:
+    DatasetReader();
+
+    bool open(const std::string& path);
+    bool readBlock(std::vector<DatasetRecord>& records);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+
+// Czcionka 5x7 wkompilowana w program - bez plików czcionek, identyczna na każdej
+// platformie. Używa jej HUD gry (TextRenderer) i miniatury (SoftwareRenderer).
+class EmbeddedFont
+{
+public:
+    static constexpr int Columns = 5;
+    static constexpr int Rows = 7;
+
+    // 7 wierszy znaku (bit 4 to lewa kolumna) albo nullptr, gdy znaku nie ma
+    static const std::uint8_t* glyph(char c);
+
+    // Maska pokrycia 0-255 o rozmiarze width x height, podpróbkowanie 4x4.
+    // `mask` musi mieć miejsce na width * height bajtów.
+    static void rasterize(char c, int width, int height, std::uint8_t* mask);
+};
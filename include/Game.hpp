@@ -1,22 +1,98 @@
 #pragma once
+#include <atomic>
+#include <fstream>
+#include <random>
+#include <thread>
 #include <SFML/Graphics.hpp>
 #include "../include/Board.hpp"
+#include "../include/BoardWall.hpp"
+#include "../include/HintEngine.hpp"
+#include "../include/HugeBoardView.hpp"
+#include "../include/InputLatency.hpp"
+#include "../include/LiveGameFile.hpp"
+#include "../include/PuzzleGenerator.hpp"
+#include "../include/ResultsStore.hpp"
+#include "../include/StateStream.hpp"
 
 
 class Game {
 private:
+    // Czas startu: liczony od pierwszego pola, więc obejmuje utworzenie okna i planszy
+    sf::Clock startupClock;
+    sf::Time constructedAt;
+    bool firstFrameShown;
+
     sf::RenderWindow window;
+    // Bez okna (odtwarzanie wejścia): klatki rysowane do tekstury
+    bool offscreen;
+    sf::RenderTexture frame;
+    unsigned long frameIndex;
+
+    // Opóźnienie kliknięć i opcjonalne nagrywanie wejścia do odtworzenia
+    InputLatency latency;
+    std::ofstream inputLog;
+
     Board board;
+    HintEngine hintEngine;
+    unsigned long analyzedVersion; // Wersja planszy przekazana do analizy
+    std::vector<Puzzle> puzzles;   // Wczytywane przy pierwszym P
+    size_t nextPuzzle;
+
+    // Turbo: bot gra tyle ruchów, ile zmieści się w klatce; rysujemy raz na klatkę.
+    // Na własnej planszy - gra gracza, jej plik bieżącej gry, historia i wyniki zostają nietknięte.
+    std::unique_ptr<Board> turboBoard;
+    std::mt19937 botRng;
+    unsigned long turboMoves;
+    sf::Clock turboStatsClock;
+
+    // Strumień delt dla widzów; podłączany do planszy przy pierwszym widzu
+    StateStreamWriter stream;
+
+    // Ściana z wieloma grami botów zamiast jednej planszy (klawisz W)
+    std::unique_ptr<BoardWall> wall;
+    sf::Clock wallStatsClock;
+
+    // Wariant wytrzymałościowy na ogromnej planszy (klawisz G)
+    std::unique_ptr<HugeBoard> hugeBoard;
+    std::unique_ptr<HugeBoardView> hugeView;
+
+    // Baza wyników otwierana w tle - wczytanie dużego pliku nie opóźnia pierwszej klatki
+    ResultsStore results;
+    std::thread resultsLoader;
+    std::atomic<bool> resultsReady;
+    bool bestShown;
+    // Najlepsze zakończenie bieżącej gry - do bazy trafia dopiero po zmianie gry albo przy zamknięciu,
+    // bo cofnięcie ruchu po końcu gry pozwala ją zakończyć jeszcze raz, lepiej
+    ResultRecord finishedResult;
+    unsigned long finishedGame; // Board::getGameNumber() gry z finishedResult (0 = brak)
+
+    // Bieżąca gra w zmapowanym pliku - po awarii gra wznawia się od ostatniej tury
+    LiveGameFile live;
 
 public: 
-    Game();
+    explicit Game(bool offscreen = false);
     ~Game();
 
     int run();
     void handleEvents();
+    void handleEvent(const sf::Event& event);
     void update();
     void render();
     void gameLoop();
+    void updateHintAnalysis();
+    void loadNextPuzzle();
+    void setTurbo(bool enabled);
+    void playTurbo();
+    void addSpectator(int fd);
+    void toggleWall();
+    void toggleHugeBoard();
+    bool handleHugeBoardEvent(const sf::Event& event);
+    void recordResult();
+    void storeFinished();
+    bool recordInput(const std::string& path);
+
+    Board& getBoard() { return board; }
+    const InputLatency& getLatency() const { return latency; }
 
 
 };
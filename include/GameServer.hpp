@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "BotProtocol.hpp"
+
+// Serwer gier na gnieździe uniksowym: każde połączenie to osobna plansza
+// obsługiwana protokołem BotProtocol. Jeden wątek (i jedna pętla epoll) na rdzeń;
+// nowe połączenia rozkładają się między wątki przez EPOLLEXCLUSIVE na gnieździe
+// nasłuchującym, więc sesja przez całe życie należy do jednego wątku i nie wymaga blokad.
+// Obudzonych sesji (z protokołem, grą i buforami) jest co najwyżej hotLimit na wątek;
+// najdawniej używana bezczynna sesja jest usypiana do CompactGame i budzona przy następnej komendzie.
+class GameServer
+{
+private:
+    static const std::uint32_t NoHot = 0xFFFFFFFFu;
+
+    // Stała część sesji - cała pamięć uśpionej sesji
+    struct Session
+    {
+        int fd = -1;
+        std::uint32_t hot = NoHot; // Indeks w Shard::hot; NoHot - sesja uśpiona w `sleeping`
+        CompactGame sleeping;
+    };
+    static_assert(sizeof(Session) <= 64, "Uśpiona sesja ma się mieścić w 64 bajtach");
+
+    // Obudzona sesja; od najnowszej do najstarszej połączone w listę LRU
+    struct HotSession
+    {
+        BotProtocol protocol;
+        std::string input;       // Niepełna linia z poprzedniego odczytu
+        size_t outputSent = 0;   // Ile bajtów z protocol.output() już wysłano
+        bool closing = false;
+        std::uint32_t session = 0;
+        std::uint32_t newer = NoHot;
+        std::uint32_t older = NoHot;
+
+        HotSession(int width, int height, unsigned int seed) : protocol(width, height, seed) {}
+    };
+
+    // Pula sesji jednego wątku - zwolnione sesje (z buforami) trafiają na listy wolnych
+    struct Shard
+    {
+        int epollFd = -1;
+        std::vector<Session> sessions;
+        std::vector<std::uint32_t> freeList;
+        std::vector<std::unique_ptr<HotSession>> hot;
+        std::vector<std::uint32_t> freeHot;
+        std::uint32_t newest = NoHot;
+        std::uint32_t oldest = NoHot;
+
+        // Statystyki czytane przez wątek raportujący - pod blokadą shardu
+        std::mutex statsMutex;
+        std::vector<std::uint32_t> latencyMicros; // Histogram: indeks = mikrosekundy
+        std::uint64_t moves = 0;
+        size_t active = 0;
+        size_t pooled = 0;
+        size_t awake = 0;
+        std::uint64_t wakeups = 0;
+        std::uint64_t wakeNanos = 0;
+    };
+
+    std::string socketPath;
+    int width;
+    int height;
+    size_t hotLimit; // Na wątek
+    size_t hotSessions;
+    int listenFd;
+    std::atomic<bool> running;
+    std::atomic<unsigned int> nextSeed;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    void workerLoop(Shard& shard);
+    void acceptConnections(Shard& shard);
+    void handleReadable(Shard& shard, std::uint32_t index);
+    bool flushSession(Shard& shard, std::uint32_t index);
+    void closeSession(Shard& shard, std::uint32_t index);
+    void updateInterest(Shard& shard, std::uint32_t index, bool wantWrite, bool wantRead = true);
+    void recordLatency(Shard& shard, std::uint64_t micros, int count);
+    void printStats();
+
+    HotSession& wake(Shard& shard, std::uint32_t index);
+    std::uint32_t acquireHot(Shard& shard);
+    void releaseHot(Shard& shard, std::uint32_t index);
+    void unlinkHot(Shard& shard, std::uint32_t slot);
+    void linkNewest(Shard& shard, std::uint32_t slot);
+
+public:
+    // hot: ile sesji naraz trzymać obudzonych (łącznie, dzielone między wątki)
+    GameServer(const std::string& path, int w = 10, int h = 10, size_t hot = 100000);
+    ~GameServer();
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    // Blokuje do wywołania stop(); threads = 0 oznacza tyle, ile rdzeni
+    int run(int threads = 0);
+    // Bezpieczne w obsłudze sygnału
+    void stop() { running = false; }
+};
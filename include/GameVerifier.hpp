@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BoardState.hpp"
+#include "HeadlessGame.hpp"
+
+// Zgłoszone gry: ziarno, ruchy i deklarowany wynik. Ruchy wszystkich gier leżą w jednej tablicy
+// (gra i: moves[moveStart[i]..moveStart[i+1])), więc tysiące gier to kilka alokacji.
+struct GameBatch
+{
+    std::vector<std::uint32_t> seeds;
+    std::vector<std::int32_t> claimedScores;
+    std::vector<std::uint32_t> moveStart{0};
+    std::vector<Move> moves;
+
+    void add(std::uint32_t seed, std::int32_t claimedScore, const std::vector<Move>& gameMoves);
+    void clear();
+    size_t size() const { return seeds.size(); }
+};
+
+struct Verification
+{
+    enum Verdict : std::uint8_t
+    {
+        Valid,
+        IllegalMove,     // Ruch spoza planszy, z pustego pola albo do nieosiągalnego
+        MoveAfterEnd,    // Ruch po końcu gry
+        ScoreMismatch    // Ruchy poprawne, ale wynik inny niż deklarowany
+    };
+
+    Verdict verdict = Valid;
+    std::int32_t move = -1;  // Numer pierwszego złego ruchu (-1, gdy ruchy są poprawne)
+    std::int32_t score = 0;  // Wynik z odtworzenia (do pierwszej rozbieżności)
+};
+
+// Sprawdzanie zgłoszonych wyników: każda gra jest odtwarzana od ziarna na HeadlessGame
+// (te same zasady i losowania co Board, bez SFML i animacji). Legalność ruchu sprawdza
+// canMoveTo, nowe kulki pochodzą z tego samego generatora, a wynik liczą te same reguły
+// co removeLinesAndUpdateScore. Gra jest odrzucana przy pierwszej rozbieżności.
+// Wątki biorą gry paczkami; każdy ma jedną planszę na cały przebieg, więc ruch nie alokuje.
+// Plansze weryfikatora nie mają obserwatorów, a linie sprawdzane są tylko przez zmienione pola.
+// Dolną granicę kosztu ruchu wyznacza generator: dokładanie kulek tasuje całą listę pustych pól
+// (jak Board - inaczej wyniki by się rozeszły), czyli kilkadziesiąt losowań mt19937 na ruch.
+class GameVerifier
+{
+public:
+    GameVerifier(int width = 10, int height = 10, const GameRules& rules = GameRules());
+
+    // results[i] dla gry i; threads = 0: tyle, ile rdzeni. Zwraca liczbę sprawdzonych ruchów.
+    long verify(const GameBatch& batch, std::vector<Verification>& results, int threads = 0) const;
+    // Jedna gra na podanej planszy (game musi mieć rozmiar i zasady weryfikatora)
+    Verification verifyGame(const GameBatch& batch, size_t index, HeadlessGame& game) const;
+
+    // Plik tekstowy, gra na linię: <ziarno> <wynik> <x1> <y1> <x2> <y2> ... ('#' to komentarz)
+    static bool loadBatch(const std::string& path, GameBatch& batch);
+    // Kod wyjścia: 0, gdy wszystkie gry są poprawne, 2, gdy któraś została odrzucona, 1 przy błędzie pliku
+    static int run(const std::string& path, int threads);
+
+private:
+    int width;
+    int height;
+    GameRules rules;
+};
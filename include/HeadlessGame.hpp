@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "BoardKernels.hpp"
+#include "BoardState.hpp"
+#include "BoardObserver.hpp"
+#include "Snapshot.hpp"
+
+// Uśpiona gra: cały stan HeadlessGame między turami w 56 bajtach (plansza do 101 pól).
+// Generator zapisany jest jako ziarno odcinka i liczba pobrań - budzenie przewija najwyżej
+// CountingRng::SegmentDraws wartości, więc kosztuje tyle samo w 10. i w 10000. turze.
+struct CompactGame
+{
+    static const int MaxCells = 101;
+
+    std::uint8_t cells[38];  // 3 bity na pole, wiersz po wierszu
+    std::uint8_t next;       // Dwie następne kulki, po 3 bity
+    std::uint8_t flags;      // Bit 0: koniec gry, bity 1-2: ballsToAdd (0-3), bity 3-7: combo - 1 (combo 1-32)
+    std::int32_t score;
+    std::uint32_t turn;
+    std::uint32_t seed;      // CountingRng::segmentSeed
+    std::uint32_t draws;
+};
+static_assert(sizeof(CompactGame) == 56, "CompactGame musi mieć 56 bajtów");
+
+// Zasady gry do strojenia; domyślne są takie jak w Board
+struct GameRules
+{
+    float fillRate = 0.30f; // Część pól z kulkami na starcie
+    int spawnCount = 2;     // Kulki dokładane po ruchu bez linii
+    int colors = 6;         // 1-6
+    int lineLength = 3;     // Najkrótsza usuwana linia
+    int pointsPerBall = 10;
+    int lengthBonus = 30;   // Za każdą kulkę ponad lineLength - 1; premia liczona dwa razy, jak w Board
+
+    // Przy domyślnych zasadach to samo co BoardState::pointsForClear
+    int pointsForClear(int removed, int combo) const;
+};
+
+// Gra bez grafiki i bez animacji - do symulacji.
+// Zasady i kolejność losowań są takie same jak w Board,
+// ale linie znikają od razu, a cała tura rozstrzyga się w playMove().
+// Nie jest bezpieczna dla wielu wątków nawet przy samych metodach const: canMoveTo pisze
+// do wspólnego bufora osiągalności - każdy wątek potrzebuje własnej kopii gry.
+class HeadlessGame
+{
+private:
+    BoardState state;
+    // Kopia planszy dla jąder (linie, osiągalność, puste pola); bufory wyników zmieniają się też
+    // w metodach const (canMoveTo) - stąd mutable i brak bezpieczeństwa wątków dla const
+    mutable KernelBoard board;
+    CountingRng rng;
+    std::uniform_int_distribution<int> colorDist;
+    GameRules rules;
+    int ballsToAdd;
+    int turn;
+    bool gameOver;
+    std::vector<BoardObserver*> observers;
+
+    // Linie sprawdzane tylko przez pola zmienione w turze: po pierwszej turze gry plansza między
+    // turami nie ma linii, a zdjęcie kulek żadnej nie tworzy. Pierwsze sprawdzenie po reset/restore
+    // obejmuje całą planszę (startowe losowanie może zostawić linie).
+    bool linesClean;
+    int ballCount;
+    std::vector<int> markedCells; // Indeksy KernelBoard zaznaczone przez ostatnie markLines
+    std::vector<int> spawned;     // Indeksy KernelBoard kulek z ostatniego addNewBalls
+
+    void setCell(int x, int y, int value);
+    bool markLines(const int* changed, int count);
+    int clearMarked();
+    void generateBalls();
+    void generateNextBalls();
+    void addNewBalls();
+    void removeLinesAndUpdateScore();
+    void checkGameOver();
+    BallColor getRandomColor();
+
+public:
+    HeadlessGame(int w, int h, unsigned int seed);
+
+    void reset();
+    void reset(unsigned int seed);
+
+    // Usypianie i budzenie (np. bezczynne sesje serwera). hibernate zwraca false,
+    // gdy stan się nie mieści (plansza większa niż CompactGame::MaxCells, combo ponad 32,
+    // inna liczba następnych kulek niż 2) - sesja zostaje wtedy obudzona.
+    bool hibernate(CompactGame& compact) const;
+    bool restore(const CompactGame& compact);
+
+    // Wykonuje ruch razem z usuwaniem linii i dokładaniem kulek.
+    // Zwraca false dla nielegalnego ruchu (stan się nie zmienia).
+    bool playMove(const Move& move);
+    bool canMoveTo(const Move& move) const;
+
+    // Zasady dla następnych gier - wywołać przed reset(). Mniej kolorów - małe warianty dla solvera.
+    void setRules(const GameRules& newRules);
+    const GameRules& getRules() const { return rules; }
+
+    void addObserver(BoardObserver* observer);
+    void removeObserver(BoardObserver* observer);
+
+    const BoardState& getState() const { return state; }
+    int getScore() const { return state.score; }
+    int getTurn() const { return turn; }
+    bool isGameOver() const { return gameOver; }
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BoardObserver.hpp"
+
+// Statystyki per pole z wielu gier: zajętość, trafienia nowych kulek, udział w liniach
+// (osobno dla każdego kierunku) i pola z kulkami, które zakończyły grę.
+// Każdy wątek ma własny HeatmapCollector na 32-bitowych licznikach (dodawanie SIMD),
+// przelewanych co jakiś czas do 64-bitowych sum; na końcu kolektory łączy merge().
+class HeatmapCollector : public BoardObserver
+{
+public:
+    enum Stat
+    {
+        Occupancy,  // Zajęte pole na początku tury
+        Spawn,      // Pole, na które trafiła nowa kulka
+        LineH,      // Udział w linii: →
+        LineV,      // ↓
+        LineDiag,   // ↘
+        LineAnti,   // ↙
+        GameOver,   // Ostatnio dołożona kulka przed końcem gry
+        StatCount
+    };
+
+    HeatmapCollector(int w, int h);
+
+    void onMove(const BoardState& before, const Move& move) override;
+    void onBallsAdded(const BoardState& after, const std::vector<std::pair<int, int>>& positions) override;
+    void onLinesFound(const BoardState& before) override;
+    void onGameOver(const BoardState& final) override;
+
+    // Dodaje sumy innego kolektora (po zakończeniu jego wątku)
+    void merge(HeatmapCollector& other);
+    // Przelewa liczniki 32-bitowe do sum - wołane samo, gdy mogłyby się przepełnić
+    void flush();
+
+    std::uint64_t value(Stat stat, int x, int y) const { return totals[stat][y * width + x]; }
+    std::uint64_t getTurns() const { return turns; }
+    std::uint64_t getGames() const { return games; }
+
+    // CSV: wiersz na pole, kolumny z licznikami i częstościami na turę / grę
+    bool writeCSV(const std::string& path);
+    // Mapa cieplna jednej statystyki (PPM, pole = cellPixels x cellPixels)
+    bool writePPM(const std::string& path, Stat stat, int cellPixels = 32);
+    // CSV i PPM dla wszystkich statystyk: <prefix>.csv, <prefix>_<nazwa>.ppm
+    bool writeAll(const std::string& prefix);
+
+    static const char* statName(Stat stat);
+
+private:
+    int width;
+    int height;
+    std::array<std::vector<std::uint32_t>, StatCount> counters;
+    std::array<std::vector<std::uint64_t>, StatCount> totals;
+    std::uint32_t pendingTurns; // Tury od ostatniego flush - limit przepełnienia liczników
+    std::uint64_t turns;
+    std::uint64_t games;
+    std::vector<int> lastSpawn; // Pola z ostatniego dokładania kulek
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "BoardState.hpp"
+#include "NeuralEvaluator.hpp"
+
+// Podpowiedzi ruchów liczone w tle, gdy gracz się zastanawia.
+// Analiza startuje po ustabilizowaniu planszy i jest przerywana przy każdej zmianie stanu.
+class HintEngine
+{
+private:
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+
+    // Zlecone zadanie (chronione przez mutex)
+    BoardState pendingState;
+    unsigned long pendingVersion;
+    bool hasPendingJob;
+    bool stopRequested;
+
+    // Wersja planszy, dla której liczymy - zmiana przerywa bieżącą analizę
+    std::atomic<unsigned long> activeVersion;
+
+    // Najlepszy dotąd znaleziony ruch (chroniony przez mutex)
+    std::optional<Move> bestMove;
+    unsigned long bestVersion;
+    int bestDepth;
+
+    // Opcjonalna sieć policy/value - bez wag zostaje heurystyka
+    NeuralEvaluator network;
+
+    void workerLoop();
+    void search(const BoardState& state, unsigned long version);
+    void publish(const Move& move, unsigned long version, int depth);
+    bool isCancelled(unsigned long version) const;
+
+    int evaluateMove(const BoardState& state, const Move& move) const;
+    int evaluateFollowUp(const BoardState& state, const Move& move, unsigned long version) const;
+    void applyNetwork(const BoardState& state, const std::vector<Move>& moves,
+                      std::vector<std::pair<int, size_t>>& ranked, unsigned long version) const;
+
+public:
+    HintEngine();
+    ~HintEngine();
+
+    HintEngine(const HintEngine&) = delete;
+    HintEngine& operator=(const HintEngine&) = delete;
+
+    // Wywołać przed pierwszym analyze()
+    bool loadNetwork(const std::string& path);
+    bool hasNetwork() const { return network.isLoaded(); }
+
+    void analyze(const BoardState& state, unsigned long version);
+    void cancel();
+
+    // Tylko krótka blokada - zwraca ruch, jeśli dotyczy podanej wersji planszy
+    std::optional<Move> getHint(unsigned long version);
+    int getDepth(unsigned long version);
+};
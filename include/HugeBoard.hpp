@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "BoardState.hpp"
+
+// Plansza do wariantów wytrzymałościowych (1000x1000 i więcej).
+// Pola trzymane są w kawałkach 32x32 tworzonych dopiero przy pierwszej kulce
+// i zwalnianych, gdy ostatnia zniknie; każdy kawałek zna liczbę swoich kulek.
+// Zasady są te same co w Board, ale sprawdzane lokalnie: linie tylko przez
+// zmienione pola, dostępność ruchów z podsumowań kawałków.
+class HugeBoard
+{
+public:
+    static constexpr int ChunkBits = 5;
+    static constexpr int ChunkSize = 1 << ChunkBits;
+
+    struct Chunk
+    {
+        std::array<std::uint8_t, ChunkSize * ChunkSize> cells{}; // 0 = puste, 1-6 = kolor
+        int balls = 0;
+        std::array<int, 7> colorBalls{}; // Kulki każdego koloru (indeks jak w cells, 0 nieużywane) - do widoku z daleka
+    };
+
+private:
+    int width;
+    int height;
+    int chunksX;
+    int chunksY;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    long long ballCount;
+
+    std::mt19937 rng;
+    std::uniform_int_distribution<int> colorDist;
+    std::vector<BallColor> nextBalls;
+    int score;
+    bool gameOver;
+
+    // BFS z oznaczaniem odwiedzonych numerem przebiegu - bez czyszczenia tablicy
+    std::vector<std::uint32_t> visitStamp;
+    std::uint32_t currentStamp;
+    std::vector<int> queue;
+    std::vector<int> backQueue;
+
+    int runLength(int x, int y, int dx, int dy) const;
+    int clearLinesThrough(const std::vector<std::pair<int, int>>& cells);
+    bool randomEmptyCell(int& x, int& y);
+    void generateNextBalls();
+    std::vector<std::pair<int, int>> addNewBalls();
+
+public:
+    HugeBoard(int w, int h, unsigned int seed);
+
+    void reset(float fillRate = 0.3f);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getChunksX() const { return chunksX; }
+    int getChunksY() const { return chunksY; }
+    // nullptr dla kawałka bez kulek
+    const Chunk* chunkAt(int cx, int cy) const { return chunks[cy * chunksX + cx].get(); }
+    int chunkCapacity(int cx, int cy) const; // Pola kawałka (przycięte na prawym i dolnym brzegu)
+
+    bool isValidPosition(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+    int at(int x, int y) const;
+    void set(int x, int y, int value);
+    bool isEmpty(int x, int y) const { return isValidPosition(x, y) && at(x, y) == 0; }
+
+    bool canMoveTo(int fromX, int fromY, int toX, int toY);
+    // Ruch z usuwaniem linii i dokładaniem kulek jak w Board::moveBall
+    bool moveBall(int fromX, int fromY, int toX, int toY);
+    bool hasAvailableMoves() const;
+
+    long long getBallCount() const { return ballCount; }
+    long long getEmptyCount() const { return static_cast<long long>(width) * height - ballCount; }
+    size_t allocatedChunks() const;
+    const std::vector<BallColor>& getNextBalls() const { return nextBalls; }
+    int getScore() const { return score; }
+    bool isGameOver() const { return gameOver; }
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "HugeBoard.hpp"
+
+// Kamera nad HugeBoard: przesuwanie, zoom i rysowanie tylko widocznych kawałków.
+// Koszt klatki zależy od liczby widocznych kulek, a nie od rozmiaru planszy; gdy pole ma mniej niż
+// 2 piksele, kawałek to jeden prostokąt w średnim kolorze (z liczników kolorów kawałka).
+class HugeBoardView
+{
+private:
+    HugeBoard& board;
+    sf::FloatRect viewport;   // Obszar okna zajmowany przez planszę
+    sf::Vector2f center;      // Środek kamery w polach planszy
+    float cellPixels;         // Zoom: piksele na pole
+    int selectedX, selectedY;
+    std::vector<sf::Vertex> vertices;
+    size_t lastVisibleChunks;
+
+    void appendQuad(float x0, float y0, float x1, float y1, sf::Color color);
+    sf::Vector2f toBoard(sf::Vector2f pixel) const;
+
+public:
+    HugeBoardView(HugeBoard& b, sf::FloatRect area);
+
+    void pan(float dx, float dy);              // W pikselach ekranu
+    void zoom(float factor, sf::Vector2f pixel); // Punkt pod kursorem zostaje na miejscu
+    void handleClick(sf::Vector2f pixel);
+    void draw(sf::RenderTarget& window);
+
+    size_t getLastVisibleChunks() const { return lastVisibleChunks; }
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+// Pomiar opóźnienia od kliknięcia do klatki, która je pokazuje (input-to-photon,
+// bez opóźnienia samego monitora). SFML nie podaje czasu zdarzenia, więc pomiar
+// zaczyna się w chwili odebrania zdarzenia z kolejki okna.
+// Etapy: received() -> handled() (handleMouseClick, w tym moveBall) -> presented() (po display()).
+class InputLatency
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void received();
+    // moved: kliknięcie przesunęło kulkę (zmieniło stan planszy)
+    void handled(bool moved);
+    // Klatka pokazana - kończy wszystkie obsłużone, a jeszcze niepokazane pomiary
+    void presented();
+    void clear();
+
+    size_t samples() const { return handleMs.size(); }
+    // Percentyl (0-100) czasu do pokazania klatki; movedOnly - tylko kliknięcia z ruchem
+    double presentedPercentile(double p, bool movedOnly = false) const;
+    void report(std::ostream& out) const;
+
+private:
+    Clock::time_point receivedAt;
+    bool receiving = false;
+    std::vector<Clock::time_point> waiting; // Obsłużone, czekają na klatkę
+    std::vector<bool> waitingMoved;
+
+    std::vector<float> handleMs;
+    std::vector<float> presentMs;
+    std::vector<float> movedPresentMs;
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <SFML/Window.hpp>
+
+// Jedno zdarzenie wejścia z nagrania: numer klatki, w której przyszło, i dane zdarzenia
+struct InputEvent
+{
+    unsigned long frame = 0;
+    char type = 'c'; // 'c' - klik lewym (a, b = x, y), 'm' - ruch myszy (x, y), 'k' - klawisz (a = kod)
+    int a = 0;
+    int b = 0;
+};
+
+// Nagrywanie i odtwarzanie wejścia gry. Nagranie to plik tekstowy: "seed <ziarno>",
+// potem jedno zdarzenie na linię: "<klatka> <typ> <a> <b>".
+// Odtwarzanie karmi zdarzeniami Game bez okna (rysowanie do tekstury) i mierzy
+// opóźnienie kliknięć - regresje responsywności da się sprawdzać automatycznie.
+class InputReplay
+{
+public:
+    static std::optional<InputEvent> fromEvent(const sf::Event& event, unsigned long frame);
+    static std::optional<sf::Event> toEvent(const InputEvent& event);
+    static void write(std::ostream& out, const InputEvent& event);
+    static bool load(const std::string& path, unsigned int& seed, std::vector<InputEvent>& events);
+
+    // source: plik nagrany przez --record albo "synthetic" (bot klika ruchy, moves ruchów).
+    // Zwraca 1, gdy p99 opóźnienia do klatki przekracza budgetMs (0 = bez limitu).
+    static int run(const std::string& source, int moves, double budgetMs);
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// Bieżąca gra w postaci, którą Board zapisuje wprost do zmapowanego pliku - bez osobnego przebiegu serializacji.
+// Pola: 0 = puste, 1-6 = kolor; bit LineMarked oznacza kulkę czekającą na usunięcie (animacja linii).
+struct LiveGameRecord
+{
+    static const int MaxCells = 256;
+    static const int MaxNext = 8;
+    static const std::uint8_t LineMarked = 0x80;
+
+    // Nagłówek slotu: numer zapisu i suma kontrolna reszty (razem z numerem) - zapisywane na końcu
+    std::uint64_t sequence;
+    std::uint64_t checksum;
+
+    std::int32_t width;
+    std::int32_t height;
+    std::int32_t score;
+    std::int32_t combo;
+    std::int32_t turn;
+    std::int32_t ballsToAdd;
+    std::int32_t selectedX; // -1 = brak zaznaczenia
+    std::int32_t selectedY;
+    std::int32_t puzzleMovesLeft;
+    std::int32_t puzzleGoal;
+    std::int32_t puzzleLines;
+    std::uint8_t gameOver;
+    std::uint8_t lineAnimation; // Linie oznaczone, animacja w toku
+    std::uint8_t puzzleMode;
+    std::uint8_t nextCount;
+    std::uint8_t next[MaxNext];
+    std::uint32_t seed;         // Ziarno gry - do zapisu wyniku w bazie
+    std::uint32_t rngSegmentSeed; // Generator: CountingRng::resume(rngSegmentSeed, rngDraws)
+    std::uint64_t rngDraws;
+
+    std::uint8_t cells[MaxCells];
+};
+
+static_assert(std::is_trivially_copyable<LiveGameRecord>::value, "LiveGameRecord musi dać się kopiować bajtami");
+static_assert(sizeof(LiveGameRecord) % sizeof(std::uint64_t) == 0, "Suma kontrolna liczona słowami 64-bitowymi");
+
+// Mały plik z bieżącą grą, zmapowany na stałe i aktualizowany w miejscu przy każdej mutacji planszy.
+// Dwa sloty: zapis idzie zawsze do starszego, a numer i suma kontrolna trafiają do niego na końcu,
+// więc przerwany zapis psuje tylko ten slot - przy starcie wygrywa nowszy slot z poprawną sumą.
+// Po awarii programu zmiany są w pamięci podręcznej jądra; na dysk (na wypadek utraty zasilania)
+// spycha je wątek w tle po każdej zakończonej turze - bez fsync na ścieżce klatki.
+// Starszy slot jest nadpisywany dopiero, gdy nowszy jest już na dysku: inaczej msync (albo jądro)
+// mogłoby zapisać nadpisywany slot w połowie, zanim trafi tam nowszy, i na dysku nie byłoby żadnego
+// poprawnego. Gdy wątek w tle jeszcze nie zdążył, beginWrite sam synchronizuje nowszy slot.
+// Plik: "KLV1", wersja, rozmiar slotu, potem dwa sloty LiveGameRecord.
+class LiveGameFile
+{
+public:
+    LiveGameFile();
+    ~LiveGameFile();
+
+    LiveGameFile(const LiveGameFile&) = delete;
+    LiveGameFile& operator=(const LiveGameFile&) = delete;
+
+    // Otwiera albo tworzy plik; nieznany format jest zastępowany pustym
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return mapped != nullptr; }
+
+    // Najnowszy poprawny zapis; nullptr, gdy nie ma żadnego
+    const LiveGameRecord* latest() const;
+
+    // Slot do wypełnienia (starszy z dwóch); zapis kończy commit()
+    LiveGameRecord& beginWrite();
+    void commit();
+    // Zapis na dysk w tle - nie blokuje
+    void requestSync();
+
+private:
+    void* mapped;
+    size_t mappedBytes;
+    LiveGameRecord* slots;
+    LiveGameRecord* writing;
+    std::uint64_t lastSequence;
+    int newestSlot; // -1 = oba sloty puste
+    std::uint64_t syncedSequence; // Najnowszy zapis na pewno na dysku (pod syncMutex)
+    std::uint64_t syncTarget;     // Zapis, który obejmie następny msync w tle (pod syncMutex)
+
+    std::thread syncer;
+    std::mutex syncMutex;
+    std::condition_variable syncWake;
+    bool syncPending;
+    bool stopping;
+
+    static std::uint64_t checksumOf(const LiveGameRecord& record);
+    bool isValid(const LiveGameRecord& record) const;
+    void syncLoop();
+};
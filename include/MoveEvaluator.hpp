@@ -0,0 +1,98 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "BoardState.hpp"
+
+// Ruch z oceną; pola jako indeksy y * width + x
+struct ScoredMove
+{
+    int score;
+    std::uint16_t from;
+    std::uint16_t to;
+};
+
+// Statyczna ocena wszystkich legalnych ruchów w jednym przebiegu - dla szybkiego bota i rolloutów.
+// Plansza dzielona jest na okna linii: odcinki lineLength pól w czterech kierunkach findAllLines.
+// Dla każdego okna pamiętamy kolor i liczbę kulek; okno z jednym kolorem ma potencjał zależny
+// od liczby kulek, a ocena ruchu to zmiana sumy potencjałów okien przy polu startowym i docelowym.
+// Zyski pól docelowych (dla każdego koloru) i straty pól startowych liczone są raz na planszę,
+// więc ocena ruchu to dwa odczyty z tablic (plus poprawka, gdy oba pola leżą w jednym oknie).
+// Linia (pełne okno) ma potencjał większy niż suma wszystkich pozostałych okien pola,
+// więc ruch układający linię zawsze wygrywa, a dłuższa linia (więcej pełnych okien) wygrywa z krótszą.
+// Ruchy wylicza jedno etykietowanie obszarów pustych pól, bez canMoveTo dla każdej pary.
+class MoveEvaluator
+{
+public:
+    MoveEvaluator(int width, int height, int lineLength = 3);
+
+    // Wszystkie legalne ruchy z oceną, w kolejności pól (bufor używany ponownie)
+    const std::vector<ScoredMove>& evaluate(const BoardState& state);
+    // Wszystkie legalne ruchy od najlepszego
+    const std::vector<ScoredMove>& rank(const BoardState& state);
+    // Najlepszy ruch (remisy losowo), z prawdopodobieństwem epsilon losowy. Nie ocenia każdej pary:
+    // dla każdej kulki tylko pola blisko niej i najlepsze pole obszaru. {-1, -1, -1, -1}, gdy nie ma ruchu.
+    Move choose(const BoardState& state, std::mt19937& rng, float epsilon = 0.0f);
+
+    Move toMove(const ScoredMove& move) const;
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getLineLength() const { return lineLength; }
+
+private:
+    static const int MaxValue = 7; // 0 = puste, 1-6 = kolory
+
+    int lineLength;
+    int nearSpan;  // Bok kwadratu pól, które mogą dzielić okno z polem w środku
+    int nearSlots;
+    int width;
+    int height;
+    int cells;
+
+    // Tablice zależne tylko od rozmiaru planszy
+    std::vector<int> potentialOf; // Potencjał okna z k kulkami jednego koloru
+    int windows;
+    std::vector<std::uint16_t> windowCells; // Pola okna w: windowCells[w * lineLength..(w + 1) * lineLength)
+    std::vector<std::uint32_t> cellWindowStart; // Okna zawierające pole i: cellWindows[start[i]..start[i+1])
+    std::vector<std::uint16_t> cellWindows;
+    // Okna wspólne dla pola i pola odległego o (dx, dy), |dx|, |dy| < lineLength; -1 = brak
+    std::vector<int> sharedWindows; // [(pole * nearSlots + slotOf(dx, dy)) * (lineLength - 1) + i]
+    std::vector<std::array<int, 3>> nearOffsets; // dx, dy, slot - pola w jednej linii bliżej niż lineLength
+    std::vector<int> cellX;
+    std::vector<int> cellY;
+
+    // Stan bieżącej planszy
+    std::vector<int> windowColor; // 0 = puste okno, -1 = różne kolory
+    std::vector<int> windowBalls;
+    std::vector<int> windowBonus; // Potencjał okna czystego po dołożeniu kulki jego koloru
+    std::vector<unsigned> cellBits;
+    std::vector<int> potential;   // Potencjał okna
+    std::vector<int> gain;        // [pole * MaxValue + kolor]: zmiana po postawieniu kulki na pustym polu
+    std::vector<int> loss;        // [pole]: zmiana po zabraniu kulki
+    std::vector<int> labels;
+    std::vector<int> stack;
+    std::vector<std::uint32_t> regionStart; // Pola obszaru r: regionCells[regionStart[r]..regionStart[r+1])
+    std::vector<std::uint16_t> regionCells;
+    // Dwa najlepsze zyski pól obszaru dla koloru i liczba pól z każdym z nich
+    struct RegionBest
+    {
+        int top;
+        int topCount;
+        int second;
+        int secondCount;
+    };
+    std::vector<RegionBest> regionBest; // [obszar * MaxValue + kolor]
+    std::vector<ScoredMove> moves;
+    std::vector<ScoredMove> sorted; // Bufor sortowania w rank()
+
+    int slotOf(int dx, int dy) const { return (dy + lineLength - 1) * nearSpan + dx + lineLength - 1; }
+    int addedPotential(int window, int color) const;
+    int removedPotential(const BoardState& state, int window, int cell) const;
+    void prepare(const BoardState& state);
+    int reachableRegions(int cell, int* regions) const;
+    int sharedCorrection(const BoardState& state, int from, int slot) const;
+    // visit(from, to, ocena) dla każdego legalnego ruchu; zawsze w tej samej kolejności
+    template <typename Visit>
+    void forEachMove(const BoardState& state, Visit&& visit) const;
+};
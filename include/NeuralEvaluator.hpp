@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BoardState.hpp"
+
+// Nagłówek pliku z wagami sieci (little-endian).
+// Po nagłówku kolejne tensory, każdy wyrównany do 32 bajtów:
+//   dla każdej warstwy conv 3x3 (cin = inputPlanes dla pierwszej, potem channels):
+//     fp32: float w[9*cin][channels], float b[channels]
+//     int8: float scale[channels], int8 w[9*cin][channels], float b[channels]
+//   wiersz wag k = (ky*3 + kx)*cin + c, czyli sąsiad (kx, ky) i kanał wejścia c
+//   głowa polityki (conv 1x1):  float w[2][channels], float b[2]
+//   głowa wartości (avg pool):  float w[channels], float b[1]
+struct NetworkHeader
+{
+    char magic[4];          // "KNN1"
+    std::uint32_t version;  // 1
+    std::uint32_t inputPlanes;
+    std::uint32_t channels;
+    std::uint32_t convLayers;
+    std::uint32_t weightType; // 0 = fp32, 1 = int8
+};
+
+// Wynik sieci dla jednej pozycji
+struct Evaluation
+{
+    std::vector<float> fromLogits; // width*height - którą kulkę ruszyć
+    std::vector<float> toLogits;   // width*height - dokąd ją przesunąć
+    float value;                   // -1..1 - ocena pozycji
+};
+
+// Mała sieć konwolucyjna policy/value liczona na CPU.
+// Wagi są mapowane z pliku (mmap) i czytane bez kopiowania.
+class NeuralEvaluator
+{
+public:
+    // Płaszczyzny wejścia: 6 kolorów, puste pole, 6 kolorów z nextBalls
+    static const int kInputPlanes = 13;
+
+private:
+    struct ConvLayer
+    {
+        int inChannels;
+        int outChannels;
+        const float* weights;
+        const std::int8_t* weightsInt8;
+        const float* scales;
+        const float* bias;
+    };
+
+    void* mapping;
+    std::size_t mappingSize;
+    bool quantized;
+    int channels;
+    std::vector<ConvLayer> layers;
+    const float* policyWeights;
+    const float* policyBias;
+    const float* valueWeights;
+    const float* valueBias;
+
+    void unload();
+    void encode(const BoardState& state, float* planes) const;
+    void convolve(const ConvLayer& layer, int width, int height, int batch,
+                  const std::vector<float>& input, std::vector<float>& output) const;
+
+public:
+    NeuralEvaluator();
+    ~NeuralEvaluator();
+
+    NeuralEvaluator(const NeuralEvaluator&) = delete;
+    NeuralEvaluator& operator=(const NeuralEvaluator&) = delete;
+
+    bool load(const std::string& path);
+    bool isLoaded() const { return mapping != nullptr; }
+
+    // Wszystkie pozycje muszą mieć ten sam rozmiar planszy
+    void evaluateBatch(const std::vector<BoardState>& states, std::vector<Evaluation>& results) const;
+    Evaluation evaluate(const BoardState& state) const;
+
+    static float scoreMove(const Evaluation& eval, const Move& move, int width);
+    static const char* kernelName();
+};
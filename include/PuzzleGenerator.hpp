@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "BoardState.hpp"
+
+// Zagadka: usuń goalLines linii w dokładnie `moves` ruchach (bez dokładania kulek)
+struct Puzzle
+{
+    BoardState board;
+    int moves = 0;
+    int goalLines = 0;
+    std::vector<Move> solution;
+};
+
+// Wynik pełnego przeszukania wszystkich sekwencji ruchów
+struct PuzzleAnalysis
+{
+    int bestShorter = 0;   // Najwięcej linii możliwych w moves-1 ruchach
+    int solutions = 0;     // Ile różnych zbiorów ruchów daje co najmniej goalLines (liczone do 2)
+    std::vector<Move> solution;
+};
+
+// Generuje zagadki z jednoznacznym rozwiązaniem: konstrukcja wstecz od gotowych linii,
+// potem pełne przeszukanie legalnych ruchów sprawdza, że rozwiązanie jest jedyne.
+class PuzzleGenerator
+{
+public:
+    static int linesAfterMove(BoardState& state, const Move& move);
+    static int bestLines(const BoardState& state, int moves);
+    static PuzzleAnalysis analyze(const BoardState& state, int moves, int goalLines);
+
+    static bool generate(std::mt19937& rng, int width, int height, int moves, Puzzle& puzzle);
+    static int run(const std::string& path, int count, int threads, int moves);
+};
+
+// Plik z zagadkami: "KPZ1", potem rekordy
+//   uint8 width, uint8 height, uint8 moves, uint8 goalLines,
+//   width*height bajtów planszy, moves * 4 bajty rozwiązania
+class PuzzleBank
+{
+public:
+    static bool append(const std::string& path, const std::vector<Puzzle>& puzzles);
+    static std::vector<Puzzle> load(const std::string& path);
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Wynik jednej gry - rekord o stałej szerokości, zapisywany do pliku 1:1 (little-endian)
+struct ResultRecord
+{
+    std::int32_t score = 0;
+    std::uint32_t turns = 0;
+    std::uint32_t seed = 0;
+    std::uint16_t variant = 0;   // Wariant zasad (0 = gra w oknie, 10x10)
+    std::uint16_t reserved = 0;
+    std::int64_t timestamp = 0;  // Sekundy od epoki
+    std::uint32_t reserved2 = 0;
+    std::uint32_t checksum = 0;  // FNV-1a z pierwszych 28 bajtów - wykrywa urwany zapis
+};
+static_assert(sizeof(ResultRecord) == 32, "ResultRecord musi mieć 32 bajty");
+
+// Lokalna baza wyników: plik tylko do dopisywania ("KRS1", wersja, rozmiar rekordu, rekordy).
+// Przy otwarciu plik jest mapowany do pamięci, uszkodzony koniec (np. po awarii) obcinany,
+// a indeksy budowane w pamięci. append() nie blokuje: rekordy zapisuje wątek w tle,
+// wszystkie oczekujące naraz jednym write() + fdatasync (group commit).
+// Zapytania (top-k, percentyl, po ziarnie) działają na indeksach - mikrosekundy.
+// Wszystkie metody są bezpieczne dla wielu wątków.
+class ResultsStore
+{
+public:
+    ResultsStore();
+    ~ResultsStore();
+
+    ResultsStore(const ResultsStore&) = delete;
+    ResultsStore& operator=(const ResultsStore&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen();
+
+    // Dopisuje rekord (uzupełnia checksum i ewentualnie timestamp); od razu widoczny w zapytaniach
+    void append(ResultRecord record);
+    // Czeka, aż wszystko dopisane do tej pory jest trwale w pliku (albo zapis ostatecznie się nie udał)
+    void flush();
+
+    size_t size();
+    // Najlepsze k wyników wariantu, od najwyższego
+    std::vector<ResultRecord> topK(std::uint16_t variant, size_t k);
+    // Wynik na danym percentylu (0-100) wariantu; 0, gdy brak gier
+    std::int32_t percentile(std::uint16_t variant, double p);
+    std::int32_t best(std::uint16_t variant);
+    std::vector<ResultRecord> bySeed(std::uint32_t seed);
+
+    static std::uint32_t checksumOf(const ResultRecord& record);
+
+private:
+    // Indeks wyników jednego wariantu: posortowany początek + nieposortowany ogon,
+    // scalany przy pierwszym zapytaniu po dopisaniu
+    struct ScoreIndex
+    {
+        std::vector<std::pair<std::int32_t, std::uint32_t>> entries; // (wynik, wiersz)
+        size_t sorted = 0;
+        std::int32_t best = 0;
+    };
+
+    std::mutex mutex;
+    std::string path;
+    int fd;
+    const ResultRecord* mapped;  // Rekordy z pliku w chwili otwarcia
+    size_t mappedCount;
+    size_t mappedBytes;
+    std::vector<ResultRecord> appended;
+
+    std::map<std::uint16_t, ScoreIndex> scores;
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> seeds;
+
+    // Zapis w tle
+    std::thread committer;
+    std::condition_variable pendingChanged;
+    std::condition_variable committedChanged;
+    std::vector<ResultRecord> pending;
+    std::uint64_t appendedTotal;
+    std::uint64_t committedTotal; // W całości zapisane i po fdatasync
+    std::uint64_t failedTotal;    // Nie zapisane mimo ponowień - flush() na nie nie czeka
+    bool stopping;
+
+    const ResultRecord& record(std::uint32_t row) const;
+    void indexRow(std::uint32_t row);
+    static void sortIndex(ScoreIndex& index);
+    void commitLoop();
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "BoardState.hpp"
+
+// Mały wariant gry do pełnego rozwiązania (linie z 3 kulek jak w Board)
+struct SolverVariant
+{
+    int width = 3;
+    int height = 3;
+    int colors = 3;
+};
+
+// Tablica z solvera zmapowana z pliku - odczyt w O(1), bez przeszukiwania.
+// Plik: "KSV1", wersja, szerokość, wysokość, kolory, horyzont,
+// potem float[plansze * pary] wartości i uint16[plansze * pary] najlepszych ruchów.
+// Indeks planszy: suma komórek (0 = puste, kolor + 1) razy (kolory + 1)^pole,
+// pary następnych kulek: next[0] * kolory + next[1].
+class SolverTable
+{
+public:
+    SolverTable();
+    ~SolverTable();
+
+    SolverTable(const SolverTable&) = delete;
+    SolverTable& operator=(const SolverTable&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return mapped != nullptr; }
+
+    // Czy stan należy do rozwiązanego wariantu (rozmiar, liczba kolorów)
+    bool matches(const BoardState& state) const;
+    // Prawdopodobieństwo przetrwania `horizon` tur przy najlepszej grze
+    float value(const BoardState& state) const;
+    // Najlepszy ruch; {-1, -1, -1, -1}, gdy nie ma żadnego
+    Move bestMove(const BoardState& state) const;
+
+    const SolverVariant& getVariant() const { return variant; }
+    int getHorizon() const { return horizon; }
+
+private:
+    void* mapped;
+    size_t mappedBytes;
+    SolverVariant variant;
+    int horizon;
+    int pairs;
+    std::uint64_t powers[16];
+    const float* values;
+    const std::uint16_t* moves;
+
+    size_t entryOf(const BoardState& state) const;
+};
+
+// Analiza wsteczna wszystkich stanów małego wariantu: dokładne prawdopodobieństwo
+// przetrwania przy najlepszej grze, po wszystkich możliwych losowaniach kulek.
+// Kolejne tury horyzontu liczone są od końca (wartości po k turach z wartości po k-1);
+// w obrębie tury plansze idą warstwami wg liczby kulek, bo reakcja łańcuchowa zawsze
+// kończy się na mniejszej liczbie kulek. Warstwa dzielona jest między wątki.
+class RetrogradeSolver
+{
+public:
+    // Maksymalny rozmiar tablicy (plansze * pary) - ogranicza wariant
+    static const std::uint64_t MaxEntries = 1ull << 28;
+
+    static int run(const std::string& path, const SolverVariant& variant, int horizon, int threads);
+};
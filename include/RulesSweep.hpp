@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "HeadlessGame.hpp"
+
+// Opis przeglądu zasad: wartości każdego pokrętła (przegląd to ich iloczyn kartezjański)
+// i pytanie - dla której konfiguracji mediana miary (tury albo wynik) jest najbliżej celu.
+// Plik tekstowy, jedno pokrętło na linię, '#' to komentarz:
+//   fill 0.2 0.3 0.4
+//   spawn 2 3
+//   colors 5 6
+//   line 3 4 5
+//   score 10:30 20:0      (punkty za kulkę : premia za długość)
+//   target 200
+// Opcjonalnie: board <szer> <wys>, metric turns|score, precision <0-1>, maxturns <n>,
+// games <min> <max>, batch <n>, z <kwantyl>, seed <n>.
+struct SweepSpec
+{
+    std::vector<float> fillRates{0.30f};
+    std::vector<int> spawnCounts{2};
+    std::vector<int> colors{6};
+    std::vector<int> lineLengths{3};
+    std::vector<std::pair<int, int>> scorings{{10, 30}};
+
+    int width = 10;
+    int height = 10;
+    bool scoreMetric = false; // false - liczba tur do końca gry, true - wynik
+    double target = 200.0;
+    double precision = 0.05;  // Przedział mediany węższy niż precision * cel kończy konfigurację
+    int maxTurns = 2000;      // Gry dłuższe liczą się jako maxTurns (mediana i tak jest poprawna)
+    int minGames = 64;        // Przed tyloma grami konfiguracja nie odpada
+    int maxGames = 2000;
+    int batch = 16;
+    // Przedziały sprawdzamy po każdej partii, więc kwantyl jest ostrzejszy niż 1.96
+    double z = 2.576;
+    unsigned int seed = 1;
+};
+
+// Przegląd zasad z sekwencyjnym odrzucaniem: partie gier idą na wszystkie rdzenie do konfiguracji
+// z najmniejszą liczbą gier, a po każdej partii przedziały ufności mediany są porównywane.
+// Konfiguracja odpada, gdy nawet optymistycznie jest dalej od celu niż najlepsza pesymistycznie,
+// i kończy się, gdy jej przedział jest dość wąski - gry idą tylko tam, gdzie coś rozstrzygają.
+// Gra i w każdej konfiguracji ma to samo ziarno, więc porównania nie zależą od szczęścia losowań.
+class RulesSweep
+{
+public:
+    static bool loadSpec(const std::string& path, SweepSpec& spec);
+    static int run(const SweepSpec& spec, int threads);
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <random>
+#include <string>
+#include "BoardState.hpp"
+#include "HeadlessGame.hpp"
+
+struct SelfPlayConfig
+{
+    std::string outputPath;
+    int width = 10;
+    int height = 10;
+    int games = 1000;
+    int maxTurns = 1000; // Przy linii z 3 kulek dobra gra potrafi trwać bez końca
+    int threads = 0; // 0 = tyle, ile rdzeni
+    unsigned int seed = 1;
+    GameRules rules;
+    std::string solverTable; // Niepusty: ruchy z tablicy solvera (wariant musi pasować)
+    std::string heatmapPrefix; // Niepusty: zbieraj mapy cieplne i zapisz <prefix>.csv / .ppm
+    std::string resultsPath;   // Niepusty: dopisz wynik każdej gry do bazy wyników
+    unsigned short variant = 1; // Wariant w bazie wyników (0 to gra w oknie)
+};
+
+// Gry bot-kontra-plansza na wielu wątkach, zapisywane strumieniowo do pliku z danymi
+// (pusty outputPath: bez zapisu, np. tylko mapy cieplne)
+class SelfPlay
+{
+public:
+    // Szybka polityka: najlepszy ruch wg MoveEvaluator, w 10% tur losowy
+    static Move chooseMove(const BoardState& state, std::mt19937& rng);
+    static int run(const SelfPlayConfig& config);
+};
@@ -0,0 +1,133 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+#include "BoardState.hpp"
+
+// Generator liczb losowych, który liczy pobrane wartości.
+// Co SegmentDraws pobrań ziarni się od nowa liczbą z samego siebie, więc cały stan to
+// ziarno bieżącego odcinka i liczba pobrań: odtworzenie przewija najwyżej SegmentDraws wartości,
+// niezależnie od długości gry. Board i HeadlessGame używają go tak samo, więc losowania się zgadzają.
+class CountingRng
+{
+public:
+    using result_type = std::mt19937::result_type;
+    static const std::uint64_t SegmentDraws = 1024;
+
+    std::mt19937 engine;
+    std::uint64_t draws;
+    result_type segmentSeed; // engine = mt19937(segmentSeed) po draws % SegmentDraws pobraniach
+
+    explicit CountingRng(result_type seed = std::mt19937::default_seed) : engine(seed), draws(0), segmentSeed(seed) {}
+
+    // Stan po `draws` pobraniach, z ziarna odcinka, w którym wtedy był generator
+    static CountingRng resume(result_type segmentSeed, std::uint64_t draws)
+    {
+        CountingRng rng(segmentSeed);
+        rng.engine.discard(draws % SegmentDraws);
+        rng.draws = draws;
+        return rng;
+    }
+
+    result_type operator()()
+    {
+        result_type value = engine();
+        if (++draws % SegmentDraws == 0)
+            nextSegment();
+        return value;
+    }
+    static constexpr result_type min() { return std::mt19937::min(); }
+    static constexpr result_type max() { return std::mt19937::max(); }
+
+private:
+    void nextSegment()
+    {
+        segmentSeed = engine();
+        engine.seed(segmentSeed);
+    }
+};
+
+// Plansza dzielona na kawałki po 16 pól, współdzielone między kopiami.
+// Kopia kopiuje tylko wskaźniki; zapis do współdzielonego kawałka najpierw go klonuje.
+class CowGrid
+{
+public:
+    static const int ChunkCells = 16;
+    using Chunk = std::array<std::uint8_t, ChunkCells>;
+
+    int width;
+    int height;
+
+    CowGrid();
+    CowGrid(int w, int h);
+
+    int at(int x, int y) const { return (*chunks[index(x, y) / ChunkCells])[index(x, y) % ChunkCells]; }
+    void set(int x, int y, int value);
+
+    size_t chunkCount() const { return chunks.size(); }
+    const std::shared_ptr<const Chunk>& chunk(size_t i) const { return chunks[i]; }
+
+    // Nowa siatka ze stanu planszy, dzieląca z `previous` niezmienione kawałki
+    static CowGrid fromState(const BoardState& state, const CowGrid* previous);
+
+    BoardState toState() const;
+
+private:
+    std::vector<std::shared_ptr<const Chunk>> chunks;
+
+    int index(int x, int y) const { return y * width + x; }
+};
+
+// Stan Board po zakończonej turze
+struct BoardSnapshot
+{
+    CowGrid grid;
+    std::vector<BallColor> nextBalls;
+    int score = 0;
+    int combo = 1;
+    int turn = 0;
+    int ballsToAdd = 2;
+    bool gameOver = false;
+    int puzzleMovesLeft = 0;
+    int puzzleLines = 0;
+
+    // Generator: ziarno odcinka + liczba pobrań od początku gry (CountingRng::resume)
+    std::uint32_t rngSegmentSeed = 0;
+    std::uint64_t rngDraws = 0;
+
+    // Lekka kopia dla wyszukiwania (np. HintEngine) - bez obiektów SFML
+    BoardState toState() const;
+    void restoreRng(CountingRng& rng) const;
+};
+
+// Historia tur do cofania i ponawiania. Snapshoty dzielą niezmienione kawałki planszy,
+// więc tura kosztuje tyle, ile zmienionych kawałków.
+// capacity = 0: bez limitu; inaczej najstarsze tury wypadają.
+class SnapshotHistory
+{
+public:
+    explicit SnapshotHistory(size_t capacity = 0);
+
+    void clear();
+    // Zapisuje turę (plansza, następne kulki, wynik i combo ze `state`, reszta z `snapshot`).
+    // Jeśli wcześniej cofnięto ruchy, ich gałąź ponawiania przepada.
+    void capture(const BoardState& state, const CountingRng& rng, BoardSnapshot snapshot);
+
+    const BoardSnapshot* current() const;
+    const BoardSnapshot* undo();
+    const BoardSnapshot* redo();
+
+    bool canUndo() const { return cursor > 0; }
+    bool canRedo() const { return cursor + 1 < snapshots.size(); }
+    size_t size() const { return snapshots.size(); }
+    // Przybliżona pamięć: różne kawałki planszy
+    size_t memoryBytes() const;
+
+private:
+    std::deque<BoardSnapshot> snapshots;
+    size_t cursor;
+    size_t capacity;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BoardState.hpp"
+
+// Obraz RGB w pamięci: piksel to 0x00BBGGRR (bajty R, G, B, 0)
+struct Image
+{
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint32_t> pixels;
+
+    void resize(int w, int h);
+    bool writePPM(const std::string& path) const;
+    bool writePNG(const std::string& path) const;
+};
+
+// Rysuje planszę na CPU tak jak Board::draw (pola, siatka, kulki, podgląd następnych
+// kulek, wynik) - bez okna i bez GL, np. na serwerze. render() jest const i można
+// go wołać z wielu wątków naraz na jednym obiekcie.
+class SoftwareRenderer
+{
+private:
+    float scale;          // 1.0 = okno 800x600 jak w grze
+    int glyphWidth;
+    int glyphHeight;
+    // Maski pokrycia znaków (0-255) w docelowym rozmiarze, liczone raz w konstruktorze
+    std::array<std::vector<std::uint8_t>, 128> glyphs;
+
+    void buildGlyphs();
+    void fillRect(Image& image, float x0, float y0, float x1, float y1, std::uint32_t color) const;
+    void fillCircle(Image& image, float cx, float cy, float radius, std::uint32_t color) const;
+    void drawText(Image& image, float x, float y, const std::string& text, std::uint32_t color) const;
+
+public:
+    explicit SoftwareRenderer(float scale = 0.25f);
+
+    void render(const BoardState& state, Image& image, bool gameOver = false) const;
+
+    // Miniatury wszystkich (albo co `every`-tej) pozycji z pliku self-play
+    static int runThumbnails(const std::string& datasetPath, const std::string& outputDir,
+                             int threads, int every, bool ppm);
+};
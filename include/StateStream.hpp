@@ -0,0 +1,95 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BoardObserver.hpp"
+
+// Strumień zmian stanu planszy dla widzów i zdalnych rendererów.
+// Każda operacja to bajt kodu i argumenty (varinty):
+//   0x01 snapshot:   width, height, pola po 4 bity, nextBalls, wynik, combo,
+//                    wybór, game over, oznaczone pola
+//   0x10+v pole:     indeks pola, nowa wartość v (0 = puste, 1-6 = kolor) w kodzie
+//   0x03 wybór:      indeks+1 (0 = brak)
+//   0x04 oznaczenia: liczba, indeksy jako różnice
+//   0x05 wynik:      zmiana wyniku (zigzag), combo
+//   0x06 następne:   liczba, kolory
+//   0x07 game over:  0/1
+// Operacje są samoopisujące się, więc strumień można ciąć w dowolnym miejscu
+// między operacjami, a widz dołączający w trakcie gry zaczyna od snapshotu.
+
+// Lustrzana kopia planszy po stronie widza
+class MirrorBoard
+{
+public:
+    int width;
+    int height;
+    std::vector<std::uint8_t> cells;
+    std::vector<std::uint8_t> marked;
+    std::vector<BallColor> nextBalls;
+    int score;
+    int combo;
+    int selectedX;
+    int selectedY;
+    bool gameOver;
+    bool synced; // false do pierwszego snapshotu - wcześniejsze delty są pomijane
+
+    MirrorBoard();
+
+    // Stosuje pełne operacje z bufora, zwraca liczbę zużytych bajtów
+    // (niepełna operacja na końcu zostaje do następnego wywołania).
+    // Zwraca -1 dla uszkodzonego strumienia.
+    long apply(const std::uint8_t* data, size_t size);
+
+    BoardState toState() const;
+    void encodeSnapshot(std::vector<std::uint8_t>& out) const;
+};
+
+// Koduje powiadomienia Board jako strumień i rozsyła go do widzów (np. potoków).
+// Wolny widz z zaległościami ponad limit jest odłączany.
+class StateStreamWriter : public BoardObserver
+{
+private:
+    struct Sink
+    {
+        int fd;
+        std::vector<std::uint8_t> backlog;
+        size_t skip; // Początek `pending` już zawarty w snapshocie widza dołączonego w tej klatce
+    };
+
+    MirrorBoard shadow;                 // Stan po wszystkich wysłanych operacjach
+    std::vector<std::uint8_t> pending;  // Operacje od ostatniego flush()
+    std::vector<Sink> sinks;
+    size_t bytesSinceSnapshot;
+    size_t snapshotInterval;
+    size_t maxBacklog;
+    std::uint64_t bytesEncoded;
+
+    void emit(size_t start);
+    void emitSnapshot();
+    bool writeSink(Sink& sink);
+
+public:
+    StateStreamWriter(size_t snapshotEvery = 64 * 1024, size_t maxSinkBacklog = 1 << 20);
+    ~StateStreamWriter();
+
+    StateStreamWriter(const StateStreamWriter&) = delete;
+    StateStreamWriter& operator=(const StateStreamWriter&) = delete;
+
+    // Nowy widz dostaje najpierw snapshot bieżącego stanu (fd przechodzi na własność)
+    void addSink(int fd);
+    size_t sinkCount() const { return sinks.size(); }
+
+    // Wysyła zebrane operacje do wszystkich widzów - np. raz na klatkę
+    void flush();
+    // Zebrane, jeszcze niewysłane bajty (dla własnego transportu)
+    std::vector<std::uint8_t>& pendingBytes() { return pending; }
+    std::uint64_t getBytesEncoded() const { return bytesEncoded; }
+
+    void onGameOver(const BoardState& finalState) override;
+    void onCellChanged(int x, int y, int value) override;
+    void onSelectionChanged(int x, int y) override;
+    void onLinesMarked(const std::vector<std::pair<int, int>>& cells) override;
+    void onScoreChanged(int score, int combo) override;
+    void onNextBalls(const std::vector<BallColor>& balls) override;
+    void onReset(const BoardState& state) override;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+// Tekst HUD z wbudowanej czcionki (EmbeddedFont) - bez plików czcionek.
+// Dla każdego rozmiaru atlas znaków jest wypiekany przy pierwszym użyciu (jedna tekstura),
+// a napis to jedna paczka trójkątów (z obrysem: pięć kopii tej samej paczki).
+class TextRenderer
+{
+private:
+    struct Atlas
+    {
+        sf::Texture texture;
+        int glyphWidth = 0;
+        int glyphHeight = 0;
+        int advance = 0;
+        int cellWidth = 0; // Szerokość komórki w atlasie (znak + odstęp)
+    };
+
+    std::map<unsigned int, std::unique_ptr<Atlas>> atlases;
+    std::vector<sf::Vertex> vertices;
+
+    static const int FirstChar = 32;
+    static const int LastChar = 126;
+
+    Atlas& atlasFor(unsigned int size);
+    void appendText(const Atlas& atlas, const std::string& text, sf::Vector2f position, sf::Color color);
+
+public:
+    // Wymiary napisu w rozmiarze `size` (jak sf::Text::getCharacterSize)
+    sf::Vector2f measure(const std::string& text, unsigned int size);
+
+    void draw(sf::RenderTarget& window, const std::string& text, sf::Vector2f position, unsigned int size,
+              sf::Color fill, sf::Color outline = sf::Color::Transparent);
+    // Napis wyśrodkowany na `center`
+    void drawCentered(sf::RenderTarget& window, const std::string& text, sf::Vector2f center, unsigned int size,
+                      sf::Color fill, sf::Color outline = sf::Color::Transparent);
+
+    // Wypieka atlasy z góry (np. rozmiar wyniku), żeby pierwsza klatka ich nie liczyła
+    void preload(unsigned int size) { atlasFor(size); }
+    size_t atlasCount() const { return atlases.size(); }
+};
@@ -0,0 +1,200 @@
+#include "../include/AnimationTimeline.hpp"
+#include <algorithm>
+
+AnimationTimeline::AnimationTimeline(size_t capacity)
+    : maxEffects(std::min<size_t>(capacity, 0xFFFE)), travelCount(0)
+{
+    // Cała pamięć rezerwowana z góry - add() nie alokuje (poza punktami ścieżek)
+    kinds.reserve(maxEffects);
+    elapsed.reserve(maxEffects);
+    durations.reserve(maxEffects);
+    periods.reserve(maxEffects);
+    fromXs.reserve(maxEffects);
+    fromYs.reserve(maxEffects);
+    toXs.reserve(maxEffects);
+    toYs.reserve(maxEffects);
+    values.reserve(maxEffects);
+    pathStarts.reserve(maxEffects);
+    pathCounts.reserve(maxEffects);
+    slots.reserve(maxEffects);
+
+    slotIndex.assign(maxEffects, 0);
+    slotGeneration.assign(maxEffects, 0);
+    freeSlots.reserve(maxEffects);
+    for (size_t i = maxEffects; i > 0; --i)
+        freeSlots.push_back(static_cast<std::uint32_t>(i - 1));
+}
+
+AnimationTimeline::Handle AnimationTimeline::makeHandle(std::uint32_t slot, std::uint16_t generation)
+{
+    // slot + 1, żeby żaden uchwyt nie był równy InvalidHandle
+    return (static_cast<Handle>(generation) << 16) | (slot + 1);
+}
+
+int AnimationTimeline::indexOf(Handle handle) const
+{
+    if (handle == InvalidHandle)
+        return -1;
+    std::uint32_t slot = (handle & 0xFFFF) - 1;
+    if (slot >= maxEffects || slotGeneration[slot] != (handle >> 16))
+        return -1;
+    return static_cast<int>(slotIndex[slot]);
+}
+
+AnimationTimeline::Handle AnimationTimeline::add(EffectKind kind, float duration, float fromX, float fromY,
+                                                 float toX, float toY, int value, float period, float delay)
+{
+    if (freeSlots.empty())
+        return InvalidHandle;
+
+    std::uint32_t slot = freeSlots.back();
+    freeSlots.pop_back();
+    slotIndex[slot] = static_cast<std::uint32_t>(kinds.size());
+
+    kinds.push_back(kind);
+    elapsed.push_back(-delay);
+    durations.push_back(duration);
+    periods.push_back(period);
+    fromXs.push_back(fromX);
+    fromYs.push_back(fromY);
+    toXs.push_back(toX);
+    toYs.push_back(toY);
+    values.push_back(value);
+    pathStarts.push_back(0);
+    pathCounts.push_back(0);
+    slots.push_back(slot);
+    return makeHandle(slot, slotGeneration[slot]);
+}
+
+AnimationTimeline::Handle AnimationTimeline::addTravel(const std::vector<float>& points, float duration, int value)
+{
+    if (points.size() < 2)
+        return InvalidHandle;
+
+    size_t last = points.size() - 2;
+    Handle handle = add(EffectKind::Travel, duration, points[0], points[1], points[last], points[last + 1], value);
+    if (handle == InvalidHandle)
+        return handle;
+
+    size_t index = static_cast<size_t>(indexOf(handle));
+    pathStarts[index] = static_cast<std::uint32_t>(pathPoints.size());
+    pathCounts[index] = static_cast<std::uint32_t>(points.size() / 2);
+    pathPoints.insert(pathPoints.end(), points.begin(), points.end());
+    travelCount++;
+    return handle;
+}
+
+void AnimationTimeline::remove(Handle handle)
+{
+    int index = indexOf(handle);
+    if (index >= 0)
+        removeAt(static_cast<size_t>(index));
+}
+
+void AnimationTimeline::removeAt(size_t index)
+{
+    std::uint32_t slot = slots[index];
+    slotGeneration[slot]++; // Stare uchwyty przestają pasować
+    freeSlots.push_back(slot);
+
+    if (kinds[index] == EffectKind::Travel && --travelCount == 0)
+        pathPoints.clear();
+
+    // Zamiana z ostatnim - O(1), kolejność efektów nie ma znaczenia
+    size_t last = kinds.size() - 1;
+    if (index != last)
+    {
+        kinds[index] = kinds[last];
+        elapsed[index] = elapsed[last];
+        durations[index] = durations[last];
+        periods[index] = periods[last];
+        fromXs[index] = fromXs[last];
+        fromYs[index] = fromYs[last];
+        toXs[index] = toXs[last];
+        toYs[index] = toYs[last];
+        values[index] = values[last];
+        pathStarts[index] = pathStarts[last];
+        pathCounts[index] = pathCounts[last];
+        slots[index] = slots[last];
+        slotIndex[slots[index]] = static_cast<std::uint32_t>(index);
+    }
+
+    kinds.pop_back();
+    elapsed.pop_back();
+    durations.pop_back();
+    periods.pop_back();
+    fromXs.pop_back();
+    fromYs.pop_back();
+    toXs.pop_back();
+    toYs.pop_back();
+    values.pop_back();
+    pathStarts.pop_back();
+    pathCounts.pop_back();
+    slots.pop_back();
+}
+
+void AnimationTimeline::clear()
+{
+    while (!kinds.empty())
+        removeAt(kinds.size() - 1);
+}
+
+void AnimationTimeline::advance(float dt)
+{
+    // Jedna pętla po tablicy czasów - bez skoków po wskaźnikach
+    size_t count = elapsed.size();
+    for (size_t i = 0; i < count; ++i)
+        elapsed[i] += dt;
+
+    // Wygasłe usuwamy od końca, żeby zamiana z ostatnim nie pominęła żadnego efektu
+    for (size_t i = count; i > 0; --i)
+    {
+        if (durations[i - 1] > 0.0f && elapsed[i - 1] >= durations[i - 1])
+            removeAt(i - 1);
+    }
+}
+
+bool AnimationTimeline::isAlive(Handle handle) const
+{
+    return indexOf(handle) >= 0;
+}
+
+bool AnimationTimeline::isStarted(Handle handle) const
+{
+    int index = indexOf(handle);
+    return index >= 0 && elapsed[index] >= 0.0f;
+}
+
+bool AnimationTimeline::isVisible(Handle handle) const
+{
+    int index = indexOf(handle);
+    if (index < 0 || elapsed[index] < 0.0f || periods[index] <= 0.0f)
+        return true;
+    return static_cast<long>(elapsed[index] / periods[index]) % 2 == 0;
+}
+
+float AnimationTimeline::progress(size_t i) const
+{
+    if (durations[i] <= 0.0f || elapsed[i] <= 0.0f)
+        return 0.0f;
+    return std::min(1.0f, elapsed[i] / durations[i]);
+}
+
+void AnimationTimeline::position(size_t i, float& x, float& y) const
+{
+    float t = progress(i);
+    if (kinds[i] == EffectKind::Travel && pathCounts[i] > 1)
+    {
+        // Każdy odcinek łamanej zajmuje tyle samo czasu
+        float segment = t * (pathCounts[i] - 1);
+        size_t index = std::min<size_t>(static_cast<size_t>(segment), pathCounts[i] - 2);
+        float local = segment - index;
+        const float* point = &pathPoints[pathStarts[i] + index * 2];
+        x = point[0] + (point[2] - point[0]) * local;
+        y = point[1] + (point[3] - point[1]) * local;
+        return;
+    }
+
+    x = fromXs[i] + (toXs[i] - fromXs[i]) * t;
+    y = fromYs[i] + (toYs[i] - fromYs[i]) * t;
+}
@@ -1,20 +1,27 @@
 #include "../include/Board.hpp"
 #include <algorithm>
 #include <chrono>
-#include <queue>
 
 Board::Board(int w, int h) : width(w), height(h), 
-    rng(std::chrono::steady_clock::now().time_since_epoch().count()),
+    gameSeed(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count())), gameNumber(1),
+    rng(gameSeed),
     colorDist(0, 5),  // 6 kolorów: 0-5
-    selectedX(-1), selectedY(-1), hasBallSelected(false), blinkState(false),
-    lineAnimationActive(false), animationPhase(0), fastBlinkState(false),
-    score(0), comboMultiplier(1), gameOver(false), ballsToAdd(2),
-    scoreText(font), gameOverText(font), restartText(font), fontLoaded(false)
+    selectedX(-1), selectedY(-1), hasBallSelected(false),
+    lineAnimationActive(false),
+    score(0), comboMultiplier(1),
+    selectionBlink(AnimationTimeline::InvalidHandle), lineHighlight(AnimationTimeline::InvalidHandle),
+    lineBlink(AnimationTimeline::InvalidHandle), travelEffect(AnimationTimeline::InvalidHandle),
+    travelX(-1), travelY(-1), gameOver(false), ballsToAdd(2),
+    personalBest(-1), turnCount(0), stateVersion(1), hintMove{-1, -1, -1, -1}, hintVersion(0),
+    puzzleMode(false), puzzleMovesLeft(0), puzzleGoal(0), puzzleLines(0),
+    turboMode(false), reachSourceX(-1), reachSourceY(-1), reachVersion(0), hoverX(-1), hoverY(-1),
+    liveFile(nullptr)
 {
     initialize();
     initializeGraphics();
     generateBalls(); // Generuj kulki po inicjalizacji
     generateNextBalls(); // Przygotuj następne kulki
+    captureTurn();
 }
 
 Board::~Board() 
@@ -65,48 +72,41 @@ void Board::initializeGraphics()
         }
     }
 
-    // Load font
-    fontLoaded = false;
-    // Try common macOS font paths
-    if (font.openFromFile("/System/Library/Fonts/Supplemental/Arial.ttf")) {
-        fontLoaded = true;
-    } else if (font.openFromFile("/Library/Fonts/Arial.ttf")) {
-        fontLoaded = true;
-    } else if (font.openFromFile("/System/Library/Fonts/Helvetica.ttc")) {
-        fontLoaded = true;
-    }
-
-    if (fontLoaded) {
-        scoreText.setFont(font);
-        scoreText.setCharacterSize(30);
-        scoreText.setFillColor(sf::Color::White);
-        scoreText.setPosition({20.0f, 10.0f});
-        scoreText.setString("Score: 0");
+    // Napisy korzystają z wbudowanej czcionki (TextRenderer) - nic do wczytania z dysku
+}
 
-        gameOverText.setFont(font);
-        gameOverText.setCharacterSize(60);
-        gameOverText.setFillColor(sf::Color::Red);
-        gameOverText.setString("GAME OVER");
-        // Center text
-        sf::FloatRect textRect = gameOverText.getLocalBounds();
-        gameOverText.setOrigin({textRect.position.x + textRect.size.x/2.0f, textRect.position.y + textRect.size.y/2.0f});
-        gameOverText.setPosition({offsetX + (width * cellSize) / 2.0f, offsetY + (height * cellSize) / 2.0f - 40.0f});
+void Board::reset(unsigned int seed)
+{
+    rng = CountingRng(seed);
+    gameSeed = seed;
+    gameNumber++;
+    clearState();
+    generateBalls();
+    generateNextBalls();
+    history.clear();
+    captureTurn();
 
-        restartText.setFont(font);
-        restartText.setCharacterSize(24);
-        restartText.setFillColor(sf::Color::White);
-        restartText.setString("Press R to Restart");
-        sf::FloatRect restartRect = restartText.getLocalBounds();
-        restartText.setOrigin({restartRect.position.x + restartRect.size.x/2.0f, restartRect.position.y + restartRect.size.y/2.0f});
-        restartText.setPosition({offsetX + (width * cellSize) / 2.0f, offsetY + (height * cellSize) / 2.0f + 40.0f});
+    if (!observers.empty())
+    {
+        BoardState state = snapshot();
+        for (auto* observer : observers)
+            observer->onReset(state);
     }
+    saveLive();
 }
 
-void Board::reset()
+void Board::clearState()
 {
     score = 0;
+    turnCount = 0;
     gameOver = false;
     comboMultiplier = 1;
+    ballsToAdd = 2;
+    puzzleMode = false;
+    deselectBall();
+    timeline.clear();
+    lineAnimationActive = false;
+    stateVersion++;
     
     for (int i = 0; i < height; ++i)
     {
@@ -117,12 +117,15 @@ void Board::reset()
             lineMarked[i][j] = false;
         }
     }
-    
-    generateBalls();
-    generateNextBalls();
 }
 
-void Board::draw(sf::RenderWindow &window)
+void Board::reset()
+{
+    // Nowa gra zawsze ma własne ziarno (z generatora poprzedniej) - jej wynik da się sprawdzić odtworzeniem
+    reset(static_cast<unsigned int>(rng()));
+}
+
+void Board::draw(sf::RenderTarget &window)
 {
     // Rysuj pola planszy
     for (int i = 0; i < height; ++i)
@@ -147,34 +150,47 @@ void Board::draw(sf::RenderWindow &window)
 
     // Rysuj linie siatki
     drawGrid(window);
+
+    // Rysuj podpowiedź i podgląd ścieżki pod kulkami
+    drawHint(window);
+    drawPathPreview(window);
     
     // Rysuj kulki na wierzchu
     drawBalls(window);
 
-    // Rysuj latające punkty
-    drawFloatingScores(window);
+    // Rysuj efekty: zanikające kulki, kulkę w drodze i latające punkty
+    drawEffects(window);
     
     // Rysuj preview następnych kulek
     drawNextBalls(window);
 
-    if (fontLoaded) {
-        scoreText.setString("Score: " + std::to_string(score));
-        window.draw(scoreText);
+    text.draw(window, "Score: " + std::to_string(score), {20.0f, 10.0f}, 30, sf::Color::White);
+    if (personalBest >= 0)
+        text.draw(window, "Best: " + std::to_string(std::max(personalBest, score)), {650.0f, 100.0f}, 20,
+                  sf::Color(200, 200, 200));
 
-        if (gameOver) {
-            // Draw semi-transparent overlay
-            sf::RectangleShape overlay({(float)width * cellSize, (float)height * cellSize});
-            overlay.setPosition({offsetX, offsetY});
-            overlay.setFillColor(sf::Color(0, 0, 0, 150));
-            window.draw(overlay);
+    if (puzzleMode) {
+        drawPuzzleStatus(window);
+    } else if (gameOver) {
+        // Draw semi-transparent overlay
+        sf::RectangleShape overlay({(float)width * cellSize, (float)height * cellSize});
+        overlay.setPosition({offsetX, offsetY});
+        overlay.setFillColor(sf::Color(0, 0, 0, 150));
+        window.draw(overlay);
 
-            window.draw(gameOverText);
-            window.draw(restartText);
-        }
+        drawGameOverText(window, "GAME OVER", sf::Color::Red);
     }
 }
 
-void Board::drawGrid(sf::RenderWindow &window)
+void Board::drawGameOverText(sf::RenderTarget& window, const std::string& title, sf::Color color,
+                             const std::string& hint)
+{
+    sf::Vector2f center{offsetX + (width * cellSize) / 2.0f, offsetY + (height * cellSize) / 2.0f};
+    text.drawCentered(window, title, {center.x, center.y - 40.0f}, 60, color);
+    text.drawCentered(window, hint, {center.x, center.y + 40.0f}, 24, sf::Color::White);
+}
+
+void Board::drawGrid(sf::RenderTarget &window)
 {
     sf::RectangleShape line;
     line.setFillColor(sf::Color(80, 80, 80));
@@ -239,7 +255,7 @@ void Board::generateBalls()
     }
 }
 
-void Board::drawBalls(sf::RenderWindow &window)
+void Board::drawBalls(sf::RenderTarget &window)
 {
     for (int i = 0; i < height; ++i)
     {
@@ -250,27 +266,21 @@ void Board::drawBalls(sf::RenderWindow &window)
                 bool shouldDraw = true;
                 
                 // Obsługa migania wybranej kulki
-                if (hasBallSelected && selectedX == j && selectedY == i && !blinkState)
+                if (hasBallSelected && selectedX == j && selectedY == i && !timeline.isVisible(selectionBlink))
+                {
+                    shouldDraw = false;
+                }
+
+                // Kulka w drodze jest rysowana przez drawEffects
+                if (travelX == j && travelY == i && timeline.isAlive(travelEffect))
                 {
                     shouldDraw = false;
                 }
                 
-                // Obsługa animacji linii
-                if (lineAnimationActive && lineMarked[i][j])
+                // Obsługa animacji linii: podświetlenie - zawsze rysuj, potem szybkie miganie
+                if (lineAnimationActive && lineMarked[i][j] && timeline.isStarted(lineBlink))
                 {
-                    if (animationPhase == 0) // Highlight - zawsze rysuj
-                    {
-                        shouldDraw = true;
-                        // Można dodać efekt highlight (np. pulsowanie)
-                    }
-                    else if (animationPhase == 1) // Fast blink
-                    {
-                        shouldDraw = fastBlinkState;
-                    }
-                    else // Remove phase
-                    {
-                        shouldDraw = false;
-                    }
+                    shouldDraw = timeline.isVisible(lineBlink);
                 }
                 
                 if (shouldDraw)
@@ -280,9 +290,6 @@ void Board::drawBalls(sf::RenderWindow &window)
             }
         }
     }
-    
-    // Rysuj latające punkty
-    drawFloatingScores(window);
 }
 
 void Board::placeBallAt(int x, int y, BallColor color)
@@ -292,6 +299,10 @@ void Board::placeBallAt(int x, int y, BallColor color)
         sf::Vector2f position = getCellPosition(x, y);
         balls[y][x] = std::make_unique<Ball>(color, position);
         grid[y][x] = static_cast<int>(color) + 1; // 1-6 dla kolorów
+        stateVersion++;
+
+        for (auto* observer : observers)
+            observer->onCellChanged(x, y, grid[y][x]);
     }
 }
 
@@ -301,6 +312,11 @@ BallColor Board::getRandomColor()
     return static_cast<BallColor>(colorValue);
 }
 
+sf::Vector2f Board::getCellCenter(int x, int y) const
+{
+    return sf::Vector2f(offsetX + (x + 0.5f) * cellSize, offsetY + (y + 0.5f) * cellSize);
+}
+
 sf::Vector2f Board::getCellPosition(int x, int y) const
 {
     // Pozycja środka komórki
@@ -338,6 +354,7 @@ void Board::handleMouseClick(float mouseX, float mouseY)
     if (gridX == -1 || gridY == -1) // Kliknięcie poza planszą
     {
         deselectBall();
+        saveLive();
         return;
     }
     
@@ -376,6 +393,7 @@ void Board::handleMouseClick(float mouseX, float mouseY)
             selectBall(gridX, gridY);
         }
     }
+    saveLive(); // Zaznaczenie też należy do stanu wznawianej gry
 }
 
 void Board::selectBall(int x, int y)
@@ -383,8 +401,13 @@ void Board::selectBall(int x, int y)
     selectedX = x;
     selectedY = y;
     hasBallSelected = true;
-    blinkClock.restart();
-    blinkState = true;
+    // Miganie co 500 ms, do odznaczenia
+    timeline.remove(selectionBlink);
+    selectionBlink = timeline.add(EffectKind::Blink, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0.5f);
+    computeReachable(x, y);
+
+    for (auto* observer : observers)
+        observer->onSelectionChanged(x, y);
 }
 
 void Board::deselectBall()
@@ -392,78 +415,116 @@ void Board::deselectBall()
     selectedX = -1;
     selectedY = -1;
     hasBallSelected = false;
-    blinkState = false;
+    timeline.remove(selectionBlink);
+    selectionBlink = AnimationTimeline::InvalidHandle;
+
+    for (auto* observer : observers)
+        observer->onSelectionChanged(-1, -1);
 }
 
-std::vector<std::pair<int, int>> Board::findPath(int fromX, int fromY, int toX, int toY)
+void Board::computeReachable(int fromX, int fromY)
 {
-    if (!isValidPosition(fromX, fromY) || !isValidPosition(toX, toY))
-        return {};
-    
-    if (!isEmpty(toX, toY))
-        return {};
-    
-    // BFS pathfinding
-    std::vector<std::vector<bool>> visited(height, std::vector<bool>(width, false));
-    std::vector<std::vector<std::pair<int, int>>> parent(height, std::vector<std::pair<int, int>>(width, {-1, -1}));
-    std::queue<std::pair<int, int>> queue;
-    
-    queue.push({fromX, fromY});
-    visited[fromY][fromX] = true;
-    
+    // Jeden BFS od kulki; potem każde canMoveTo/findPath to odczyt z tablicy
+    reachParent.assign(width * height, -1);
+    reachSourceX = fromX;
+    reachSourceY = fromY;
+    reachVersion = stateVersion;
+
+    int source = fromY * width + fromX;
+    reachParent[source] = source;
+    reachQueue.clear();
+    reachQueue.push_back(source);
+
     // Kierunki: góra, dół, lewo, prawo
     int dx[] = {0, 0, -1, 1};
     int dy[] = {-1, 1, 0, 0};
-    
-    while (!queue.empty())
+
+    for (size_t head = 0; head < reachQueue.size(); ++head)
     {
-        auto [x, y] = queue.front();
-        queue.pop();
-        
-        if (x == toX && y == toY)
-        {
-            // Odtwórz ścieżkę
-            std::vector<std::pair<int, int>> path;
-            int currX = toX, currY = toY;
-            
-            while (currX != -1 && currY != -1)
-            {
-                path.push_back({currX, currY});
-                auto [px, py] = parent[currY][currX];
-                currX = px;
-                currY = py;
-            }
-            
-            std::reverse(path.begin(), path.end());
-            return path;
-        }
-        
-        // Sprawdź sąsiadów
+        int x = reachQueue[head] % width;
+        int y = reachQueue[head] / width;
+
         for (int i = 0; i < 4; i++)
         {
             int newX = x + dx[i];
             int newY = y + dy[i];
-            
-            if (isValidPosition(newX, newY) && !visited[newY][newX])
+            if (isEmpty(newX, newY) && reachParent[newY * width + newX] == -1)
             {
-                // Pozwól przejść przez pozycję startową lub puste pola
-                if ((newX == fromX && newY == fromY) || isEmpty(newX, newY))
-                {
-                    visited[newY][newX] = true;
-                    parent[newY][newX] = {x, y};
-                    queue.push({newX, newY});
-                }
+                reachParent[newY * width + newX] = reachQueue[head];
+                reachQueue.push_back(newY * width + newX);
             }
         }
     }
+}
+
+void Board::ensureReachable(int fromX, int fromY)
+{
+    if (reachVersion != stateVersion || reachSourceX != fromX || reachSourceY != fromY)
+        computeReachable(fromX, fromY);
+}
+
+std::vector<std::pair<int, int>> Board::findPath(int fromX, int fromY, int toX, int toY)
+{
+    if (!isValidPosition(fromX, fromY) || !isValidPosition(toX, toY))
+        return {};
     
-    return {}; // Nie znaleziono ścieżki
+    if (!isEmpty(toX, toY))
+        return {};
+
+    ensureReachable(fromX, fromY);
+    if (reachParent[toY * width + toX] == -1)
+        return {}; // Nie znaleziono ścieżki
+
+    // Odtwórz ścieżkę z drzewa BFS
+    std::vector<std::pair<int, int>> path;
+    int source = fromY * width + fromX;
+    for (int index = toY * width + toX; ; index = reachParent[index])
+    {
+        path.push_back({index % width, index / width});
+        if (index == source)
+            break;
+    }
+
+    std::reverse(path.begin(), path.end());
+    return path;
 }
 
 bool Board::canMoveTo(int fromX, int fromY, int toX, int toY)
 {
-    auto path = findPath(fromX, fromY, toX, toY);
-    return !path.empty();
+    if (!isValidPosition(fromX, fromY) || !isEmpty(toX, toY))
+        return false;
+
+    ensureReachable(fromX, fromY);
+    return reachParent[toY * width + toX] != -1;
+}
+
+void Board::handleMouseMove(float mouseX, float mouseY)
+{
+    auto [gridX, gridY] = getGridPosition(mouseX, mouseY);
+    hoverX = gridX;
+    hoverY = gridY;
+}
+
+void Board::drawPathPreview(sf::RenderTarget& window)
+{
+    if (!hasBallSelected || lineAnimationActive || gameOver || !isEmpty(hoverX, hoverY))
+        return;
+
+    // Drzewo BFS jest z selectBall - tu tylko przechodzimy po rodzicach
+    ensureReachable(selectedX, selectedY);
+    int source = selectedY * width + selectedX;
+    int index = hoverY * width + hoverX;
+    if (reachParent[index] == -1)
+        return;
+
+    sf::RectangleShape step({cellSize * 0.3f, cellSize * 0.3f});
+    step.setFillColor(sf::Color(255, 255, 255, 90));
+    for (; index != source; index = reachParent[index])
+    {
+        step.setPosition({offsetX + (index % width) * cellSize + cellSize * 0.35f,
+                          offsetY + (index / width) * cellSize + cellSize * 0.35f});
+        window.draw(step);
+    }
 }
 
 void Board::moveBall(int fromX, int fromY, int toX, int toY)
@@ -473,7 +534,33 @@ void Board::moveBall(int fromX, int fromY, int toX, int toY)
     
     if (balls[fromY][fromX] == nullptr || !isEmpty(toX, toY))
         return;
+
+    if (!observers.empty())
+    {
+        BoardState before = snapshot();
+        for (auto* observer : observers)
+            observer->onMove(before, {fromX, fromY, toX, toY});
+    }
     
+    // Animacja przejścia po ścieżce BFS (ok. 30 ms na pole, najwyżej 0,3 s)
+    if (!turboMode)
+    {
+        std::vector<float> points;
+        for (const auto& step : findPath(fromX, fromY, toX, toY))
+        {
+            sf::Vector2f position = getCellPosition(step.first, step.second);
+            points.push_back(position.x);
+            points.push_back(position.y);
+        }
+        timeline.remove(travelEffect);
+        float duration = std::min(0.3f, 0.03f * static_cast<float>(points.size() / 2));
+        travelEffect = timeline.addTravel(points, duration, grid[fromY][fromX]);
+        travelX = toX;
+        travelY = toY;
+    }
+
+    turnCount++;
+
     // Przenieś kulkę
     balls[toY][toX] = std::move(balls[fromY][fromX]);
     balls[fromY][fromX] = nullptr;
@@ -485,15 +572,33 @@ void Board::moveBall(int fromX, int fromY, int toX, int toY)
     // Zaktualizuj grid
     grid[toY][toX] = grid[fromY][fromX];
     grid[fromY][fromX] = 0;
+    stateVersion++;
+
+    for (auto* observer : observers)
+    {
+        observer->onCellChanged(fromX, fromY, 0);
+        observer->onCellChanged(toX, toY, grid[toY][toX]);
+    }
+
+    if (puzzleMode)
+        puzzleMovesLeft--;
     
     // Sprawdź linie po ruchu
     auto lines = findAllLines();
     if (!lines.empty())
     {
+        // Zagadka liczy linie tak jak PuzzleGenerator - inaczej cel mógłby się rozjechać przy skrzyżowaniach
+        if (puzzleMode)
+            puzzleLines += snapshot().linesThrough(toX, toY);
         markLinesForRemoval(lines);
         startLineAnimation();
         // Nie dodajemy nowych kulek jeśli są linie do usunięcia
     }
+    else if (puzzleMode)
+    {
+        comboMultiplier = 1;
+        checkPuzzleEnd(); // W zagadce nie dokładamy kulek
+    }
     else
     {
         comboMultiplier = 1; // Reset combo jeśli nie ma linii
@@ -513,25 +618,27 @@ void Board::moveBall(int fromX, int fromY, int toX, int toY)
             checkGameOver();
         }
     }
+
+    notifyScore();
+    if (!lineAnimationActive)
+        captureTurn();
+    saveLive();
 }
 
 void Board::update()
 {
-    // Obsługa migania wybranej kulki
-    if (hasBallSelected && blinkClock.getElapsedTime().asMilliseconds() > 500) // Miganie co 500ms
-    {
-        blinkState = !blinkState;
-        blinkClock.restart();
-    }
+    // Jeden krok wszystkich animacji (miganie, linie, latające punkty, ruch kulki)
+    timeline.advance(frameClock.restart().asSeconds());
     
     // Obsługa animacji linii
-    if (lineAnimationActive)
+    if (turboMode)
+    {
+        settleAnimations();
+    }
+    else if (lineAnimationActive)
     {
         updateLineAnimation();
     }
-    
-    // Aktualizuj latające punkty
-    updateFloatingScores();
 }
 
 std::vector<std::vector<std::pair<int, int>>> Board::findAllLines()
@@ -608,66 +715,62 @@ void Board::markLinesForRemoval(const std::vector<std::vector<std::pair<int, int
     }
     
     // Oznacz nowe linie
+    std::vector<std::pair<int, int>> markedCells;
     for (const auto& line : lines)
     {
         for (auto [x, y] : line)
         {
             lineMarked[y][x] = true;
+            markedCells.push_back({x, y});
         }
     }
+
+    for (auto* observer : observers)
+        observer->onLinesMarked(markedCells);
 }
 
 void Board::startLineAnimation()
 {
     lineAnimationActive = true;
-    animationPhase = 0; // Zaczynamy od highlight
-    lineAnimationClock.restart();
-    fastBlinkState = true;
+    // Highlight 300 ms, potem szybkie miganie co 150 ms przez 1 s; koniec migania usuwa linie
+    timeline.remove(lineHighlight);
+    timeline.remove(lineBlink);
+    if (turboMode)
+        return; // settleAnimations usuwa linie od razu
+    lineHighlight = timeline.add(EffectKind::Highlight, 0.3f);
+    lineBlink = timeline.add(EffectKind::Blink, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0.15f, 0.3f);
+}
+
+void Board::stopLineAnimation()
+{
+    lineAnimationActive = false;
+    timeline.remove(lineHighlight);
+    timeline.remove(lineBlink);
+    lineHighlight = AnimationTimeline::InvalidHandle;
+    lineBlink = AnimationTimeline::InvalidHandle;
 }
 
 void Board::updateLineAnimation()
 {
-    auto elapsed = lineAnimationClock.getElapsedTime().asMilliseconds();
-    
-    switch (animationPhase)
-    {
-        case 0: // Highlight phase - 300ms
-            if (elapsed > 300)
-            {
-                animationPhase = 1;
-                lineAnimationClock.restart();
-                blinkTimer.restart(); // Uruchom timer migania
-            }
-            break;
-            
-        case 1: // Fast blink phase - 1000ms (150ms intervals)
-            // Obsługa migania co 150ms
-            if (blinkTimer.getElapsedTime().asMilliseconds() > 150)
-            {
-                fastBlinkState = !fastBlinkState;
-                blinkTimer.restart();
-            }
-            
-            // Sprawdź czy minęła 1 sekunda od rozpoczęcia fazy 1
-            if (elapsed > 1000)
-            {
-                animationPhase = 2;
-                lineAnimationClock.restart();
-            }
-            break;
-            
-        case 2: // Remove phase
-            removeLinesAndUpdateScore();
-            lineAnimationActive = false;
-            animationPhase = 0;
-            break;
-    }
+    // Dopóki miganie trwa, drawBalls bierze fazę z osi czasu
+    if (timeline.isAlive(lineBlink))
+        return;
+
+    // Chain reaction może od razu uruchomić kolejną animację
+    stopLineAnimation();
+    removeLinesAndUpdateScore();
 }
 
 void Board::removeLinesAndUpdateScore()
 {
-    int totalPoints = 0;
     int linesRemoved = 0;
+
+    if (!observers.empty())
+    {
+        BoardState before = snapshot();
+        for (auto* observer : observers)
+            observer->onLinesFound(before);
+    }
     
     // Debug: sprawdź ile kulek ma być usuniętych
     int markedCount = 0;
@@ -687,15 +790,20 @@ void Board::removeLinesAndUpdateScore()
             {
                 if (balls[y][x] != nullptr)
                 {
-                    // Dodaj latające punkty w pozycji kulki
+                    // Dodaj latające punkty w pozycji kulki i zanikającą kulkę
                     sf::Vector2f pos = getCellPosition(x, y);
                     addScore(10 * comboMultiplier, pos);
-                    totalPoints += 10 * comboMultiplier;
+                    if (!turboMode)
+                        timeline.add(EffectKind::Fade, 0.3f, pos.x, pos.y, pos.x, pos.y, grid[y][x]);
                     
                     // Usuń kulkę
                     balls[y][x] = nullptr;
                     grid[y][x] = 0;
                     linesRemoved++;
+                    stateVersion++;
+
+                    for (auto* observer : observers)
+                        observer->onCellChanged(x, y, 0);
                 }
                 // Zawsze odznacz pole po przetworzeniu
                 lineMarked[y][x] = false;
@@ -703,15 +811,20 @@ void Board::removeLinesAndUpdateScore()
         }
     }
     
+    for (auto* observer : observers)
+        observer->onLinesMarked({});
+
     // Bonus za długość linii i combo
-    if (linesRemoved >= 3)
+    int points = BoardState::pointsForClear(linesRemoved, comboMultiplier);
+    score += points;
+
+    if (!observers.empty())
     {
-        int bonus = (linesRemoved - 2) * 30 * comboMultiplier;
-        totalPoints += bonus;
-        score += bonus;
+        BoardState after = snapshot();
+        for (auto* observer : observers)
+            observer->onLinesRemoved(after, linesRemoved, points);
     }
-    
-    score += totalPoints;
+
     comboMultiplier++;
     
     // Sprawdź czy powstały nowe linie (chain reaction)
@@ -721,6 +834,11 @@ void Board::removeLinesAndUpdateScore()
         markLinesForRemoval(newLines);
         startLineAnimation();
     }
+    else if (puzzleMode)
+    {
+        comboMultiplier = 1;
+        checkPuzzleEnd();
+    }
     else
     {
         comboMultiplier = 1; // Reset combo
@@ -740,6 +858,11 @@ void Board::removeLinesAndUpdateScore()
             checkGameOver();
         }
     }
+
+    notifyScore();
+    if (!lineAnimationActive)
+        captureTurn();
+    saveLive();
 }
 
 int Board::calculateLineScore(int lineLength)
@@ -753,39 +876,40 @@ int Board::calculateLineScore(int lineLength)
 
 void Board::addScore(int points, sf::Vector2f position)
 {
-    floatingScores.push_back({position, points});
-    scoreAnimationClock.restart();
-}
+    if (turboMode)
+        return; // Przy tysiącach ruchów na sekundę i tak nie byłoby ich widać
 
-void Board::updateFloatingScores()
-{
-    auto elapsed = scoreAnimationClock.getElapsedTime().asSeconds();
-    
-    // Usuń stare latające punkty (po 2 sekundach)
-    floatingScores.erase(
-        std::remove_if(floatingScores.begin(), floatingScores.end(),
-            [elapsed](const std::pair<sf::Vector2f, int>& score) {
-                return elapsed > 2.0f;
-            }),
-        floatingScores.end()
-    );
+    // Każde punkty mają własny czas - 2 s lotu w górę z zanikaniem
+    timeline.add(EffectKind::FloatUp, 2.0f, position.x, position.y, position.x, position.y - 40.0f, points);
 }
 
-void Board::drawFloatingScores(sf::RenderWindow& window)
+void Board::drawEffects(sf::RenderTarget& window)
 {
-    if (!fontLoaded) return;
-
-    sf::Text text(font);
-    text.setCharacterSize(20);
-    text.setFillColor(sf::Color::Yellow);
-    text.setOutlineColor(sf::Color::Black);
-    text.setOutlineThickness(1.0f);
+    sf::CircleShape ghost(20.0f);
 
-    for (const auto& score : floatingScores)
+    for (size_t i = 0; i < timeline.size(); ++i)
     {
-        text.setString("+" + std::to_string(score.second));
-        text.setPosition(score.first);
-        window.draw(text);
+        EffectKind kind = timeline.kind(i);
+        if (kind != EffectKind::Fade && kind != EffectKind::FloatUp && kind != EffectKind::Travel)
+            continue;
+
+        float x, y;
+        timeline.position(i, x, y);
+        std::uint8_t alpha = static_cast<std::uint8_t>(255.0f * timeline.alpha(i));
+
+        if (kind == EffectKind::FloatUp)
+        {
+            text.draw(window, "+" + std::to_string(timeline.value(i)), {x, y}, 20,
+                      sf::Color(255, 255, 0, alpha), sf::Color(0, 0, 0, alpha));
+            continue;
+        }
+
+        sf::Color color = toSFMLColor(static_cast<BallColor>(timeline.value(i) - 1));
+        if (kind == EffectKind::Fade)
+            color.a = alpha;
+        ghost.setFillColor(color);
+        ghost.setPosition({x, y});
+        window.draw(ghost);
     }
 }
 
@@ -808,6 +932,9 @@ void Board::generateNextBalls()
     {
         nextBalls.push_back(getRandomColor());
     }
+
+    for (auto* observer : observers)
+        observer->onNextBalls(nextBalls);
 }
 
 void Board::addNewBalls()
@@ -833,16 +960,26 @@ void Board::addNewBalls()
     std::shuffle(emptyPositions.begin(), emptyPositions.end(), rng);
     
     // Dodaj kulki z nextBalls
+    int added = 0;
     for (int i = 0; i < ballsToAdd && i < 2; ++i) // Maksymalnie 2 kulki
     {
         auto [x, y] = emptyPositions[i];
         BallColor color = nextBalls[i];
         placeBallAt(x, y, color);
+        added++;
     }
     
     // Wygeneruj nowe nextBalls
     generateNextBalls();
     ballsToAdd = 2; // Reset na następny ruch
+
+    if (!observers.empty())
+    {
+        BoardState after = snapshot();
+        std::vector<std::pair<int, int>> positions(emptyPositions.begin(), emptyPositions.begin() + added);
+        for (auto* observer : observers)
+            observer->onBallsAdded(after, positions);
+    }
 }
 
 std::vector<std::pair<int, int>> Board::getEmptyPositions()
@@ -865,24 +1002,16 @@ std::vector<std::pair<int, int>> Board::getEmptyPositions()
 
 bool Board::hasAvailableMoves()
 {
-    // Sprawdź czy istnieje przynajmniej jedna kulka, która może się ruszyć
+    // Kulka może się ruszyć wtedy i tylko wtedy, gdy ma pustego sąsiada -
+    // nie trzeba szukać ścieżki do każdego pustego pola
     for (int y = 0; y < height; ++y)
     {
         for (int x = 0; x < width; ++x)
         {
-            if (!isEmpty(x, y))
+            if (!isEmpty(x, y) &&
+                (isEmpty(x - 1, y) || isEmpty(x + 1, y) || isEmpty(x, y - 1) || isEmpty(x, y + 1)))
             {
-                // Sprawdź czy ta kulka może się ruszyć w którymkolwiek kierunku
-                for (int ty = 0; ty < height; ++ty)
-                {
-                    for (int tx = 0; tx < width; ++tx)
-                    {
-                        if (isEmpty(tx, ty) && canMoveTo(x, y, tx, ty))
-                        {
-                            return true;
-                        }
-                    }
-                }
+                return true;
             }
         }
     }
@@ -891,16 +1020,23 @@ bool Board::hasAvailableMoves()
 
 void Board::checkGameOver()
 {
+    if (gameOver)
+        return;
+
     auto emptyPositions = getEmptyPositions();
     
     // Jeśli nie ma miejsca na nowe kulki lub nie ma dostępnych ruchów
     if (emptyPositions.size() < 2 || !hasAvailableMoves()) // Sprawdź miejsce na 2 kulki
     {
         gameOver = true;
+
+        BoardState finalState = snapshot();
+        for (auto* observer : observers)
+            observer->onGameOver(finalState);
     }
 }
 
-void Board::drawNextBalls(sf::RenderWindow& window)
+void Board::drawNextBalls(sf::RenderTarget& window)
 {
     // Rysuj preview następnych kulek w prawym górnym rogu
     float startX = 650.0f;
@@ -911,29 +1047,370 @@ void Board::drawNextBalls(sf::RenderWindow& window)
     for (size_t i = 0; i < nextBalls.size(); ++i)
     {
         sf::CircleShape previewBall(ballRadius);
-        previewBall.setFillColor(getSFMLColorFromBallColor(nextBalls[i]));
+        previewBall.setFillColor(toSFMLColor(nextBalls[i]));
         previewBall.setPosition({startX, startY + i * spacing});
         window.draw(previewBall);
     }
 }
 
-sf::Color Board::getSFMLColorFromBallColor(BallColor ballColor) const
+
+BoardState Board::snapshot() const
+{
+    BoardState state(width, height);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            state.set(x, y, grid[y][x]);
+        }
+    }
+    state.nextBalls = nextBalls;
+    state.score = score;
+    state.combo = comboMultiplier;
+    return state;
+}
+
+void Board::showHint(const Move& move)
+{
+    hintMove = move;
+    hintVersion = stateVersion; // Podpowiedź znika przy następnej zmianie planszy
+}
+
+void Board::drawHint(sf::RenderTarget& window)
+{
+    if (hintVersion != stateVersion || gameOver)
+        return;
+
+    sf::RectangleShape marker({cellSize - 6.0f, cellSize - 6.0f});
+    marker.setFillColor(sf::Color::Transparent);
+    marker.setOutlineThickness(3.0f);
+
+    // Skąd - żółta ramka, dokąd - zielona
+    marker.setOutlineColor(sf::Color(255, 220, 0));
+    marker.setPosition({offsetX + hintMove.fromX * cellSize + 3.0f, offsetY + hintMove.fromY * cellSize + 3.0f});
+    window.draw(marker);
+
+    marker.setOutlineColor(sf::Color(0, 220, 120));
+    marker.setPosition({offsetX + hintMove.toX * cellSize + 3.0f, offsetY + hintMove.toY * cellSize + 3.0f});
+    window.draw(marker);
+}
+
+void Board::addObserver(BoardObserver* observer)
+{
+    observers.push_back(observer);
+    observer->onReset(snapshot()); // Nowy obserwator zaczyna od pełnego stanu
+}
+
+void Board::removeObserver(BoardObserver* observer)
+{
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
+
+bool Board::loadPuzzle(const Puzzle& puzzle)
+{
+    if (puzzle.board.width != width || puzzle.board.height != height)
+        return false;
+
+    // Bez reset(): zagadka nie jest nową grą (numer gry i generator zostają bez zmian)
+    clearState();
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (puzzle.board.at(x, y) != 0)
+                placeBallAt(x, y, static_cast<BallColor>(puzzle.board.at(x, y) - 1));
+        }
+    }
+
+    nextBalls.clear(); // Zagadka nie dokłada kulek
+    puzzleMode = true;
+    puzzleMovesLeft = puzzle.moves;
+    puzzleGoal = puzzle.goalLines;
+    puzzleLines = 0;
+    history.clear();
+    captureTurn();
+
+    if (!observers.empty())
+    {
+        BoardState state = snapshot();
+        for (auto* observer : observers)
+            observer->onReset(state);
+    }
+    saveLive();
+    return true;
+}
+
+void Board::checkPuzzleEnd()
+{
+    if (puzzleLines >= puzzleGoal || puzzleMovesLeft <= 0)
+    {
+        gameOver = true;
+        deselectBall();
+
+        BoardState finalState = snapshot();
+        for (auto* observer : observers)
+            observer->onGameOver(finalState);
+    }
+}
+
+void Board::drawPuzzleStatus(sf::RenderTarget& window)
+{
+    text.draw(window, "Puzzle: lines " + std::to_string(puzzleLines) + "/" + std::to_string(puzzleGoal) +
+                      ", moves left " + std::to_string(puzzleMovesLeft),
+              {offsetX, offsetY + height * cellSize + 10.0f}, 20, sf::Color::White);
+
+    if (!gameOver)
+        return;
+
+    sf::RectangleShape overlay({(float)width * cellSize, (float)height * cellSize});
+    overlay.setPosition({offsetX, offsetY});
+    overlay.setFillColor(sf::Color(0, 0, 0, 150));
+    window.draw(overlay);
+
+    // R w trybie zagadek kończy zagadkę i zaczyna zwykłą grę (Board::reset), P ładuje następną
+    drawGameOverText(window, isPuzzleSolved() ? "SOLVED" : "FAILED", isPuzzleSolved() ? sf::Color::Green : sf::Color::Red,
+                     "Press P for Next Puzzle, R for New Game");
+}
+
+void Board::setTurbo(bool enabled)
+{
+    turboMode = enabled;
+    if (turboMode)
+    {
+        timeline.clear();
+        deselectBall();
+        settleAnimations();
+    }
+    else
+    {
+        // Tury turbo nie trafiają do historii - zaczynamy ją od bieżącego stanu
+        history.clear();
+        captureTurn();
+    }
+}
+
+void Board::settleAnimations()
 {
-    switch (ballColor)
+    // Wszystkie fazy animacji od razu - łącznie z chain reaction,
+    // które removeLinesAndUpdateScore uruchamia przez startLineAnimation
+    while (lineAnimationActive)
+    {
+        stopLineAnimation();
+        removeLinesAndUpdateScore();
+    }
+}
+
+void Board::notifyScore()
+{
+    for (auto* observer : observers)
+        observer->onScoreChanged(score, comboMultiplier);
+}
+
+void Board::captureTurn()
+{
+    if (turboMode)
+        return; // Tysiące ruchów na sekundę - bez historii
+
+    BoardSnapshot extra;
+    extra.turn = turnCount;
+    extra.ballsToAdd = ballsToAdd;
+    extra.gameOver = gameOver;
+    extra.puzzleMovesLeft = puzzleMovesLeft;
+    extra.puzzleLines = puzzleLines;
+    history.capture(snapshot(), rng, std::move(extra));
+}
+
+bool Board::undo()
+{
+    // W trakcie animacji tura nie jest jeszcze zapisana
+    if (lineAnimationActive || turboMode)
+        return false;
+
+    const BoardSnapshot* from = history.current();
+    const BoardSnapshot* target = history.undo();
+    if (!target)
+        return false;
+    restoreTurn(*target, from);
+    return true;
+}
+
+bool Board::redo()
+{
+    if (lineAnimationActive || turboMode)
+        return false;
+
+    const BoardSnapshot* from = history.current();
+    const BoardSnapshot* target = history.redo();
+    if (!target)
+        return false;
+    restoreTurn(*target, from);
+    return true;
+}
+
+void Board::restoreTurn(const BoardSnapshot& target, const BoardSnapshot* from)
+{
+    deselectBall();
+    stopLineAnimation();
+    timeline.clear();
+
+    // Kawałki wspólne z bieżącym snapshotem się nie zmieniły - przepisujemy tylko pozostałe
+    for (size_t c = 0; c < target.grid.chunkCount(); ++c)
+    {
+        if (from && from->grid.chunk(c) == target.grid.chunk(c))
+            continue;
+
+        for (int i = 0; i < CowGrid::ChunkCells; ++i)
+        {
+            int index = static_cast<int>(c) * CowGrid::ChunkCells + i;
+            if (index >= width * height)
+                break;
+
+            int x = index % width;
+            int y = index / width;
+            int value = target.grid.at(x, y);
+            lineMarked[y][x] = false;
+            if (grid[y][x] == value)
+                continue;
+
+            if (value == 0)
+            {
+                balls[y][x] = nullptr;
+                grid[y][x] = 0;
+            }
+            else
+            {
+                placeBallAt(x, y, static_cast<BallColor>(value - 1));
+            }
+        }
+    }
+
+    nextBalls = target.nextBalls;
+    score = target.score;
+    comboMultiplier = target.combo;
+    turnCount = target.turn;
+    ballsToAdd = target.ballsToAdd;
+    gameOver = target.gameOver;
+    puzzleMovesLeft = target.puzzleMovesLeft;
+    puzzleLines = target.puzzleLines;
+    target.restoreRng(rng);
+    stateVersion++;
+
+    if (!observers.empty())
+    {
+        BoardState state = snapshot();
+        for (auto* observer : observers)
+            observer->onReset(state);
+    }
+    saveLive();
+}
+
+void Board::attachLiveFile(LiveGameFile* file)
+{
+    liveFile = file;
+    saveLive();
+}
+
+void Board::saveLive()
+{
+    if (!liveFile || !liveFile->isOpen() || width * height > LiveGameRecord::MaxCells)
+        return;
+
+    // Pola wpisywane wprost do slotu w zmapowanym pliku
+    LiveGameRecord& record = liveFile->beginWrite();
+    record.width = width;
+    record.height = height;
+    record.score = score;
+    record.combo = comboMultiplier;
+    record.turn = turnCount;
+    record.ballsToAdd = ballsToAdd;
+    record.selectedX = hasBallSelected ? selectedX : -1;
+    record.selectedY = hasBallSelected ? selectedY : -1;
+    record.puzzleMovesLeft = puzzleMovesLeft;
+    record.puzzleGoal = puzzleGoal;
+    record.puzzleLines = puzzleLines;
+    record.gameOver = gameOver;
+    record.lineAnimation = lineAnimationActive;
+    record.puzzleMode = puzzleMode;
+    record.nextCount = static_cast<std::uint8_t>(std::min<size_t>(nextBalls.size(), LiveGameRecord::MaxNext));
+    for (int i = 0; i < record.nextCount; ++i)
+        record.next[i] = static_cast<std::uint8_t>(nextBalls[i]);
+    record.seed = gameSeed;
+    record.rngSegmentSeed = rng.segmentSeed;
+    record.rngDraws = rng.draws;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            int marked = lineMarked[y][x] ? LiveGameRecord::LineMarked : 0;
+            record.cells[y * width + x] = static_cast<std::uint8_t>(grid[y][x] | marked);
+        }
+    }
+    liveFile->commit();
+
+    // Na dysk tylko po zakończonej turze; w trakcie animacji linii stan zaraz znowu się zmieni
+    if (!lineAnimationActive)
+        liveFile->requestSync();
+}
+
+bool Board::resumeLive(const LiveGameRecord& record)
+{
+    if (record.width != width || record.height != height)
+        return false;
+
+    deselectBall();
+    stopLineAnimation();
+    timeline.clear();
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            int value = record.cells[y * width + x] & ~LiveGameRecord::LineMarked;
+            lineMarked[y][x] = (record.cells[y * width + x] & LiveGameRecord::LineMarked) != 0;
+            if (value == 0)
+            {
+                balls[y][x] = nullptr;
+                grid[y][x] = 0;
+            }
+            else
+            {
+                placeBallAt(x, y, static_cast<BallColor>(value - 1));
+            }
+        }
+    }
+
+    nextBalls.clear();
+    for (int i = 0; i < record.nextCount; ++i)
+        nextBalls.push_back(static_cast<BallColor>(record.next[i]));
+    score = record.score;
+    comboMultiplier = record.combo;
+    turnCount = record.turn;
+    ballsToAdd = record.ballsToAdd;
+    gameOver = record.gameOver != 0;
+    puzzleMode = record.puzzleMode != 0;
+    puzzleMovesLeft = record.puzzleMovesLeft;
+    puzzleGoal = record.puzzleGoal;
+    puzzleLines = record.puzzleLines;
+    rng = CountingRng::resume(record.rngSegmentSeed, record.rngDraws);
+    gameSeed = record.seed;
+    gameNumber++;
+    stateVersion++;
+
+    // Historia zaczyna się od wznowionej tury; przerwana animacja linii rusza od początku
+    history.clear();
+    if (record.lineAnimation)
+        startLineAnimation();
+    else
+        captureTurn();
+    if (isValidPosition(record.selectedX, record.selectedY) && !isEmpty(record.selectedX, record.selectedY))
+        selectBall(record.selectedX, record.selectedY);
+
+    if (!observers.empty())
     {
-        case BallColor::Red:
-            return sf::Color::Red;
-        case BallColor::Green:
-            return sf::Color::Green;
-        case BallColor::Blue:
-            return sf::Color::Blue;
-        case BallColor::Yellow:
-            return sf::Color::Yellow;
-        case BallColor::Purple:
-            return sf::Color::Magenta;
-        case BallColor::Orange:
-            return sf::Color(255, 165, 0);
-        default:
-            return sf::Color::White;
+        BoardState state = snapshot();
+        for (auto* observer : observers)
+            observer->onReset(state);
     }
+    notifyScore();
+    return true;
 }
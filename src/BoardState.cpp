@@ -0,0 +1,313 @@
+#include "../include/BoardState.hpp"
+#include <algorithm>
+#include <queue>
+
+BoardState::BoardState() : width(0), height(0), score(0), combo(1), lineLength(3)
+{
+}
+
+BoardState::BoardState(int w, int h) : width(w), height(h), cells(w * h, 0), score(0), combo(1), lineLength(3)
+{
+}
+
+bool BoardState::isValidPosition(int x, int y) const
+{
+    return x >= 0 && x < width && y >= 0 && y < height;
+}
+
+bool BoardState::isEmpty(int x, int y) const
+{
+    return isValidPosition(x, y) && at(x, y) == 0;
+}
+
+std::vector<std::pair<int, int>> BoardState::reachableFrom(int x, int y) const
+{
+    std::vector<std::pair<int, int>> reachable;
+    std::vector<bool> visited(width * height, false);
+    std::queue<std::pair<int, int>> queue;
+
+    queue.push({x, y});
+    visited[y * width + x] = true;
+
+    // Kierunki: góra, dół, lewo, prawo
+    int dx[] = {0, 0, -1, 1};
+    int dy[] = {-1, 1, 0, 0};
+
+    while (!queue.empty())
+    {
+        auto [cx, cy] = queue.front();
+        queue.pop();
+
+        for (int i = 0; i < 4; i++)
+        {
+            int newX = cx + dx[i];
+            int newY = cy + dy[i];
+
+            if (isEmpty(newX, newY) && !visited[newY * width + newX])
+            {
+                visited[newY * width + newX] = true;
+                reachable.push_back({newX, newY});
+                queue.push({newX, newY});
+            }
+        }
+    }
+
+    return reachable;
+}
+
+int BoardState::labelEmptyRegions(std::vector<int>& labels) const
+{
+    labels.assign(width * height, -1);
+    std::vector<int> stack;
+    int regions = 0;
+
+    for (int start = 0; start < width * height; ++start)
+    {
+        if (cells[start] != 0 || labels[start] != -1)
+            continue;
+
+        // Zalewanie obszaru od pola start
+        labels[start] = regions;
+        stack.push_back(start);
+        while (!stack.empty())
+        {
+            int index = stack.back();
+            stack.pop_back();
+            int x = index % width;
+            int y = index / width;
+
+            const int neighbours[4][2] = {{x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+            for (const auto& n : neighbours)
+            {
+                if (isEmpty(n[0], n[1]) && labels[n[1] * width + n[0]] == -1)
+                {
+                    labels[n[1] * width + n[0]] = regions;
+                    stack.push_back(n[1] * width + n[0]);
+                }
+            }
+        }
+        regions++;
+    }
+
+    return regions;
+}
+
+bool BoardState::canReach(const std::vector<int>& labels, const Move& move) const
+{
+    if (!isEmpty(move.toX, move.toY))
+        return false;
+
+    // Cel jest osiągalny, jeśli leży w obszarze sąsiadującym z kulką
+    int target = labels[move.toY * width + move.toX];
+    const int neighbours[4][2] = {{move.fromX, move.fromY - 1}, {move.fromX, move.fromY + 1},
+                                  {move.fromX - 1, move.fromY}, {move.fromX + 1, move.fromY}};
+    for (const auto& n : neighbours)
+    {
+        if (isValidPosition(n[0], n[1]) && labels[n[1] * width + n[0]] == target)
+            return true;
+    }
+    return false;
+}
+
+std::vector<Move> BoardState::legalMoves() const
+{
+    std::vector<Move> moves;
+    std::vector<int> labels;
+    int regions = labelEmptyRegions(labels);
+    if (regions == 0)
+        return moves;
+
+    // Pola każdego obszaru, żeby nie przeglądać całej planszy dla każdej kulki
+    std::vector<std::vector<int>> regionCells(regions);
+    for (int i = 0; i < width * height; ++i)
+    {
+        if (labels[i] >= 0)
+            regionCells[labels[i]].push_back(i);
+    }
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (at(x, y) == 0)
+                continue;
+
+            int seen[4];
+            int seenCount = 0;
+            const int neighbours[4][2] = {{x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+            for (const auto& n : neighbours)
+            {
+                if (!isEmpty(n[0], n[1]))
+                    continue;
+                int region = labels[n[1] * width + n[0]];
+                if (std::find(seen, seen + seenCount, region) != seen + seenCount)
+                    continue;
+                seen[seenCount++] = region;
+
+                for (int index : regionCells[region])
+                {
+                    moves.push_back({x, y, index % width, index / width});
+                }
+            }
+        }
+    }
+
+    return moves;
+}
+
+std::vector<std::pair<int, int>> BoardState::getEmptyPositions() const
+{
+    std::vector<std::pair<int, int>> emptyPos;
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (at(x, y) == 0)
+            {
+                emptyPos.push_back({x, y});
+            }
+        }
+    }
+
+    return emptyPos;
+}
+
+std::vector<std::vector<std::pair<int, int>>> BoardState::findAllLines() const
+{
+    std::vector<std::vector<std::pair<int, int>>> allLines;
+    std::vector<bool> checked(width * height, false);
+
+    // Kierunki: →, ↓, ↘, ↙
+    const std::pair<int, int> directions[] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (at(x, y) != 0 && !checked[y * width + x])
+            {
+                for (auto [dx, dy] : directions)
+                {
+                    auto line = checkDirection(x, y, dx, dy, at(x, y));
+                    if (static_cast<int>(line.size()) >= lineLength)
+                    {
+                        allLines.push_back(line);
+                        for (auto [px, py] : line)
+                        {
+                            checked[py * width + px] = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return allLines;
+}
+
+std::vector<std::pair<int, int>> BoardState::checkDirection(int startX, int startY, int dx, int dy, int value) const
+{
+    std::vector<std::pair<int, int>> line;
+    int x = startX, y = startY;
+
+    while (isValidPosition(x, y) && at(x, y) == value)
+    {
+        line.push_back({x, y});
+        x += dx;
+        y += dy;
+    }
+
+    x = startX - dx;
+    y = startY - dy;
+    while (isValidPosition(x, y) && at(x, y) == value)
+    {
+        line.insert(line.begin(), {x, y});
+        x -= dx;
+        y -= dy;
+    }
+
+    return line;
+}
+
+int BoardState::longestRunThrough(int x, int y) const
+{
+    if (at(x, y) == 0)
+        return 0;
+
+    return std::max(std::max(runLength(x, y, 1, 0), runLength(x, y, 0, 1)),
+                    std::max(runLength(x, y, 1, 1), runLength(x, y, -1, 1)));
+}
+
+int BoardState::linesThrough(int x, int y) const
+{
+    if (at(x, y) == 0)
+        return 0;
+    return (runLength(x, y, 1, 0) >= lineLength) + (runLength(x, y, 0, 1) >= lineLength) +
+           (runLength(x, y, 1, 1) >= lineLength) + (runLength(x, y, -1, 1) >= lineLength);
+}
+
+int BoardState::runLength(int x, int y, int dx, int dy) const
+{
+    int value = at(x, y);
+    int length = 1;
+    for (int cx = x + dx, cy = y + dy; isValidPosition(cx, cy) && at(cx, cy) == value; cx += dx, cy += dy)
+        length++;
+    for (int cx = x - dx, cy = y - dy; isValidPosition(cx, cy) && at(cx, cy) == value; cx -= dx, cy -= dy)
+        length++;
+    return length;
+}
+
+void BoardState::applyMove(const Move& move)
+{
+    set(move.toX, move.toY, at(move.fromX, move.fromY));
+    set(move.fromX, move.fromY, 0);
+}
+
+int BoardState::clearLines()
+{
+    auto lines = findAllLines();
+    int removed = 0;
+
+    for (const auto& line : lines)
+    {
+        for (auto [x, y] : line)
+        {
+            if (at(x, y) != 0)
+            {
+                set(x, y, 0);
+                removed++;
+            }
+        }
+    }
+
+    return removed;
+}
+
+bool BoardState::hasAvailableMoves() const
+{
+    // Kulka może się ruszyć wtedy i tylko wtedy, gdy ma pustego sąsiada
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (at(x, y) != 0 &&
+                (isEmpty(x - 1, y) || isEmpty(x + 1, y) || isEmpty(x, y - 1) || isEmpty(x, y + 1)))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int BoardState::pointsForClear(int removed, int combo)
+{
+    int points = 10 * combo * removed;
+    if (removed >= 3)
+    {
+        int bonus = (removed - 2) * 30 * combo;
+        points += 2 * bonus;
+    }
+    return points;
+}
@@ -0,0 +1,161 @@
+#include "../include/BoardWall.hpp"
+#include <algorithm>
+#include "../include/Ball.hpp"
+#include "../include/SelfPlay.hpp"
+
+namespace
+{
+    // Na pole: kwadrat tła i mniejszy kwadrat kulki, po 2 trójkąty
+    const size_t VerticesPerQuad = 6;
+    const size_t VerticesPerCell = 2 * VerticesPerQuad;
+
+    const sf::Color EmptyColor(40, 40, 40);
+    const sf::Color GameOverEmptyColor(70, 20, 20);
+}
+
+BoardWall::BoardWall(int cols, int rowCount, int w, int h, unsigned int seed)
+    : columns(cols), rows(rowCount), boardWidth(w), boardHeight(h), botRng(seed),
+      nextTile(0), movesPlayed(0), cellsUpdated(0)
+{
+    tiles.resize(static_cast<size_t>(columns) * rows);
+    for (size_t i = 0; i < tiles.size(); ++i)
+    {
+        tiles[i].game = std::make_unique<HeadlessGame>(w, h, seed + static_cast<unsigned int>(i) + 1);
+        tiles[i].drawnCells.assign(static_cast<size_t>(w) * h, -1); // -1: jeszcze nie narysowane
+        tiles[i].firstVertex = i * w * h * VerticesPerCell;
+    }
+    vertices.resize(tiles.size() * w * h * VerticesPerCell);
+}
+
+void BoardWall::layout(float left, float top, float width, float height)
+{
+    buildGeometry(left, top, width, height);
+}
+
+void BoardWall::buildGeometry(float left, float top, float width, float height)
+{
+    // Kwadratowe pola: największy rozmiar, przy którym zmieszczą się wszystkie kafelki
+    const float gap = 4.0f;
+    float tileWidth = (width - gap * (columns - 1)) / columns;
+    float tileHeight = (height - gap * (rows - 1)) / rows;
+    float cell = std::min(tileWidth / boardWidth, tileHeight / boardHeight);
+    float inset = std::max(1.0f, cell * 0.15f);
+
+    auto setQuad = [this](size_t first, float x0, float y0, float x1, float y1) {
+        const sf::Vector2f corners[6] = {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y0}, {x1, y1}, {x0, y1}};
+        for (size_t k = 0; k < 6; ++k)
+            vertices[first + k].position = corners[k];
+    };
+
+    for (size_t i = 0; i < tiles.size(); ++i)
+    {
+        float originX = left + (i % columns) * (cell * boardWidth + gap);
+        float originY = top + (i / columns) * (cell * boardHeight + gap);
+
+        for (int y = 0; y < boardHeight; ++y)
+        {
+            for (int x = 0; x < boardWidth; ++x)
+            {
+                size_t first = tiles[i].firstVertex + (y * boardWidth + x) * VerticesPerCell;
+                float cellX = originX + x * cell;
+                float cellY = originY + y * cell;
+                setQuad(first, cellX + 0.5f, cellY + 0.5f, cellX + cell - 0.5f, cellY + cell - 0.5f);
+                setQuad(first + VerticesPerQuad, cellX + inset, cellY + inset, cellX + cell - inset, cellY + cell - inset);
+            }
+        }
+
+        // Nowe położenie - kolory trzeba ustawić od nowa
+        std::fill(tiles[i].drawnCells.begin(), tiles[i].drawnCells.end(), -1);
+    }
+}
+
+void BoardWall::setQuadColor(size_t firstVertex, sf::Color color)
+{
+    for (size_t k = 0; k < VerticesPerQuad; ++k)
+        vertices[firstVertex + k].color = color;
+}
+
+void BoardWall::refreshTile(Tile& tile)
+{
+    const BoardState& state = tile.game->getState();
+    bool gameOver = tile.game->isGameOver();
+
+    // Zmiana game over zmienia tło wszystkich pól kafelka
+    if (gameOver != tile.drawnGameOver)
+    {
+        std::fill(tile.drawnCells.begin(), tile.drawnCells.end(), -1);
+        tile.drawnGameOver = gameOver;
+    }
+
+    sf::Color background = gameOver ? GameOverEmptyColor : EmptyColor;
+    for (size_t i = 0; i < state.cells.size(); ++i)
+    {
+        int value = state.cells[i];
+        if (tile.drawnCells[i] == value)
+            continue;
+
+        size_t first = tile.firstVertex + i * VerticesPerCell;
+        setQuadColor(first, background);
+        setQuadColor(first + VerticesPerQuad, value == 0 ? background : toSFMLColor(static_cast<BallColor>(value - 1)));
+        tile.drawnCells[i] = value;
+        cellsUpdated++;
+    }
+}
+
+void BoardWall::update(sf::Time budget)
+{
+    // Po jednym ruchu w każdej grze po kolei - przy małym budżecie
+    // wszystkie gry postępują równo, zamiast kilku szybko i reszty wcale
+    sf::Clock clock;
+    size_t idle = 0;
+    while (clock.getElapsedTime() < budget && idle < tiles.size())
+    {
+        Tile& tile = tiles[nextTile];
+        nextTile = (nextTile + 1) % tiles.size();
+
+        HeadlessGame& game = *tile.game;
+        if (game.isGameOver())
+        {
+            // Skończona gra zostaje chwilę na ekranie jako czerwony kafelek (patrz draw)
+            idle++;
+            continue;
+        }
+        idle = 0;
+
+        Move move = SelfPlay::chooseMove(game.getState(), botRng);
+        if (move.fromX < 0 || !game.playMove(move))
+            continue;
+        movesPlayed++;
+    }
+}
+
+void BoardWall::draw(sf::RenderTarget& window)
+{
+    for (auto& tile : tiles)
+    {
+        refreshTile(tile);
+
+        // Skończona gra: przez sekundę czerwona, potem zaczyna od nowa
+        if (tile.drawnGameOver && ++tile.gameOverFrames > 60)
+        {
+            tile.game->reset();
+            tile.gameOverFrames = 0;
+        }
+    }
+
+    window.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles);
+}
+
+unsigned long BoardWall::takeMovesPlayed()
+{
+    unsigned long moves = movesPlayed;
+    movesPlayed = 0;
+    return moves;
+}
+
+unsigned long BoardWall::takeCellsUpdated()
+{
+    unsigned long cells = cellsUpdated;
+    cellsUpdated = 0;
+    return cells;
+}
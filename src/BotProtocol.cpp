@@ -0,0 +1,327 @@
+#include "../include/BotProtocol.hpp"
+#include <charconv>
+
+BotProtocol::BotProtocol(int width, int height, unsigned int seed)
+    : game(width, height, seed), scratch(width, height), pendingBatch(0)
+{
+}
+
+void BotProtocol::reset(unsigned int seed)
+{
+    game.reset(seed);
+    pendingBatch = 0;
+    line.clear();
+    out.clear();
+}
+
+bool BotProtocol::restore(const CompactGame& compact)
+{
+    pendingBatch = 0;
+    line.clear();
+    out.clear();
+    return game.restore(compact);
+}
+
+int BotProtocol::run(std::FILE* input, std::FILE* output)
+{
+    line.reserve(1024);
+    out.reserve(64 * 1024);
+
+    while (readLine(input))
+    {
+        if (!handleCommand(line))
+            break;
+        // Odpowiedzi paczki wychodzą jednym zapisem po ostatniej linii
+        if (pendingBatch == 0)
+            flush(output);
+    }
+    flush(output);
+    return 0;
+}
+
+bool BotProtocol::readLine(std::FILE* input)
+{
+    // getline na std::string z rezerwą - bez alokacji przy każdej linii
+    line.clear();
+    int c;
+    while ((c = std::getc(input)) != EOF)
+    {
+        if (c == '\n')
+            return true;
+        if (c != '\r')
+            line.push_back(static_cast<char>(c));
+    }
+    return !line.empty();
+}
+
+void BotProtocol::flush(std::FILE* output)
+{
+    if (out.empty())
+        return;
+    std::fwrite(out.data(), 1, out.size(), output);
+    std::fflush(output);
+    out.clear();
+}
+
+std::string_view BotProtocol::nextToken(std::string_view& text)
+{
+    size_t start = text.find_first_not_of(' ');
+    if (start == std::string_view::npos)
+    {
+        text = {};
+        return {};
+    }
+    size_t end = text.find(' ', start);
+    if (end == std::string_view::npos)
+        end = text.size();
+
+    std::string_view token = text.substr(start, end - start);
+    text.remove_prefix(end);
+    return token;
+}
+
+bool BotProtocol::parseInt(std::string_view& text, int& value)
+{
+    std::string_view token = nextToken(text);
+    auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    return !token.empty() && result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+bool BotProtocol::parseBoard(std::string_view text, BoardState& state) const
+{
+    // Napis o stałej długości - pole i to indeks w cells, bez kopiowania napisu
+    if (text.size() != state.cells.size())
+        return false;
+
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        char c = text[i];
+        if (c == '.')
+            state.cells[i] = 0;
+        else if (c >= '1' && c <= '6')
+            state.cells[i] = c - '0';
+        else
+            return false;
+    }
+    return true;
+}
+
+void BotProtocol::appendInt(int value)
+{
+    char buffer[16];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void BotProtocol::appendBoard(const BoardState& state)
+{
+    for (int value : state.cells)
+        out.push_back(value == 0 ? '.' : static_cast<char>('0' + value));
+}
+
+void BotProtocol::appendPosition()
+{
+    const BoardState& state = game.getState();
+    out += "position ";
+    appendBoard(state);
+    out.push_back(' ');
+    for (BallColor color : state.nextBalls)
+        out.push_back(static_cast<char>('1' + static_cast<int>(color)));
+    out.push_back(' ');
+    appendInt(state.score);
+    out.push_back(' ');
+    appendInt(game.getTurn());
+    out += game.isGameOver() ? " 1\n" : " 0\n";
+}
+
+bool BotProtocol::handleCommand(std::string_view command)
+{
+    if (pendingBatch > 0)
+    {
+        handleBatchLine(command);
+        return true;
+    }
+
+    std::string_view args = command;
+    std::string_view name = nextToken(args);
+
+    if (name.empty())
+        return true;
+
+    if (name == "kulki")
+    {
+        out += "id name kulki\nid size ";
+        appendInt(game.getState().width);
+        out.push_back(' ');
+        appendInt(game.getState().height);
+        out += "\nkulkiok\n";
+    }
+    else if (name == "isready")
+    {
+        out += "readyok\n";
+    }
+    else if (name == "newgame")
+    {
+        int seed;
+        if (parseInt(args, seed))
+            game.reset(static_cast<unsigned int>(seed));
+        else
+            game.reset();
+        appendPosition();
+    }
+    else if (name == "position")
+    {
+        appendPosition();
+    }
+    else if (name == "move")
+    {
+        handleMove(args);
+    }
+    else if (name == "legal")
+    {
+        handleLegal(args);
+    }
+    else if (name == "apply")
+    {
+        handleApply(args);
+    }
+    else if (name == "batch")
+    {
+        // Kolejne linie to zapytania paczki - patrz handleBatchLine
+        int count;
+        if (!parseInt(args, count) || count < 0)
+            out += "error batch\n";
+        else if (count == 0)
+            out += "batchok\n";
+        else
+            pendingBatch = count;
+    }
+    else if (name == "quit")
+    {
+        return false;
+    }
+    else
+    {
+        out += "error unknown command\n";
+    }
+    return true;
+}
+
+void BotProtocol::handleBatchLine(std::string_view query)
+{
+    std::string_view name = nextToken(query);
+    if (name == "legal")
+        handleLegal(query);
+    else if (name == "apply")
+        handleApply(query);
+    else
+        out += "error batch\n";
+
+    if (--pendingBatch == 0)
+        out += "batchok\n";
+}
+
+void BotProtocol::handleMove(std::string_view args)
+{
+    Move move;
+    if (!parseInt(args, move.fromX) || !parseInt(args, move.fromY) ||
+        !parseInt(args, move.toX) || !parseInt(args, move.toY))
+    {
+        out += "illegal\n";
+        return;
+    }
+
+    int scoreBefore = game.getScore();
+    if (!game.playMove(move))
+    {
+        out += "illegal\n";
+        return;
+    }
+
+    out += "moved ";
+    appendInt(game.getScore() - scoreBefore);
+    out.push_back('\n');
+    appendPosition();
+}
+
+void BotProtocol::handleLegal(std::string_view args)
+{
+    std::string_view board = nextToken(args);
+    if (board.empty())
+    {
+        scratch.cells = game.getState().cells;
+    }
+    else if (!parseBoard(board, scratch))
+    {
+        out += "error board\n";
+        return;
+    }
+
+    // Ruchy wypisywane od razu z etykiet obszarów - bez listy ruchów
+    scratch.labelEmptyRegions(labels);
+    out += "moves ";
+    size_t countPos = out.size();
+    int count = 0;
+    for (int from = 0; from < scratch.width * scratch.height; ++from)
+    {
+        if (scratch.cells[from] == 0)
+            continue;
+        for (int to = 0; to < scratch.width * scratch.height; ++to)
+        {
+            Move move{from % scratch.width, from / scratch.width, to % scratch.width, to / scratch.width};
+            if (labels[to] < 0 || !scratch.canReach(labels, move))
+                continue;
+
+            out.push_back(' ');
+            appendInt(move.fromX);
+            out.push_back(' ');
+            appendInt(move.fromY);
+            out.push_back(' ');
+            appendInt(move.toX);
+            out.push_back(' ');
+            appendInt(move.toY);
+            count++;
+        }
+    }
+
+    char buffer[16];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), count);
+    out.insert(countPos, buffer, result.ptr - buffer);
+    out.push_back('\n');
+}
+
+void BotProtocol::handleApply(std::string_view args)
+{
+    Move move;
+    if (!parseBoard(nextToken(args), scratch))
+    {
+        out += "error board\n";
+        return;
+    }
+    if (!parseInt(args, move.fromX) || !parseInt(args, move.fromY) ||
+        !parseInt(args, move.toX) || !parseInt(args, move.toY) ||
+        !scratch.isValidPosition(move.fromX, move.fromY) || scratch.at(move.fromX, move.fromY) == 0 ||
+        !scratch.isValidPosition(move.toX, move.toY))
+    {
+        out += "illegal\n";
+        return;
+    }
+
+    scratch.labelEmptyRegions(labels);
+    if (!scratch.canReach(labels, move))
+    {
+        out += "illegal\n";
+        return;
+    }
+
+    scratch.applyMove(move);
+    int removed = scratch.clearLines();
+
+    out += "result ";
+    appendInt(removed);
+    out.push_back(' ');
+    appendInt(BoardState::pointsForClear(removed, 1));
+    out.push_back(' ');
+    appendBoard(scratch);
+    out.push_back('\n');
+}
@@ -0,0 +1,495 @@
+#include "../include/Dataset.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const int kColumnCount = 7;
+
+    void putU32(std::vector<std::uint8_t>& out, std::uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            out.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+
+    std::uint32_t getU32(const std::uint8_t* in)
+    {
+        return in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<std::uint32_t>(in[3]) << 24);
+    }
+
+    void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    bool getVarint(const std::vector<std::uint8_t>& in, size_t& pos, std::uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < in.size(); shift += 7)
+        {
+            std::uint8_t byte = in[pos++];
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    std::uint64_t zigzag(std::int64_t value)
+    {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t value)
+    {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    // Prosty kompresor LZ: bajt sterujący < 0x80 to (n-1) literałów,
+    // >= 0x80 to dopasowanie długości (c & 0x7f) + 4 z 16-bitowym przesunięciem wstecz
+    std::vector<std::uint8_t> compress(const std::vector<std::uint8_t>& in)
+    {
+        const int hashBits = 14;
+        const size_t maxMatch = 0x7f + 4;
+        std::vector<std::uint8_t> out;
+        out.reserve(in.size() / 2 + 16);
+        std::vector<std::int64_t> table(1 << hashBits, -1);
+
+        size_t literalStart = 0;
+        auto flushLiterals = [&](size_t end) {
+            while (literalStart < end)
+            {
+                size_t count = std::min<size_t>(end - literalStart, 128);
+                out.push_back(static_cast<std::uint8_t>(count - 1));
+                out.insert(out.end(), in.begin() + literalStart, in.begin() + literalStart + count);
+                literalStart += count;
+            }
+        };
+
+        size_t i = 0;
+        while (i + 4 <= in.size())
+        {
+            std::uint32_t sequence;
+            std::memcpy(&sequence, in.data() + i, 4);
+            std::uint32_t hash = (sequence * 2654435761u) >> (32 - hashBits);
+            std::int64_t candidate = table[hash];
+            table[hash] = static_cast<std::int64_t>(i);
+
+            if (candidate >= 0 && i - candidate <= 0xffff &&
+                std::memcmp(in.data() + candidate, in.data() + i, 4) == 0)
+            {
+                size_t length = 4;
+                while (i + length < in.size() && length < maxMatch && in[candidate + length] == in[i + length])
+                    length++;
+
+                flushLiterals(i);
+                size_t offset = i - candidate;
+                out.push_back(static_cast<std::uint8_t>(0x80 | (length - 4)));
+                out.push_back(static_cast<std::uint8_t>(offset & 0xff));
+                out.push_back(static_cast<std::uint8_t>(offset >> 8));
+                i += length;
+                literalStart = i;
+            }
+            else
+            {
+                i++;
+            }
+        }
+        flushLiterals(in.size());
+        return out;
+    }
+
+    bool decompress(const std::uint8_t* in, size_t size, size_t rawSize, std::vector<std::uint8_t>& out)
+    {
+        out.clear();
+        out.reserve(rawSize);
+        size_t pos = 0;
+        while (pos < size)
+        {
+            std::uint8_t control = in[pos++];
+            if (control & 0x80)
+            {
+                if (pos + 2 > size)
+                    return false;
+                size_t length = (control & 0x7f) + 4;
+                size_t offset = in[pos] | (in[pos + 1] << 8);
+                pos += 2;
+                if (offset == 0 || offset > out.size())
+                    return false;
+                size_t from = out.size() - offset;
+                for (size_t k = 0; k < length; ++k)
+                    out.push_back(out[from + k]); // Nakładanie się jest dozwolone
+            }
+            else
+            {
+                size_t count = control + 1;
+                if (pos + count > size)
+                    return false;
+                out.insert(out.end(), in + pos, in + pos + count);
+                pos += count;
+            }
+        }
+        return out.size() == rawSize;
+    }
+
+    void appendColumn(std::vector<std::uint8_t>& out, const std::vector<std::uint8_t>& raw)
+    {
+        std::vector<std::uint8_t> packed = compress(raw);
+        bool useLz = packed.size() < raw.size();
+        const auto& stored = useLz ? packed : raw;
+
+        putU32(out, static_cast<std::uint32_t>(raw.size()));
+        putU32(out, static_cast<std::uint32_t>(stored.size()));
+        out.push_back(useLz ? 1 : 0);
+        out.insert(out.end(), stored.begin(), stored.end());
+    }
+}
+
+void GameRecord::clear()
+{
+    gameId = 0;
+    outcome = 0;
+    turns.clear();
+    cells.clear();
+    nextBalls.clear();
+    moves.clear();
+    scoreDeltas.clear();
+}
+
+GameRecorder::GameRecorder() : scoreBefore(0), finished(false)
+{
+}
+
+void GameRecorder::start(std::uint64_t gameId)
+{
+    record.clear();
+    record.gameId = gameId;
+    scoreBefore = 0;
+    finished = false;
+}
+
+void GameRecorder::onMove(const BoardState& before, const Move& move)
+{
+    // Zmiana wyniku poprzedniego ruchu jest znana dopiero teraz
+    if (!record.scoreDeltas.empty())
+        record.scoreDeltas.back() = before.score - scoreBefore;
+    scoreBefore = before.score;
+
+    record.turns.push_back(static_cast<std::uint32_t>(record.turns.size()));
+    for (int value : before.cells)
+        record.cells.push_back(static_cast<std::uint8_t>(value));
+
+    std::uint8_t next = 0;
+    for (size_t i = 0; i < before.nextBalls.size() && i < 2; ++i)
+        next |= static_cast<std::uint8_t>((static_cast<int>(before.nextBalls[i]) + 1) << (3 * i));
+    record.nextBalls.push_back(next);
+
+    record.moves.push_back(static_cast<std::uint8_t>(move.fromX));
+    record.moves.push_back(static_cast<std::uint8_t>(move.fromY));
+    record.moves.push_back(static_cast<std::uint8_t>(move.toX));
+    record.moves.push_back(static_cast<std::uint8_t>(move.toY));
+    record.scoreDeltas.push_back(0);
+}
+
+void GameRecorder::onGameOver(const BoardState& finalState)
+{
+    if (!record.scoreDeltas.empty())
+        record.scoreDeltas.back() = finalState.score - scoreBefore;
+    record.outcome = finalState.score;
+    finished = true;
+}
+
+DatasetWriter::DatasetWriter(int w, int h, size_t blockSize, size_t maxPending)
+    : width(w), height(h), recordsPerBlock(blockSize), maxPendingBlocks(maxPending),
+      closing(false), recordsWritten(0), bytesWritten(0)
+{
+}
+
+DatasetWriter::~DatasetWriter()
+{
+    close();
+}
+
+bool DatasetWriter::open(const std::string& path, int threads)
+{
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    std::vector<std::uint8_t> header = {'K', 'D', 'S', '1'};
+    putU32(header, 1);
+    putU32(header, static_cast<std::uint32_t>(width));
+    putU32(header, static_cast<std::uint32_t>(height));
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    bytesWritten = header.size();
+
+    closing = false;
+    for (int i = 0; i < std::max(1, threads); ++i)
+    {
+        ioThreads.emplace_back(&DatasetWriter::ioLoop, this);
+    }
+    return true;
+}
+
+void DatasetWriter::submit(const GameRecord& game)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    GameRecord& columns = current.columns;
+    columns.turns.insert(columns.turns.end(), game.turns.begin(), game.turns.end());
+    columns.cells.insert(columns.cells.end(), game.cells.begin(), game.cells.end());
+    columns.nextBalls.insert(columns.nextBalls.end(), game.nextBalls.begin(), game.nextBalls.end());
+    columns.moves.insert(columns.moves.end(), game.moves.begin(), game.moves.end());
+    columns.scoreDeltas.insert(columns.scoreDeltas.end(), game.scoreDeltas.begin(), game.scoreDeltas.end());
+    current.gameIds.insert(current.gameIds.end(), game.size(), game.gameId);
+    current.outcomes.insert(current.outcomes.end(), game.size(), game.outcome);
+
+    if (columns.size() < recordsPerBlock)
+        return;
+
+    // Ograniczona pamięć: gdy wątki zapisu nie nadążają, producent czeka
+    queueChanged.wait(lock, [this] { return pending.size() < maxPendingBlocks; });
+    pending.push_back(std::move(current));
+    current = Block();
+    queueChanged.notify_all();
+}
+
+void DatasetWriter::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ioThreads.empty())
+            return;
+        if (current.columns.size() > 0)
+        {
+            pending.push_back(std::move(current));
+            current = Block();
+        }
+        closing = true;
+    }
+    queueChanged.notify_all();
+
+    for (auto& thread : ioThreads)
+        thread.join();
+    ioThreads.clear();
+    file.close();
+}
+
+void DatasetWriter::ioLoop()
+{
+    while (true)
+    {
+        Block block;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queueChanged.wait(lock, [this] { return closing || !pending.empty(); });
+            if (pending.empty())
+                return; // closing i nic do zapisania
+            block = std::move(pending.front());
+            pending.pop_front();
+        }
+        queueChanged.notify_all(); // Zwolniło się miejsce w kolejce
+
+        // Kompresja poza blokadami - równolegle w kilku wątkach
+        std::vector<std::uint8_t> bytes = encodeBlock(block);
+
+        std::lock_guard<std::mutex> lock(fileMutex);
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        recordsWritten += block.columns.size();
+        bytesWritten += bytes.size();
+    }
+}
+
+std::vector<std::uint8_t> DatasetWriter::encodeBlock(const Block& block) const
+{
+    const GameRecord& columns = block.columns;
+    const size_t count = columns.size();
+    const size_t area = static_cast<size_t>(width) * height;
+
+    std::vector<std::uint8_t> out;
+    putU32(out, static_cast<std::uint32_t>(count));
+
+    std::vector<std::uint8_t> raw;
+    std::uint64_t previousGame = 0;
+    for (std::uint64_t gameId : block.gameIds)
+    {
+        putVarint(raw, zigzag(static_cast<std::int64_t>(gameId - previousGame)));
+        previousGame = gameId;
+    }
+    appendColumn(out, raw);
+
+    raw.clear();
+    std::int64_t previousTurn = 0;
+    for (std::uint32_t turn : columns.turns)
+    {
+        putVarint(raw, zigzag(static_cast<std::int64_t>(turn) - previousTurn));
+        previousTurn = turn;
+    }
+    appendColumn(out, raw);
+
+    // Plansze: 3 bity na pole, XOR z poprzednią pozycją tej samej gry
+    // (kolejne pozycje różnią się kilkoma polami, więc zostają głównie zera)
+    raw.assign((count * area * 3 + 7) / 8, 0);
+    size_t bit = 0;
+    for (size_t r = 0; r < count; ++r)
+    {
+        bool sameGame = r > 0 && block.gameIds[r] == block.gameIds[r - 1];
+        for (size_t c = 0; c < area; ++c)
+        {
+            std::uint8_t value = columns.cells[r * area + c];
+            if (sameGame)
+                value ^= columns.cells[(r - 1) * area + c];
+
+            for (int b = 0; b < 3; ++b, ++bit)
+            {
+                if (value & (1 << b))
+                    raw[bit / 8] |= static_cast<std::uint8_t>(1 << (bit % 8));
+            }
+        }
+    }
+    appendColumn(out, raw);
+
+    appendColumn(out, columns.nextBalls);
+    appendColumn(out, columns.moves);
+
+    raw.clear();
+    for (std::int32_t delta : columns.scoreDeltas)
+        putVarint(raw, zigzag(delta));
+    appendColumn(out, raw);
+
+    raw.clear();
+    for (std::int32_t outcome : block.outcomes)
+        putVarint(raw, static_cast<std::uint64_t>(outcome));
+    appendColumn(out, raw);
+
+    return out;
+}
+
+std::uint64_t DatasetWriter::getRecordsWritten()
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
+    return recordsWritten;
+}
+
+std::uint64_t DatasetWriter::getBytesWritten()
+{
+    std::lock_guard<std::mutex> lock(fileMutex);
+    return bytesWritten;
+}
+
+DatasetReader::DatasetReader() : width(0), height(0)
+{
+}
+
+bool DatasetReader::open(const std::string& path)
+{
+    file.open(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::uint8_t header[16];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)))
+        return false;
+    if (std::memcmp(header, "KDS1", 4) != 0 || getU32(header + 4) != 1)
+        return false;
+
+    width = static_cast<int>(getU32(header + 8));
+    height = static_cast<int>(getU32(header + 12));
+    return width > 0 && height > 0;
+}
+
+bool DatasetReader::readBlock(std::vector<DatasetRecord>& records)
+{
+    std::uint8_t countBytes[4];
+    if (!file.read(reinterpret_cast<char*>(countBytes), 4))
+        return false;
+    const size_t count = getU32(countBytes);
+    const size_t area = static_cast<size_t>(width) * height;
+
+    std::vector<std::uint8_t> columns[kColumnCount];
+    for (auto& column : columns)
+    {
+        std::uint8_t info[9];
+        if (!file.read(reinterpret_cast<char*>(info), sizeof(info)))
+            return false;
+        std::uint32_t rawSize = getU32(info);
+        std::uint32_t storedSize = getU32(info + 4);
+
+        std::vector<std::uint8_t> stored(storedSize);
+        if (!file.read(reinterpret_cast<char*>(stored.data()), storedSize))
+            return false;
+
+        if (info[8] == 1)
+        {
+            if (!decompress(stored.data(), stored.size(), rawSize, column))
+                return false;
+        }
+        else
+        {
+            column = std::move(stored);
+        }
+    }
+
+    if (columns[2].size() * 8 < count * area * 3 || columns[3].size() < count || columns[4].size() < count * 4)
+        return false;
+
+    records.resize(count);
+    size_t gamePos = 0, turnPos = 0, deltaPos = 0, outcomePos = 0;
+    std::uint64_t gameId = 0;
+    std::int64_t turn = 0;
+    size_t bit = 0;
+
+    for (size_t r = 0; r < count; ++r)
+    {
+        DatasetRecord& record = records[r];
+        std::uint64_t value;
+
+        if (!getVarint(columns[0], gamePos, value))
+            return false;
+        gameId += static_cast<std::uint64_t>(unzigzag(value));
+        record.gameId = gameId;
+
+        if (!getVarint(columns[1], turnPos, value))
+            return false;
+        turn += unzigzag(value);
+        record.turn = static_cast<std::uint32_t>(turn);
+
+        bool sameGame = r > 0 && records[r - 1].gameId == record.gameId;
+        record.cells.resize(area);
+        for (size_t c = 0; c < area; ++c)
+        {
+            std::uint8_t cell = 0;
+            for (int b = 0; b < 3; ++b, ++bit)
+            {
+                if (columns[2][bit / 8] & (1 << (bit % 8)))
+                    cell |= static_cast<std::uint8_t>(1 << b);
+            }
+            record.cells[c] = sameGame ? cell ^ records[r - 1].cells[c] : cell;
+        }
+
+        record.nextBalls.clear();
+        for (int i = 0; i < 2; ++i)
+        {
+            int color = (columns[3][r] >> (3 * i)) & 7;
+            if (color != 0)
+                record.nextBalls.push_back(static_cast<BallColor>(color - 1));
+        }
+
+        const std::uint8_t* move = columns[4].data() + r * 4;
+        record.move = {move[0], move[1], move[2], move[3]};
+
+        if (!getVarint(columns[5], deltaPos, value))
+            return false;
+        record.scoreDelta = static_cast<std::int32_t>(unzigzag(value));
+
+        if (!getVarint(columns[6], outcomePos, value))
+            return false;
+        record.outcome = static_cast<std::int32_t>(value);
+    }
+    return true;
+}
@@ -1,12 +1,53 @@
 #include "../include/Game.hpp"
+#include "../include/InputReplay.hpp"
+#include "../include/SelfPlay.hpp"
+#include <algorithm>
+#include <ctime>
+#include <iostream>
 
-Game::Game()
-    : window(sf::VideoMode({800, 600}), "Kulki Game"), board(10, 10)
+Game::Game(bool offscreen)
+    : firstFrameShown(false), offscreen(offscreen), frameIndex(0), board(10, 10), analyzedVersion(0), nextPuzzle(0),
+      botRng(std::random_device{}()), turboMoves(0), resultsReady(false), bestShown(false),
+      finishedGame(0)
 {
-    window.setFramerateLimit(60);
+    if (offscreen)
+    {
+        if (!frame.resize({800, 600}))
+            std::cerr << "Nie można utworzyć tekstury klatki" << std::endl;
+    }
+    else
+    {
+        window.create(sf::VideoMode({800, 600}), "Kulki Game");
+        window.setFramerateLimit(60);
+    }
+
+    // Wagi sieci są opcjonalne - bez nich podpowiedzi liczy heurystyka
+    hintEngine.loadNetwork("kulki.weights");
+    // Odtwarzanie nie dopisuje wyników do bazy gracza
+    if (!offscreen)
+        resultsLoader = std::thread([this] { resultsReady = results.open("kulki.results"); });
+    // Niedokończona gra z poprzedniego uruchomienia (zakończona zaczyna się od nowa)
+    if (!offscreen && live.open("kulki.live"))
+    {
+        const LiveGameRecord* record = live.latest();
+        if (record && !record->gameOver)
+            board.resumeLive(*record);
+        board.attachLiveFile(&live);
+    }
+    constructedAt = startupClock.getElapsedTime();
 }
 
-Game::~Game() {}
+Game::~Game()
+{
+    if (resultsLoader.joinable())
+        resultsLoader.join();
+    if (resultsReady)
+        storeFinished();
+    if (stream.sinkCount() > 0)
+        board.removeObserver(&stream);
+    if (!offscreen && latency.samples() > 0)
+        latency.report(std::cout);
+}
 
 int Game::run()
 {
@@ -23,39 +64,94 @@ void Game::handleEvents()
 {
     while (const std::optional event = window.pollEvent())
     {
+        handleEvent(*event);
+    }
+}
 
-        if (event->is<sf::Event::Closed>())
-        {
-            window.close();
-        }
+void Game::handleEvent(const sf::Event& event)
+{
+    if (inputLog.is_open())
+    {
+        if (auto input = InputReplay::fromEvent(event, frameIndex))
+            InputReplay::write(inputLog, *input);
+    }
+
+    if (event.is<sf::Event::Closed>())
+    {
+        window.close();
+    }
+
+    if (hugeView && handleHugeBoardEvent(event))
+        return;
 
-        if (event->is<sf::Event::KeyPressed>())
+    if (event.is<sf::Event::KeyPressed>())
+    {
+        if (const auto *keyEvent = event.getIf<sf::Event::KeyPressed>())
         {
-            if (const auto *keyEvent = event->getIf<sf::Event::KeyPressed>())
+            if (keyEvent->code == sf::Keyboard::Key::Escape)
             {
-                if (keyEvent->code == sf::Keyboard::Key::Escape)
-                {
-                    window.close();
-                }
-                else if (keyEvent->code == sf::Keyboard::Key::R)
+                window.close();
+            }
+            else if (keyEvent->code == sf::Keyboard::Key::R)
+            {
+                board.reset();
+            }
+            else if (keyEvent->code == sf::Keyboard::Key::H)
+            {
+                // Podpowiedź jest już policzona w tle - tylko ją pokazujemy
+                if (auto hint = hintEngine.getHint(board.getStateVersion()))
                 {
-                    board.reset();
+                    board.showHint(*hint);
                 }
             }
+            else if (keyEvent->code == sf::Keyboard::Key::P)
+            {
+                loadNextPuzzle();
+            }
+            else if (keyEvent->code == sf::Keyboard::Key::T)
+            {
+                setTurbo(!turboBoard);
+            }
+            else if (keyEvent->code == sf::Keyboard::Key::W)
+            {
+                toggleWall();
+            }
+            else if (keyEvent->code == sf::Keyboard::Key::G)
+            {
+                toggleHugeBoard();
+            }
+            else if (keyEvent->code == sf::Keyboard::Key::Z && !wall && !turboBoard)
+            {
+                board.undo();
+            }
+            else if (keyEvent->code == sf::Keyboard::Key::Y && !wall && !turboBoard)
+            {
+                board.redo();
+            }
         }
-        
-        if (event->is<sf::Event::MouseButtonPressed>())
+    }
+    
+    if (const auto *moveEvent = event.getIf<sf::Event::MouseMoved>())
+    {
+        if (!wall && !turboBoard)
+            board.handleMouseMove(static_cast<float>(moveEvent->position.x), static_cast<float>(moveEvent->position.y));
+    }
+
+    if (event.is<sf::Event::MouseButtonPressed>())
+    {
+        if (const auto *mouseEvent = event.getIf<sf::Event::MouseButtonPressed>())
         {
-            if (const auto *mouseEvent = event->getIf<sf::Event::MouseButtonPressed>())
+            if (mouseEvent->button == sf::Mouse::Button::Left)
             {
-                if (mouseEvent->button == sf::Mouse::Button::Left)
+                // Sprawdź czy gra się nie skończyła (na ścianie i w turbo plansza gracza jest ukryta)
+                if (!board.isGameOver() && !wall && !turboBoard)
                 {
-                    // Sprawdź czy gra się nie skończyła
-                    if (!board.isGameOver())
-                    {
-                        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-                        board.handleMouseClick(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y));
-                    }
+                    // Pozycja z chwili kliknięcia, nie z chwili obsługi zdarzenia
+                    latency.received();
+                    unsigned long version = board.getStateVersion();
+                    board.handleMouseClick(static_cast<float>(mouseEvent->position.x),
+                                           static_cast<float>(mouseEvent->position.y));
+                    latency.handled(board.getStateVersion() != version);
                 }
             }
         }
@@ -64,12 +160,274 @@ void Game::handleEvents()
 
 void Game::update()
 {
-    board.update(); // Aktualizuj logikę planszy (miganie itp.)
+    if (hugeBoard)
+    {
+        window.setTitle("Kulki Game - huge: score " + std::to_string(hugeBoard->getScore()) +
+                        ", balls " + std::to_string(hugeBoard->getBallCount()) +
+                        ", visible chunks " + std::to_string(hugeView->getLastVisibleChunks()) +
+                        (hugeBoard->isGameOver() ? " - GAME OVER" : ""));
+        return;
+    }
+
+    if (wall)
+    {
+        // Symulacja dostaje część klatki, reszta zostaje na rysowanie
+        wall->update(sf::milliseconds(8));
+
+        float seconds = wallStatsClock.getElapsedTime().asSeconds();
+        if (seconds >= 1.0f)
+        {
+            window.setTitle("Kulki Game - wall: " + std::to_string(wall->size()) + " games, " +
+                            std::to_string(static_cast<int>(wall->takeMovesPlayed() / seconds)) + " moves/s, " +
+                            std::to_string(static_cast<int>(wall->takeCellsUpdated() / seconds)) + " cells/s redrawn");
+            wallStatsClock.restart();
+        }
+        return;
+    }
+
+    if (turboBoard)
+        playTurbo();
+    else
+    {
+        board.update(); // Aktualizuj logikę planszy (miganie itp.)
+        updateHintAnalysis();
+        recordResult();
+    }
+
+    // Zmiany z całej klatki idą do widzów jednym zapisem
+    if (stream.sinkCount() > 0)
+        stream.flush();
+}
+
+void Game::recordResult()
+{
+    if (!resultsReady)
+        return;
+    if (!bestShown)
+    {
+        board.setPersonalBest(results.best(0));
+        bestShown = true;
+    }
+
+    // Gra się zmieniła (nowa gra, wznowienie) - jej najlepsze zakończenie idzie do bazy
+    if (finishedGame != 0 && finishedGame != board.getGameNumber())
+        storeFinished();
+
+    // Jeden wynik na grę: po cofnięciu i ponownym zakończeniu zostaje lepszy, nie oba
+    if (!board.isGameOver() || board.isPuzzleMode())
+        return;
+    if (finishedGame == board.getGameNumber() && board.getScore() <= finishedResult.score)
+        return;
+
+    finishedResult = ResultRecord();
+    finishedResult.score = board.getScore();
+    finishedResult.turns = static_cast<std::uint32_t>(board.getTurn());
+    finishedResult.seed = board.getGameSeed(); // GameVerifier odtwarza grę od tego ziarna
+    finishedResult.timestamp = static_cast<std::int64_t>(std::time(nullptr)); // Chwila zakończenia, nie zapisu
+    finishedGame = board.getGameNumber();
+    board.setPersonalBest(std::max(results.best(0), finishedResult.score));
+}
+
+void Game::storeFinished()
+{
+    if (finishedGame == 0)
+        return;
+    // append() tylko dopisuje do kolejki - zapis na dysk robi wątek bazy
+    results.append(finishedResult);
+    finishedGame = 0;
+    board.setPersonalBest(results.best(0));
+}
+
+bool Game::recordInput(const std::string& path)
+{
+    inputLog.open(path);
+    if (!inputLog)
+    {
+        std::cerr << "Nie można zapisać nagrania: " << path << std::endl;
+        return false;
+    }
+
+    // Nowa gra ze znanym ziarnem - odtworzenie zacznie z tej samej planszy
+    unsigned int seed = std::random_device{}();
+    board.reset(seed);
+    inputLog << "seed " << seed << '\n';
+    return true;
+}
+
+void Game::toggleWall()
+{
+    if (wall)
+    {
+        wall.reset();
+        window.setTitle("Kulki Game");
+        return;
+    }
+
+    wall = std::make_unique<BoardWall>(8, 8);
+    wall->layout(10.0f, 10.0f, 780.0f, 580.0f);
+    wallStatsClock.restart();
+}
+
+void Game::toggleHugeBoard()
+{
+    if (hugeBoard)
+    {
+        hugeView.reset();
+        hugeBoard.reset();
+        window.setTitle("Kulki Game");
+        return;
+    }
+
+    hugeBoard = std::make_unique<HugeBoard>(1000, 1000, std::random_device{}());
+    hugeView = std::make_unique<HugeBoardView>(*hugeBoard, sf::FloatRect({0.0f, 0.0f}, {800.0f, 600.0f}));
+}
+
+bool Game::handleHugeBoardEvent(const sf::Event& event)
+{
+    // Strzałki przesuwają kamerę, kółko myszy przybliża, klik jak na zwykłej planszy
+    if (const auto* keyEvent = event.getIf<sf::Event::KeyPressed>())
+    {
+        const float step = 100.0f;
+        switch (keyEvent->code)
+        {
+            case sf::Keyboard::Key::Left: hugeView->pan(-step, 0.0f); return true;
+            case sf::Keyboard::Key::Right: hugeView->pan(step, 0.0f); return true;
+            case sf::Keyboard::Key::Up: hugeView->pan(0.0f, -step); return true;
+            case sf::Keyboard::Key::Down: hugeView->pan(0.0f, step); return true;
+            case sf::Keyboard::Key::R: hugeBoard->reset(); return true;
+            default: return false;
+        }
+    }
+    if (const auto* wheelEvent = event.getIf<sf::Event::MouseWheelScrolled>())
+    {
+        hugeView->zoom(wheelEvent->delta > 0 ? 1.25f : 0.8f,
+                       {static_cast<float>(wheelEvent->position.x), static_cast<float>(wheelEvent->position.y)});
+        return true;
+    }
+    if (const auto* mouseEvent = event.getIf<sf::Event::MouseButtonPressed>())
+    {
+        if (mouseEvent->button == sf::Mouse::Button::Left)
+            hugeView->handleClick({static_cast<float>(mouseEvent->position.x), static_cast<float>(mouseEvent->position.y)});
+        return true;
+    }
+    return false;
+}
+
+void Game::addSpectator(int fd)
+{
+    if (stream.sinkCount() == 0)
+        board.addObserver(&stream);
+    stream.addSink(fd);
+}
+
+void Game::setTurbo(bool enabled)
+{
+    turboMoves = 0;
+    turboStatsClock.restart();
+
+    if (enabled)
+    {
+        // Bot dostaje świeżą planszę bez pliku bieżącej gry i widzów; gra gracza czeka na wyłączenie turbo
+        turboBoard = std::make_unique<Board>(board.getWidth(), board.getHeight());
+        turboBoard->setTurbo(true);
+        hintEngine.cancel();
+    }
+    else
+    {
+        turboBoard.reset();
+        analyzedVersion = 0;
+        window.setTitle("Kulki Game");
+    }
+}
+
+void Game::playTurbo()
+{
+    // Grając tylko część klatki, zostawiamy czas na obsługę zdarzeń i rysowanie
+    sf::Clock frameBudget;
+    while (frameBudget.getElapsedTime().asMilliseconds() < 12)
+    {
+        if (turboBoard->isGameOver())
+        {
+            turboBoard->reset();
+            continue;
+        }
+
+        Move move = SelfPlay::chooseMove(turboBoard->snapshot(), botRng);
+        if (move.fromX < 0)
+        {
+            turboBoard->reset();
+            continue;
+        }
+
+        turboBoard->moveBall(move.fromX, move.fromY, move.toX, move.toY);
+        turboBoard->settleAnimations();
+        turboMoves++;
+    }
+
+    float seconds = turboStatsClock.getElapsedTime().asSeconds();
+    if (seconds >= 1.0f)
+    {
+        window.setTitle("Kulki Game - turbo: " + std::to_string(static_cast<int>(turboMoves / seconds)) + " moves/s");
+        turboMoves = 0;
+        turboStatsClock.restart();
+    }
+}
+
+void Game::updateHintAnalysis()
+{
+    unsigned long version = board.getStateVersion();
+    if (version == analyzedVersion)
+        return;
+
+    if (board.isSettled())
+    {
+        // Plansza się ustabilizowała - analizuj w tle, póki gracz myśli
+        hintEngine.analyze(board.snapshot(), version);
+        analyzedVersion = version;
+    }
+    else
+    {
+        // Ruch lub animacja linii w toku - poprzednia analiza jest nieaktualna
+        hintEngine.cancel();
+    }
+}
+
+void Game::loadNextPuzzle()
+{
+    // Zagadki z pliku wygenerowanego przez --puzzles
+    if (puzzles.empty())
+        puzzles = PuzzleBank::load("puzzles.kpz");
+    if (puzzles.empty())
+        return;
+
+    board.loadPuzzle(puzzles[nextPuzzle % puzzles.size()]);
+    nextPuzzle++;
 }
 
 void Game::render()
 {
-    window.clear(sf::Color::Black);
-    board.draw(window);
-    window.display();
+    sf::RenderTarget& target = offscreen ? static_cast<sf::RenderTarget&>(frame) : window;
+    target.clear(sf::Color::Black);
+    if (hugeView)
+        hugeView->draw(target);
+    else if (wall)
+        wall->draw(target);
+    else if (turboBoard)
+        turboBoard->draw(target);
+    else
+        board.draw(target);
+    if (offscreen)
+        frame.display();
+    else
+        window.display();
+    latency.presented();
+    frameIndex++;
+
+    if (!firstFrameShown && !offscreen)
+    {
+        // Pierwsza klatka obejmuje też wypiekanie atlasów czcionki dla HUD
+        firstFrameShown = true;
+        std::cout << "Start: okno i plansza " << constructedAt.asMilliseconds() << " ms, pierwsza klatka "
+                  << startupClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+    }
 }
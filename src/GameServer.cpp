@@ -0,0 +1,479 @@
+#include "../include/GameServer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    // Znacznik gniazda nasłuchującego w epoll_event.data.u32
+    const std::uint32_t ListenTag = 0xFFFFFFFFu;
+    const size_t LatencyBuckets = 100000; // Do 100 ms, dalej ostatni przedział
+    const size_t MaxPendingOutput = 1 << 20;
+    const size_t MaxPooledOutput = 64 * 1024;
+
+    std::uint64_t nowMicros()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+GameServer::GameServer(const std::string& path, int w, int h, size_t hot)
+    : socketPath(path), width(w), height(h), hotLimit(1), hotSessions(std::max<size_t>(1, hot)), listenFd(-1),
+      running(false), nextSeed(1)
+{
+}
+
+GameServer::~GameServer()
+{
+    for (auto& shard : shards)
+    {
+        for (auto& session : shard->sessions)
+        {
+            if (session.fd >= 0)
+                ::close(session.fd);
+        }
+        if (shard->epollFd >= 0)
+            ::close(shard->epollFd);
+    }
+    if (listenFd >= 0)
+    {
+        ::close(listenFd);
+        ::unlink(socketPath.c_str());
+    }
+}
+
+int GameServer::run(int threads)
+{
+    threads = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+    hotLimit = std::max<size_t>(1, hotSessions / threads);
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Za długa ścieżka gniazda: " << socketPath << std::endl;
+        return 1;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    ::unlink(socketPath.c_str());
+    if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0)
+    {
+        std::cerr << "Nie można nasłuchiwać na " << socketPath << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    for (int i = 0; i < threads; ++i)
+    {
+        shards.push_back(std::make_unique<Shard>());
+        Shard& shard = *shards.back();
+        shard.epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        shard.latencyMicros.assign(LatencyBuckets, 0);
+
+        // EPOLLEXCLUSIVE: nowe połączenie budzi jeden wątek, nie wszystkie
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.u32 = ListenTag;
+        if (shard.epollFd < 0 || ::epoll_ctl(shard.epollFd, EPOLL_CTL_ADD, listenFd, &event) != 0)
+        {
+            std::cerr << "epoll: " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Serwer na " << socketPath << ", wątki: " << threads << std::endl;
+
+    running = true;
+    std::vector<std::thread> workers;
+    for (auto& shard : shards)
+        workers.emplace_back([this, &shard]() { workerLoop(*shard); });
+    for (auto& worker : workers)
+        worker.join();
+
+    printStats();
+    return 0;
+}
+
+void GameServer::workerLoop(Shard& shard)
+{
+    epoll_event events[256];
+    auto lastStats = std::chrono::steady_clock::now();
+
+    while (running)
+    {
+        int count = ::epoll_wait(shard.epollFd, events, 256, 100);
+        for (int i = 0; i < count; ++i)
+        {
+            std::uint32_t index = events[i].data.u32;
+            if (index == ListenTag)
+            {
+                acceptConnections(shard);
+                continue;
+            }
+
+            // Sesja mogła zostać zamknięta wcześniej w tej samej porcji zdarzeń
+            if (shard.sessions[index].fd < 0)
+                continue;
+
+            if (events[i].events & EPOLLOUT)
+            {
+                if (!flushSession(shard, index))
+                    continue;
+            }
+            // Przy EPOLLHUP/EPOLLERR read() zwróci 0 albo błąd i sesja zostanie zamknięta
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                handleReadable(shard, index);
+        }
+
+        // Statystyki co 10 s wypisuje pierwszy wątek
+        if (&shard == shards.front().get() && std::chrono::steady_clock::now() - lastStats > std::chrono::seconds(10))
+        {
+            printStats();
+            lastStats = std::chrono::steady_clock::now();
+        }
+    }
+}
+
+void GameServer::acceptConnections(Shard& shard)
+{
+    while (true)
+    {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return; // EAGAIN - połączenie przejął inny wątek albo kolejka pusta
+
+        std::uint32_t index;
+        if (!shard.freeList.empty())
+        {
+            index = shard.freeList.back();
+            shard.freeList.pop_back();
+        }
+        else
+        {
+            index = static_cast<std::uint32_t>(shard.sessions.size());
+            shard.sessions.emplace_back();
+        }
+
+        // Nowa gra w obudzonej sesji z puli - bufory zostają z poprzedniego połączenia
+        std::uint32_t slot = acquireHot(shard);
+        HotSession& live = *shard.hot[slot];
+        live.protocol.reset(nextSeed++);
+        live.input.clear();
+        live.outputSent = 0;
+        live.closing = false;
+        live.session = index;
+        linkNewest(shard, slot);
+
+        shard.sessions[index].fd = fd;
+        shard.sessions[index].hot = slot;
+        {
+            std::lock_guard<std::mutex> lock(shard.statsMutex);
+            shard.active++;
+            shard.pooled = shard.sessions.size();
+            shard.awake = shard.hot.size() - shard.freeHot.size();
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = index;
+        ::epoll_ctl(shard.epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+
+GameServer::HotSession& GameServer::wake(Shard& shard, std::uint32_t index)
+{
+    Session& session = shard.sessions[index];
+    if (session.hot != NoHot)
+    {
+        // Już obudzona - tylko na początek listy LRU
+        unlinkHot(shard, session.hot);
+        linkNewest(shard, session.hot);
+        return *shard.hot[session.hot];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::uint32_t slot = acquireHot(shard);
+    HotSession& live = *shard.hot[slot];
+    live.protocol.restore(session.sleeping);
+    live.input.clear();
+    live.outputSent = 0;
+    live.closing = false;
+    live.session = index;
+    session.hot = slot;
+    linkNewest(shard, slot);
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(shard.statsMutex);
+    shard.wakeups++;
+    shard.wakeNanos += static_cast<std::uint64_t>(nanos);
+    shard.awake = shard.hot.size() - shard.freeHot.size();
+    return live;
+}
+
+std::uint32_t GameServer::acquireHot(Shard& shard)
+{
+    if (shard.hot.size() - shard.freeHot.size() >= hotLimit)
+    {
+        // Limit obudzonych: usypiamy najdawniej używaną sesję, która nie jest w trakcie komendy
+        for (std::uint32_t slot = shard.oldest; slot != NoHot; slot = shard.hot[slot]->newer)
+        {
+            HotSession& candidate = *shard.hot[slot];
+            Session& owner = shard.sessions[candidate.session];
+            if (candidate.closing || !candidate.input.empty() || !candidate.protocol.hibernate(owner.sleeping))
+                continue;
+
+            owner.hot = NoHot;
+            unlinkHot(shard, slot);
+            return slot;
+        }
+        // Wszystkie zajęte - chwilowo ponad limit
+    }
+
+    if (!shard.freeHot.empty())
+    {
+        std::uint32_t slot = shard.freeHot.back();
+        shard.freeHot.pop_back();
+        return slot;
+    }
+    shard.hot.push_back(std::make_unique<HotSession>(width, height, 0));
+    return static_cast<std::uint32_t>(shard.hot.size() - 1);
+}
+
+void GameServer::releaseHot(Shard& shard, std::uint32_t index)
+{
+    Session& session = shard.sessions[index];
+    if (session.hot == NoHot)
+        return;
+    unlinkHot(shard, session.hot);
+    shard.freeHot.push_back(session.hot);
+    session.hot = NoHot;
+}
+
+void GameServer::unlinkHot(Shard& shard, std::uint32_t slot)
+{
+    HotSession& live = *shard.hot[slot];
+    if (live.newer != NoHot)
+        shard.hot[live.newer]->older = live.older;
+    else
+        shard.newest = live.older;
+    if (live.older != NoHot)
+        shard.hot[live.older]->newer = live.newer;
+    else
+        shard.oldest = live.newer;
+    live.newer = live.older = NoHot;
+}
+
+void GameServer::linkNewest(Shard& shard, std::uint32_t slot)
+{
+    HotSession& live = *shard.hot[slot];
+    live.older = shard.newest;
+    live.newer = NoHot;
+    if (shard.newest != NoHot)
+        shard.hot[shard.newest]->newer = slot;
+    shard.newest = slot;
+    if (shard.oldest == NoHot)
+        shard.oldest = slot;
+}
+
+void GameServer::handleReadable(Shard& shard, std::uint32_t index)
+{
+    Session& session = shard.sessions[index];
+    HotSession& live = wake(shard, index);
+    char buffer[16384];
+
+    while (!live.closing)
+    {
+        ssize_t received = ::read(session.fd, buffer, sizeof(buffer));
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            closeSession(shard, index);
+            return;
+        }
+        if (received < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        // Linie przetwarzane wprost z bufora odczytu; kopiowany jest tylko niepełny koniec
+        std::uint64_t start = nowMicros();
+        int moves = 0;
+        std::string_view data(buffer, static_cast<size_t>(received));
+        while (!data.empty() && !live.closing)
+        {
+            size_t newline = data.find('\n');
+            if (newline == std::string_view::npos)
+            {
+                live.input.append(data.data(), data.size());
+                break;
+            }
+
+            std::string_view line = data.substr(0, newline);
+            data.remove_prefix(newline + 1);
+            if (!live.input.empty())
+            {
+                live.input.append(line.data(), line.size());
+                line = live.input;
+            }
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+
+            if (line.compare(0, 5, "move ") == 0)
+                moves++;
+            if (!live.protocol.handleCommand(line))
+                live.closing = true;
+            live.input.clear();
+        }
+
+        if (!flushSession(shard, index))
+            return;
+        recordLatency(shard, nowMicros() - start, moves);
+
+        // Klient nie odbiera odpowiedzi - flushSession zdjął EPOLLIN, czytanie wróci, gdy zaległość spadnie
+        if (live.protocol.output().size() - live.outputSent > MaxPendingOutput)
+            return;
+    }
+
+    if (live.closing && live.protocol.output().size() == live.outputSent)
+        closeSession(shard, index);
+}
+
+bool GameServer::flushSession(Shard& shard, std::uint32_t index)
+{
+    Session& session = shard.sessions[index];
+    if (session.hot == NoHot)
+    {
+        // Uśpiona sesja nie ma nic do wysłania
+        updateInterest(shard, index, false);
+        return true;
+    }
+    HotSession& live = *shard.hot[session.hot];
+    std::string& output = live.protocol.output();
+
+    while (live.outputSent < output.size())
+    {
+        ssize_t sent = ::send(session.fd, output.data() + live.outputSent,
+                              output.size() - live.outputSent, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                // Ponad limit zaległości nie czytamy nowych komend (epoll jest poziomowy - samo
+                // wyjście z handleReadable nic by nie dało); EPOLLOUT opróżni bufor i przywróci EPOLLIN
+                updateInterest(shard, index, true, output.size() - live.outputSent <= MaxPendingOutput);
+                return true;
+            }
+            closeSession(shard, index);
+            return false;
+        }
+        live.outputSent += static_cast<size_t>(sent);
+    }
+
+    output.clear();
+    live.outputSent = 0;
+    if (output.capacity() > MaxPooledOutput)
+        output.shrink_to_fit(); // Jedna duża odpowiedź nie powinna zajmować pamięci sesji na zawsze
+    updateInterest(shard, index, false);
+
+    if (live.closing)
+    {
+        closeSession(shard, index);
+        return false;
+    }
+    return true;
+}
+
+void GameServer::updateInterest(Shard& shard, std::uint32_t index, bool wantWrite, bool wantRead)
+{
+    // EPOLLHUP i EPOLLERR epoll zgłasza zawsze, więc rozłączenie wstrzymanej sesji też ją zamknie
+    epoll_event event{};
+    event.events = (wantRead ? EPOLLIN : 0u) | (wantWrite ? EPOLLOUT : 0u);
+    event.data.u32 = index;
+    ::epoll_ctl(shard.epollFd, EPOLL_CTL_MOD, shard.sessions[index].fd, &event);
+}
+
+void GameServer::closeSession(Shard& shard, std::uint32_t index)
+{
+    Session& session = shard.sessions[index];
+    if (session.fd < 0)
+        return;
+
+    ::epoll_ctl(shard.epollFd, EPOLL_CTL_DEL, session.fd, nullptr);
+    ::close(session.fd);
+    session.fd = -1;
+    releaseHot(shard, index);
+    shard.freeList.push_back(index);
+
+    std::lock_guard<std::mutex> lock(shard.statsMutex);
+    shard.active--;
+    shard.awake = shard.hot.size() - shard.freeHot.size();
+}
+
+void GameServer::recordLatency(Shard& shard, std::uint64_t micros, int count)
+{
+    // Każdy ruch z tego odczytu czekał na odpowiedź tyle, co cała paczka
+    if (count == 0)
+        return;
+    size_t bucket = std::min<std::uint64_t>(micros, LatencyBuckets - 1);
+    std::lock_guard<std::mutex> lock(shard.statsMutex);
+    shard.latencyMicros[bucket] += count;
+    shard.moves += count;
+}
+
+void GameServer::printStats()
+{
+    std::vector<std::uint64_t> histogram(LatencyBuckets, 0);
+    std::uint64_t moves = 0;
+    size_t active = 0;
+    size_t pooled = 0;
+    size_t awake = 0;
+    std::uint64_t wakeups = 0;
+    std::uint64_t wakeNanos = 0;
+    for (const auto& shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->statsMutex);
+        for (size_t i = 0; i < LatencyBuckets; ++i)
+            histogram[i] += shard->latencyMicros[i];
+        moves += shard->moves;
+        active += shard->active;
+        pooled += shard->pooled;
+        awake += shard->awake;
+        wakeups += shard->wakeups;
+        wakeNanos += shard->wakeNanos;
+    }
+
+    auto percentile = [&](double p) {
+        std::uint64_t target = static_cast<std::uint64_t>(moves * p);
+        std::uint64_t seen = 0;
+        for (size_t i = 0; i < LatencyBuckets; ++i)
+        {
+            seen += histogram[i];
+            if (seen > target)
+                return i;
+        }
+        return LatencyBuckets - 1;
+    };
+
+    std::cout << "Sesje: " << active << " aktywne (" << awake << " obudzone, " << active - std::min(active, awake)
+              << " uśpione po " << sizeof(Session) << " B), " << pooled << " w pulach, ruchy: " << moves;
+    if (moves > 0)
+        std::cout << ", opóźnienie p50 " << percentile(0.50) << " us, p99 " << percentile(0.99) << " us";
+    if (wakeups > 0)
+        std::cout << ", budzenie śr. " << wakeNanos / wakeups / 1000.0 << " us";
+    std::cout << std::endl;
+}
@@ -0,0 +1,194 @@
+#include "../include/GameVerifier.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    // Gry rozdawane wątkom paczkami - jeden licznik atomowy na paczkę, nie na grę
+    const size_t GamesPerChunk = 64;
+
+    const char* verdictName(Verification::Verdict verdict)
+    {
+        switch (verdict)
+        {
+            case Verification::Valid: return "poprawna";
+            case Verification::IllegalMove: return "nielegalny ruch";
+            case Verification::MoveAfterEnd: return "ruch po końcu gry";
+            case Verification::ScoreMismatch: return "inny wynik";
+        }
+        return "";
+    }
+}
+
+void GameBatch::add(std::uint32_t seed, std::int32_t claimedScore, const std::vector<Move>& gameMoves)
+{
+    seeds.push_back(seed);
+    claimedScores.push_back(claimedScore);
+    moves.insert(moves.end(), gameMoves.begin(), gameMoves.end());
+    moveStart.push_back(static_cast<std::uint32_t>(moves.size()));
+}
+
+void GameBatch::clear()
+{
+    seeds.clear();
+    claimedScores.clear();
+    moveStart.assign(1, 0);
+    moves.clear();
+}
+
+GameVerifier::GameVerifier(int width, int height, const GameRules& rules) : width(width), height(height), rules(rules)
+{
+}
+
+Verification GameVerifier::verifyGame(const GameBatch& batch, size_t index, HeadlessGame& game) const
+{
+    Verification result;
+    game.reset(batch.seeds[index]);
+
+    const std::uint32_t first = batch.moveStart[index];
+    const std::uint32_t last = batch.moveStart[index + 1];
+    for (std::uint32_t m = first; m < last; ++m)
+    {
+        if (game.isGameOver())
+        {
+            result.verdict = Verification::MoveAfterEnd;
+            result.move = static_cast<std::int32_t>(m - first);
+            break;
+        }
+        // playMove sprawdza ruch przez canMoveTo i nie zmienia stanu, gdy jest nielegalny
+        if (!game.playMove(batch.moves[m]))
+        {
+            result.verdict = Verification::IllegalMove;
+            result.move = static_cast<std::int32_t>(m - first);
+            break;
+        }
+    }
+
+    result.score = game.getScore();
+    if (result.verdict == Verification::Valid && result.score != batch.claimedScores[index])
+        result.verdict = Verification::ScoreMismatch;
+    return result;
+}
+
+long GameVerifier::verify(const GameBatch& batch, std::vector<Verification>& results, int threads) const
+{
+    results.resize(batch.size());
+    size_t chunks = (batch.size() + GamesPerChunk - 1) / GamesPerChunk;
+    threads = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = static_cast<int>(std::max<size_t>(1, std::min<size_t>(std::max(threads, 1), chunks)));
+
+    std::atomic<size_t> nextChunk(0);
+    std::atomic<long> movesPlayed(0);
+    auto worker = [&] {
+        // Jedna plansza na wątek przez cały przebieg; reset(ziarno) tylko ją czyści
+        HeadlessGame game(width, height, 0);
+        game.setRules(rules);
+        long moves = 0;
+        size_t chunk;
+        while ((chunk = nextChunk.fetch_add(1)) < chunks)
+        {
+            size_t end = std::min(batch.size(), (chunk + 1) * GamesPerChunk);
+            for (size_t i = chunk * GamesPerChunk; i < end; ++i)
+            {
+                results[i] = verifyGame(batch, i, game);
+                moves += results[i].move >= 0 ? results[i].move : batch.moveStart[i + 1] - batch.moveStart[i];
+            }
+        }
+        movesPlayed += moves;
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& thread : workers)
+        thread.join();
+    return movesPlayed;
+}
+
+bool GameVerifier::loadBatch(const std::string& path, GameBatch& batch)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::cerr << "Nie można otworzyć pliku z grami: " << path << std::endl;
+        return false;
+    }
+
+    batch.clear();
+    std::string text;
+    std::vector<Move> moves;
+    int lineNumber = 0;
+    while (std::getline(in, text))
+    {
+        lineNumber++;
+        text = text.substr(0, text.find('#'));
+        std::istringstream line(text);
+        std::uint32_t seed;
+        std::int32_t score;
+        if (!(line >> seed))
+            continue;
+
+        bool ok = static_cast<bool>(line >> score);
+        moves.clear();
+        Move move;
+        while (ok && line >> move.fromX)
+        {
+            ok = static_cast<bool>(line >> move.fromY >> move.toX >> move.toY);
+            moves.push_back(move);
+        }
+        if (!ok || !line.eof())
+        {
+            std::cerr << path << ":" << lineNumber << ": oczekiwano <ziarno> <wynik> i czwórek współrzędnych" << std::endl;
+            return false;
+        }
+        batch.add(seed, score, moves);
+    }
+    return true;
+}
+
+int GameVerifier::run(const std::string& path, int threads)
+{
+    GameBatch batch;
+    if (!loadBatch(path, batch))
+        return 1;
+
+    GameVerifier verifier;
+    std::vector<Verification> results;
+    auto startTime = std::chrono::steady_clock::now();
+    long moves = verifier.verify(batch, results, threads);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    int counts[4] = {0, 0, 0, 0};
+    for (const Verification& result : results)
+        counts[result.verdict]++;
+
+    std::cout << "Gry: " << batch.size() << ", poprawne: " << counts[Verification::Valid]
+              << ", nielegalny ruch: " << counts[Verification::IllegalMove]
+              << ", ruch po końcu gry: " << counts[Verification::MoveAfterEnd]
+              << ", inny wynik: " << counts[Verification::ScoreMismatch] << std::endl;
+    std::cout << "Ruchy: " << moves << ", ruchów/s: " << static_cast<long>(moves / std::max(seconds, 1e-9))
+              << ", czas: " << seconds << " s" << std::endl;
+
+    // Kilka pierwszych odrzuconych gier z miejscem rozbieżności
+    int shown = 0;
+    for (size_t i = 0; i < results.size() && shown < 10; ++i)
+    {
+        const Verification& result = results[i];
+        if (result.verdict == Verification::Valid)
+            continue;
+        std::cout << "  gra " << i << " (ziarno " << batch.seeds[i] << "): " << verdictName(result.verdict);
+        if (result.move >= 0)
+            std::cout << " w ruchu " << result.move;
+        else
+            std::cout << ", odtworzony " << result.score << " zamiast " << batch.claimedScores[i];
+        std::cout << std::endl;
+        shown++;
+    }
+    return counts[Verification::Valid] == static_cast<int>(batch.size()) ? 0 : 2;
+}
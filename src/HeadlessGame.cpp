@@ -0,0 +1,342 @@
+#include "../include/HeadlessGame.hpp"
+#include <algorithm>
+
+HeadlessGame::HeadlessGame(int w, int h, unsigned int seed)
+    : state(w, h), rng(seed), colorDist(0, 5), ballsToAdd(2), turn(0), gameOver(false), linesClean(false), ballCount(0)
+{
+    board.resize(w, h);
+    reset();
+}
+
+int GameRules::pointsForClear(int removed, int combo) const
+{
+    int points = pointsPerBall * combo * removed;
+    if (removed >= lineLength)
+    {
+        int bonus = (removed - lineLength + 1) * lengthBonus * combo;
+        points += 2 * bonus;
+    }
+    return points;
+}
+
+void HeadlessGame::setRules(const GameRules& newRules)
+{
+    rules = newRules;
+    colorDist = std::uniform_int_distribution<int>(0, rules.colors - 1);
+    state.lineLength = rules.lineLength;
+}
+
+void HeadlessGame::reset()
+{
+    std::fill(state.cells.begin(), state.cells.end(), 0);
+    board.clear();
+    state.score = 0;
+    state.combo = 1;
+    ballsToAdd = rules.spawnCount;
+    turn = 0;
+    gameOver = false;
+    linesClean = false;
+    ballCount = 0;
+
+    generateBalls();
+    generateNextBalls();
+}
+
+void HeadlessGame::reset(unsigned int seed)
+{
+    rng = CountingRng(seed);
+    colorDist.reset();
+    reset();
+}
+
+bool HeadlessGame::hibernate(CompactGame& compact) const
+{
+    if (state.width * state.height > CompactGame::MaxCells || state.nextBalls.size() != 2 || rng.draws > UINT32_MAX)
+        return false;
+    // Pola flags: 2 bity na ballsToAdd, 5 bitów na combo - większych wartości nie obcinamy
+    if (ballsToAdd < 0 || ballsToAdd > 3 || state.combo < 1 || state.combo > 32)
+        return false;
+
+    compact = CompactGame{};
+    for (int i = 0; i < state.width * state.height; ++i)
+    {
+        // 3 bity na pole, mogą przechodzić przez granicę bajtu
+        unsigned int bit = static_cast<unsigned int>(i) * 3;
+        unsigned int value = static_cast<unsigned int>(state.cells[i]) << (bit % 8);
+        compact.cells[bit / 8] |= static_cast<std::uint8_t>(value);
+        if (bit % 8 > 5)
+            compact.cells[bit / 8 + 1] |= static_cast<std::uint8_t>(value >> 8);
+    }
+    compact.next = static_cast<std::uint8_t>(static_cast<int>(state.nextBalls[0]) | static_cast<int>(state.nextBalls[1]) << 3);
+    compact.flags = static_cast<std::uint8_t>((gameOver ? 1 : 0) | ballsToAdd << 1 | (state.combo - 1) << 3);
+    compact.score = state.score;
+    compact.turn = static_cast<std::uint32_t>(turn);
+    compact.seed = rng.segmentSeed;
+    compact.draws = static_cast<std::uint32_t>(rng.draws);
+    return true;
+}
+
+bool HeadlessGame::restore(const CompactGame& compact)
+{
+    if (state.width * state.height > CompactGame::MaxCells)
+        return false;
+
+    for (int i = 0; i < state.width * state.height; ++i)
+    {
+        unsigned int bit = static_cast<unsigned int>(i) * 3;
+        unsigned int value = compact.cells[bit / 8] >> (bit % 8);
+        if (bit % 8 > 5)
+            value |= static_cast<unsigned int>(compact.cells[bit / 8 + 1]) << (8 - bit % 8);
+        state.cells[i] = static_cast<int>(value & 7);
+    }
+    board.load(state);
+    ballCount = static_cast<int>(state.cells.size() - std::count(state.cells.begin(), state.cells.end(), 0));
+    linesClean = false;
+    state.nextBalls.assign({static_cast<BallColor>(compact.next & 7), static_cast<BallColor>(compact.next >> 3 & 7)});
+    gameOver = compact.flags & 1;
+    ballsToAdd = compact.flags >> 1 & 3;
+    state.combo = (compact.flags >> 3) + 1;
+    state.score = compact.score;
+    turn = static_cast<int>(compact.turn);
+
+    // Przewijanie tylko wewnątrz bieżącego odcinka generatora - koszt nie rośnie z długością gry
+    rng = CountingRng::resume(compact.seed, compact.draws);
+    return true;
+}
+
+void HeadlessGame::setCell(int x, int y, int value)
+{
+    ballCount += (value != 0) - (state.at(x, y) != 0);
+    state.set(x, y, value);
+    board.set(x, y, value);
+}
+
+bool HeadlessGame::markLines(const int* changed, int count)
+{
+    markedCells.clear();
+    if (!linesClean)
+    {
+        // Pierwsze sprawdzenie w grze - cała plansza; board.marked zeruje potem clearMarked
+        linesClean = true;
+        if (BoardKernels::markLines(board, rules.lineLength) == 0)
+            return false;
+        for (int i = 0; i < board.size(); ++i)
+        {
+            if (board.marked[i] != 0)
+                markedCells.push_back(i);
+        }
+        return true;
+    }
+
+    // Te same pola co BoardKernels::markLines: serie co najmniej lineLength kulek w 4 kierunkach
+    const int offsets[4] = {1, board.stride, board.stride + 1, board.stride - 1};
+    for (int c = 0; c < count; ++c)
+    {
+        std::uint8_t value = board.cells[changed[c]];
+        if (value == 0 || value == KernelBoard::Wall)
+            continue;
+        for (int off : offsets)
+        {
+            // Przekątna z pola (0, 0) wychodzi przed górny rząd ścian - tam nie ma już pola ściany
+            int first = changed[c];
+            while (first - off >= 0 && board.cells[first - off] == value)
+                first -= off;
+            int last = changed[c];
+            while (board.cells[last + off] == value)
+                last += off;
+            if ((last - first) / off + 1 < rules.lineLength)
+                continue;
+            for (int i = first; i <= last; i += off)
+            {
+                if (board.marked[i] == 0)
+                {
+                    board.marked[i] = 0xFF;
+                    markedCells.push_back(i);
+                }
+            }
+        }
+    }
+    return !markedCells.empty();
+}
+
+int HeadlessGame::clearMarked()
+{
+    // Pola zaznaczone przez ostatnie markLines
+    for (int index : markedCells)
+    {
+        setCell(board.xOf(index), board.yOf(index), 0);
+        board.marked[index] = 0;
+    }
+    return static_cast<int>(markedCells.size());
+}
+
+BallColor HeadlessGame::getRandomColor()
+{
+    return static_cast<BallColor>(colorDist(rng));
+}
+
+void HeadlessGame::generateBalls()
+{
+    // Te same losowania co Board::generateBalls
+    std::uniform_real_distribution<float> fillDist(0.0f, 1.0f);
+
+    for (int y = 0; y < state.height; ++y)
+    {
+        for (int x = 0; x < state.width; ++x)
+        {
+            if (fillDist(rng) < rules.fillRate)
+            {
+                setCell(x, y, static_cast<int>(getRandomColor()) + 1);
+            }
+        }
+    }
+}
+
+void HeadlessGame::generateNextBalls()
+{
+    state.nextBalls.clear();
+    for (int i = 0; i < rules.spawnCount; ++i)
+    {
+        state.nextBalls.push_back(getRandomColor());
+    }
+}
+
+bool HeadlessGame::canMoveTo(const Move& move) const
+{
+    if (!state.isValidPosition(move.fromX, move.fromY) || state.at(move.fromX, move.fromY) == 0)
+        return false;
+    if (!state.isEmpty(move.toX, move.toY))
+        return false;
+
+    return BoardKernels::fillReachable(board, board.index(move.fromX, move.fromY), board.index(move.toX, move.toY));
+}
+
+bool HeadlessGame::playMove(const Move& move)
+{
+    if (gameOver || !canMoveTo(move))
+        return false;
+
+    for (auto* observer : observers)
+        observer->onMove(state, move);
+
+    setCell(move.toX, move.toY, state.at(move.fromX, move.fromY));
+    setCell(move.fromX, move.fromY, 0);
+    turn++;
+
+    int moved = board.index(move.toX, move.toY);
+    if (markLines(&moved, 1))
+    {
+        removeLinesAndUpdateScore();
+    }
+    else
+    {
+        state.combo = 1; // Reset combo jeśli nie ma linii
+        addNewBalls();
+
+        if (markLines(spawned.data(), static_cast<int>(spawned.size())))
+            removeLinesAndUpdateScore();
+        else
+            checkGameOver();
+    }
+    return true;
+}
+
+void HeadlessGame::removeLinesAndUpdateScore()
+{
+    // Odpowiednik kolejnych wywołań Board::removeLinesAndUpdateScore po animacjach
+    while (true)
+    {
+        for (auto* observer : observers)
+            observer->onLinesFound(state);
+
+        int removed = clearMarked();
+        int points = rules.pointsForClear(removed, state.combo);
+        state.score += points;
+
+        for (auto* observer : observers)
+            observer->onLinesRemoved(state, removed, points);
+
+        state.combo++;
+
+        // Chain reaction - Board sprawdza tu całą planszę, ale zdjęcie kulek nie tworzy nowych linii,
+        // więc łańcuch może zacząć tylko dołożenie kulek
+        state.combo = 1;
+        addNewBalls();
+
+        if (markLines(spawned.data(), static_cast<int>(spawned.size())))
+            continue;
+
+        checkGameOver();
+        break;
+    }
+}
+
+void HeadlessGame::addNewBalls()
+{
+    spawned.clear();
+    if (gameOver)
+        return;
+
+    // Puste pola wiersz po wierszu - te same co getEmptyPositions, więc tasowanie zużywa te same losowania
+    int emptyCount = BoardKernels::collectEmpty(board);
+    std::uint32_t* emptyPositions = board.empty.data();
+
+    if (emptyCount < ballsToAdd)
+    {
+        ballsToAdd = emptyCount;
+    }
+
+    if (ballsToAdd == 0)
+    {
+        checkGameOver();
+        return;
+    }
+
+    std::shuffle(emptyPositions, emptyPositions + emptyCount, rng);
+
+    int added = 0;
+    for (int i = 0; i < ballsToAdd; ++i)
+    {
+        setCell(board.xOf(emptyPositions[i]), board.yOf(emptyPositions[i]), static_cast<int>(state.nextBalls[i]) + 1);
+        spawned.push_back(static_cast<int>(emptyPositions[i]));
+        added++;
+    }
+
+    generateNextBalls();
+    ballsToAdd = rules.spawnCount;
+
+    if (!observers.empty())
+    {
+        std::vector<std::pair<int, int>> positions;
+        for (int i = 0; i < added; ++i)
+            positions.push_back({board.xOf(emptyPositions[i]), board.yOf(emptyPositions[i])});
+        for (auto* observer : observers)
+            observer->onBallsAdded(state, positions);
+    }
+}
+
+void HeadlessGame::checkGameOver()
+{
+    if (gameOver)
+        return;
+
+    // Liczniki zamiast przeglądania planszy: na spójnej planszy z pustym polem i kulką
+    // jakaś kulka sąsiaduje z pustym polem (to samo co BoardKernels::hasMobileBall)
+    int empty = state.width * state.height - ballCount;
+    if (empty < rules.spawnCount || empty == 0 || ballCount == 0)
+    {
+        gameOver = true;
+        for (auto* observer : observers)
+            observer->onGameOver(state);
+    }
+}
+
+void HeadlessGame::addObserver(BoardObserver* observer)
+{
+    observers.push_back(observer);
+}
+
+void HeadlessGame::removeObserver(BoardObserver* observer)
+{
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
@@ -0,0 +1,194 @@
+#include "../include/Heatmap.hpp"
+#include <algorithm>
+#include <cstdio>
+#include "../include/SoftwareRenderer.hpp"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // Po tylu turach liczniki 32-bitowe trafiają do sum (tura dodaje do pola najwyżej kilka)
+    const std::uint32_t FlushTurns = 1u << 24;
+
+    // Kierunki jak w BoardState::findAllLines: →, ↓, ↘, ↙
+    const int DirectionX[] = {1, 0, 1, -1};
+    const int DirectionY[] = {0, 1, 1, 1};
+
+    // Skala: czarny -> czerwony -> żółty -> biały
+    std::uint32_t heatColor(double t)
+    {
+        t = std::clamp(t, 0.0, 1.0) * 3.0;
+        int r = static_cast<int>(255 * std::min(1.0, t));
+        int g = static_cast<int>(255 * std::clamp(t - 1.0, 0.0, 1.0));
+        int b = static_cast<int>(255 * std::clamp(t - 2.0, 0.0, 1.0));
+        return static_cast<std::uint32_t>(r) | (static_cast<std::uint32_t>(g) << 8) | (static_cast<std::uint32_t>(b) << 16);
+    }
+}
+
+HeatmapCollector::HeatmapCollector(int w, int h)
+    : width(w), height(h), pendingTurns(0), turns(0), games(0)
+{
+    for (int s = 0; s < StatCount; ++s)
+    {
+        counters[s].assign(w * h, 0);
+        totals[s].assign(w * h, 0);
+    }
+}
+
+void HeatmapCollector::onMove(const BoardState& before, const Move&)
+{
+    // Zajętość: licznik += (pole != 0), cztery pola naraz
+    const int* cells = before.cells.data();
+    std::uint32_t* occupancy = counters[Occupancy].data();
+    int count = width * height;
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi32(-1);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + i));
+        __m128i occupied = _mm_xor_si128(_mm_cmpeq_epi32(value, zero), ones); // -1 dla zajętych
+        __m128i counter = _mm_loadu_si128(reinterpret_cast<const __m128i*>(occupancy + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(occupancy + i), _mm_sub_epi32(counter, occupied));
+    }
+#endif
+    for (; i < count; ++i)
+        occupancy[i] += cells[i] != 0;
+
+    lastSpawn.clear();
+    turns++;
+    if (++pendingTurns >= FlushTurns)
+        flush();
+}
+
+void HeatmapCollector::onBallsAdded(const BoardState&, const std::vector<std::pair<int, int>>& positions)
+{
+    for (auto [x, y] : positions)
+    {
+        counters[Spawn][y * width + x]++;
+        lastSpawn.push_back(y * width + x);
+    }
+}
+
+void HeatmapCollector::onLinesFound(const BoardState& before)
+{
+    // Udział w linii osobno dla kierunków - ta sama reguła (>= lineLength) co findAllLines
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (before.at(x, y) == 0)
+                continue;
+            for (int d = 0; d < 4; ++d)
+            {
+                if (before.runLength(x, y, DirectionX[d], DirectionY[d]) >= before.lineLength)
+                    counters[LineH + d][y * width + x]++;
+            }
+        }
+    }
+}
+
+void HeatmapCollector::onGameOver(const BoardState&)
+{
+    for (int index : lastSpawn)
+        counters[GameOver][index]++;
+    lastSpawn.clear();
+    games++;
+}
+
+void HeatmapCollector::flush()
+{
+    for (int s = 0; s < StatCount; ++s)
+    {
+        for (size_t i = 0; i < counters[s].size(); ++i)
+            totals[s][i] += counters[s][i];
+        std::fill(counters[s].begin(), counters[s].end(), 0);
+    }
+    pendingTurns = 0;
+}
+
+void HeatmapCollector::merge(HeatmapCollector& other)
+{
+    flush();
+    other.flush();
+    for (int s = 0; s < StatCount; ++s)
+    {
+        for (size_t i = 0; i < totals[s].size() && i < other.totals[s].size(); ++i)
+            totals[s][i] += other.totals[s][i];
+    }
+    turns += other.turns;
+    games += other.games;
+}
+
+const char* HeatmapCollector::statName(Stat stat)
+{
+    switch (stat)
+    {
+        case Occupancy: return "occupancy";
+        case Spawn: return "spawn";
+        case LineH: return "line_h";
+        case LineV: return "line_v";
+        case LineDiag: return "line_diag";
+        case LineAnti: return "line_anti";
+        case GameOver: return "game_over";
+        default: return "unknown";
+    }
+}
+
+bool HeatmapCollector::writeCSV(const std::string& path)
+{
+    flush();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    std::fprintf(file, "x,y");
+    for (int s = 0; s < StatCount; ++s)
+        std::fprintf(file, ",%s", statName(static_cast<Stat>(s)));
+    std::fprintf(file, ",occupancy_per_turn,spawn_per_turn,line_per_turn,game_over_per_game\n");
+
+    double perTurn = turns > 0 ? 1.0 / turns : 0.0;
+    double perGame = games > 0 ? 1.0 / games : 0.0;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            std::fprintf(file, "%d,%d", x, y);
+            for (int s = 0; s < StatCount; ++s)
+                std::fprintf(file, ",%llu", static_cast<unsigned long long>(value(static_cast<Stat>(s), x, y)));
+
+            std::uint64_t lines = value(LineH, x, y) + value(LineV, x, y) + value(LineDiag, x, y) + value(LineAnti, x, y);
+            std::fprintf(file, ",%.6f,%.6f,%.6f,%.6f\n", value(Occupancy, x, y) * perTurn, value(Spawn, x, y) * perTurn,
+                         lines * perTurn, value(GameOver, x, y) * perGame);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+bool HeatmapCollector::writePPM(const std::string& path, Stat stat, int cellPixels)
+{
+    flush();
+    std::uint64_t maxValue = std::max<std::uint64_t>(1, *std::max_element(totals[stat].begin(), totals[stat].end()));
+
+    Image image;
+    image.resize(width * cellPixels, height * cellPixels);
+    for (int py = 0; py < image.height; ++py)
+    {
+        for (int px = 0; px < image.width; ++px)
+        {
+            double t = static_cast<double>(value(stat, px / cellPixels, py / cellPixels)) / maxValue;
+            image.pixels[py * image.width + px] = heatColor(t);
+        }
+    }
+    return image.writePPM(path);
+}
+
+bool HeatmapCollector::writeAll(const std::string& prefix)
+{
+    bool ok = writeCSV(prefix + ".csv");
+    for (int s = 0; s < StatCount; ++s)
+        ok = writePPM(prefix + "_" + statName(static_cast<Stat>(s)) + ".ppm", static_cast<Stat>(s)) && ok;
+    return ok;
+}
@@ -0,0 +1,216 @@
+#include "../include/HintEngine.hpp"
+#include <algorithm>
+
+namespace
+{
+    // Ile najlepszych ruchów z pierwszego przebiegu sprawdzamy głębiej
+    const size_t kFollowUpCandidates = 24;
+}
+
+HintEngine::HintEngine()
+    : pendingVersion(0), hasPendingJob(false), stopRequested(false),
+      activeVersion(0), bestVersion(0), bestDepth(0)
+{
+    worker = std::thread(&HintEngine::workerLoop, this);
+}
+
+HintEngine::~HintEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+        activeVersion = 0;
+    }
+    wakeUp.notify_one();
+    worker.join();
+}
+
+bool HintEngine::loadNetwork(const std::string& path)
+{
+    return network.load(path);
+}
+
+void HintEngine::analyze(const BoardState& state, unsigned long version)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingState = state;
+        pendingVersion = version;
+        hasPendingJob = true;
+        activeVersion = version; // Przerywa poprzednią analizę
+    }
+    wakeUp.notify_one();
+}
+
+void HintEngine::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    hasPendingJob = false;
+    activeVersion = 0;
+}
+
+std::optional<Move> HintEngine::getHint(unsigned long version)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (bestVersion != version)
+        return std::nullopt;
+    return bestMove;
+}
+
+int HintEngine::getDepth(unsigned long version)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return bestVersion == version ? bestDepth : 0;
+}
+
+void HintEngine::workerLoop()
+{
+    while (true)
+    {
+        BoardState state;
+        unsigned long version;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this] { return stopRequested || hasPendingJob; });
+            if (stopRequested)
+                return;
+
+            state = std::move(pendingState);
+            version = pendingVersion;
+            hasPendingJob = false;
+        }
+
+        search(state, version);
+    }
+}
+
+bool HintEngine::isCancelled(unsigned long version) const
+{
+    return activeVersion.load(std::memory_order_relaxed) != version;
+}
+
+void HintEngine::publish(const Move& move, unsigned long version, int depth)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (activeVersion != version)
+        return; // Wynik dla nieaktualnej planszy
+    bestMove = move;
+    bestVersion = version;
+    bestDepth = depth;
+}
+
+void HintEngine::search(const BoardState& state, unsigned long version)
+{
+    auto moves = state.legalMoves();
+    if (moves.empty())
+        return;
+
+    // Przebieg 1: szybka ocena każdego ruchu
+    std::vector<std::pair<int, size_t>> ranked;
+    ranked.reserve(moves.size());
+    for (size_t i = 0; i < moves.size(); ++i)
+    {
+        if (isCancelled(version))
+            return;
+        ranked.push_back({evaluateMove(state, moves[i]), i});
+    }
+
+    std::sort(ranked.begin(), ranked.end(),
+        [](const auto& a, const auto& b) { return a.first > b.first; });
+    publish(moves[ranked[0].second], version, 1);
+
+    if (network.isLoaded())
+    {
+        applyNetwork(state, moves, ranked, version);
+        if (!isCancelled(version))
+            publish(moves[ranked[0].second], version, 2);
+        return;
+    }
+
+    // Przebieg 2: dla najlepszych kandydatów uwzględnij najlepszy kolejny ruch
+    int bestScore = -1000000;
+    size_t bestIndex = ranked[0].second;
+    size_t candidates = std::min(kFollowUpCandidates, ranked.size());
+    for (size_t i = 0; i < candidates; ++i)
+    {
+        const Move& move = moves[ranked[i].second];
+        int followUp = evaluateFollowUp(state, move, version);
+        if (isCancelled(version))
+            return;
+
+        int total = ranked[i].first + followUp / 2;
+        if (total > bestScore)
+        {
+            bestScore = total;
+            bestIndex = ranked[i].second;
+        }
+    }
+
+    publish(moves[bestIndex], version, 2);
+}
+
+int HintEngine::evaluateMove(const BoardState& state, const Move& move) const
+{
+    // Kara za rozbicie istniejącego ciągu w miejscu startowym
+    int brokenRun = state.longestRunThrough(move.fromX, move.fromY);
+
+    BoardState after = state;
+    after.applyMove(move);
+
+    int removed = after.clearLines();
+    if (removed > 0)
+    {
+        return 1000 + removed * 100;
+    }
+
+    int run = after.longestRunThrough(move.toX, move.toY);
+    return run * run * 10 - brokenRun * brokenRun * 5;
+}
+
+int HintEngine::evaluateFollowUp(const BoardState& state, const Move& move, unsigned long version) const
+{
+    BoardState after = state;
+    after.applyMove(move);
+    after.clearLines();
+
+    int best = 0;
+    for (const auto& next : after.legalMoves())
+    {
+        if (isCancelled(version))
+            return best;
+        best = std::max(best, evaluateMove(after, next));
+    }
+    return best;
+}
+
+void HintEngine::applyNetwork(const BoardState& state, const std::vector<Move>& moves,
+                              std::vector<std::pair<int, size_t>>& ranked, unsigned long version) const
+{
+    // Pozycje po ruchach najlepszych kandydatów oceniamy jedną paczką
+    size_t candidates = std::min(kFollowUpCandidates, ranked.size());
+    std::vector<BoardState> positions;
+    positions.reserve(candidates + 1);
+    positions.push_back(state);
+    for (size_t i = 0; i < candidates; ++i)
+    {
+        BoardState after = state;
+        after.applyMove(moves[ranked[i].second]);
+        after.clearLines();
+        positions.push_back(std::move(after));
+    }
+
+    std::vector<Evaluation> evals;
+    network.evaluateBatch(positions, evals);
+    if (isCancelled(version))
+        return;
+
+    for (size_t i = 0; i < candidates; ++i)
+    {
+        const Move& move = moves[ranked[i].second];
+        float policy = NeuralEvaluator::scoreMove(evals[0], move, state.width);
+        ranked[i].first += static_cast<int>(policy * 50.0f + evals[i + 1].value * 500.0f);
+    }
+
+    std::sort(ranked.begin(), ranked.begin() + candidates,
+        [](const auto& a, const auto& b) { return a.first > b.first; });
+}
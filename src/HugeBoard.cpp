@@ -0,0 +1,341 @@
+#include "../include/HugeBoard.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+HugeBoard::HugeBoard(int w, int h, unsigned int seed)
+    : width(w), height(h), chunksX((w + ChunkSize - 1) / ChunkSize), chunksY((h + ChunkSize - 1) / ChunkSize),
+      ballCount(0), rng(seed), colorDist(0, 5), score(0), gameOver(false), currentStamp(0)
+{
+    chunks.resize(static_cast<size_t>(chunksX) * chunksY);
+    reset();
+}
+
+void HugeBoard::reset(float fillRate)
+{
+    for (auto& chunk : chunks)
+        chunk.reset();
+    ballCount = 0;
+    score = 0;
+    gameOver = false;
+
+    // Losowe wypełnienie jak w Board::generateBalls, ale bez gotowych linii -
+    // linie sprawdzane są tylko przez zmienione pola, więc takie zostałyby na zawsze
+    std::uniform_real_distribution<float> fillDist(0.0f, 1.0f);
+    const std::pair<int, int> directions[] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (fillDist(rng) >= fillRate)
+                continue;
+
+            set(x, y, colorDist(rng) + 1);
+            for (auto [dx, dy] : directions)
+            {
+                if (runLength(x, y, dx, dy) >= 3)
+                {
+                    set(x, y, 0);
+                    break;
+                }
+            }
+        }
+    }
+
+    generateNextBalls();
+}
+
+int HugeBoard::at(int x, int y) const
+{
+    const Chunk* chunk = chunks[(y >> ChunkBits) * chunksX + (x >> ChunkBits)].get();
+    if (!chunk)
+        return 0;
+    return chunk->cells[(y & (ChunkSize - 1)) * ChunkSize + (x & (ChunkSize - 1))];
+}
+
+void HugeBoard::set(int x, int y, int value)
+{
+    auto& chunk = chunks[(y >> ChunkBits) * chunksX + (x >> ChunkBits)];
+    if (!chunk)
+    {
+        if (value == 0)
+            return;
+        chunk = std::make_unique<Chunk>();
+    }
+
+    std::uint8_t& cell = chunk->cells[(y & (ChunkSize - 1)) * ChunkSize + (x & (ChunkSize - 1))];
+    int delta = (value != 0) - (cell != 0);
+    if (cell != 0)
+        chunk->colorBalls[cell]--;
+    if (value != 0)
+        chunk->colorBalls[value]++;
+    cell = static_cast<std::uint8_t>(value);
+    chunk->balls += delta;
+    ballCount += delta;
+
+    // Pusty kawałek nie zajmuje pamięci
+    if (chunk->balls == 0)
+        chunk.reset();
+}
+
+int HugeBoard::chunkCapacity(int cx, int cy) const
+{
+    // Kawałki na prawym i dolnym brzegu mogą być przycięte
+    int w = std::min(ChunkSize, width - cx * ChunkSize);
+    int h = std::min(ChunkSize, height - cy * ChunkSize);
+    return w * h;
+}
+
+size_t HugeBoard::allocatedChunks() const
+{
+    return std::count_if(chunks.begin(), chunks.end(), [](const auto& chunk) { return chunk != nullptr; });
+}
+
+int HugeBoard::runLength(int x, int y, int dx, int dy) const
+{
+    int value = at(x, y);
+    if (value == 0)
+        return 0;
+
+    int length = 1;
+    for (int cx = x + dx, cy = y + dy; isValidPosition(cx, cy) && at(cx, cy) == value; cx += dx, cy += dy)
+        length++;
+    for (int cx = x - dx, cy = y - dy; isValidPosition(cx, cy) && at(cx, cy) == value; cx -= dx, cy -= dy)
+        length++;
+    return length;
+}
+
+bool HugeBoard::canMoveTo(int fromX, int fromY, int toX, int toY)
+{
+    if (!isValidPosition(fromX, fromY) || at(fromX, fromY) == 0 || !isEmpty(toX, toY))
+        return false;
+
+    // Dwa BFS naraz - od celu i od pustych sąsiadów kulki - rozwijane na zmianę.
+    // Kończy się, gdy się spotkają albo gdy jedna strona wyczerpie swój obszar,
+    // więc zamknięta kulka albo zamknięty cel nie przeglądają całej planszy.
+    if (visitStamp.empty())
+        visitStamp.assign(static_cast<size_t>(width) * height, 0);
+    if (currentStamp >= 0xFFFFFFF0u)
+    {
+        std::fill(visitStamp.begin(), visitStamp.end(), 0);
+        currentStamp = 0;
+    }
+    const std::uint32_t fromSide = ++currentStamp;
+    const std::uint32_t toSide = ++currentStamp;
+
+    std::vector<int>& forward = queue;
+    backQueue.clear();
+    forward.clear();
+
+    const int start[4][2] = {{fromX, fromY - 1}, {fromX, fromY + 1}, {fromX - 1, fromY}, {fromX + 1, fromY}};
+    for (const auto& n : start)
+    {
+        if (!isEmpty(n[0], n[1]))
+            continue;
+        int index = n[1] * width + n[0];
+        if (index == toY * width + toX)
+            return true;
+        visitStamp[index] = fromSide;
+        forward.push_back(index);
+    }
+    backQueue.push_back(toY * width + toX);
+    visitStamp[backQueue.back()] = toSide;
+
+    // Jeden krok jednej strony; true gdy dotknie drugiej
+    auto step = [this](std::vector<int>& frontier, size_t& head, std::uint32_t own, std::uint32_t other) {
+        int x = frontier[head] % width;
+        int y = frontier[head] / width;
+        head++;
+
+        const int neighbours[4][2] = {{x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+        for (const auto& n : neighbours)
+        {
+            if (!isEmpty(n[0], n[1]))
+                continue;
+            int index = n[1] * width + n[0];
+            if (visitStamp[index] == other)
+                return true;
+            if (visitStamp[index] == own)
+                continue;
+            visitStamp[index] = own;
+            frontier.push_back(index);
+        }
+        return false;
+    };
+
+    size_t forwardHead = 0;
+    size_t backHead = 0;
+    while (forwardHead < forward.size() && backHead < backQueue.size())
+    {
+        if (step(forward, forwardHead, fromSide, toSide) || step(backQueue, backHead, toSide, fromSide))
+            return true;
+    }
+    return false;
+}
+
+int HugeBoard::clearLinesThrough(const std::vector<std::pair<int, int>>& cells)
+{
+    // Najpierw zbieramy wszystkie linie, potem usuwamy - jak Board przy krzyżujących się liniach
+    const std::pair<int, int> directions[] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+    std::vector<std::pair<int, int>> toRemove;
+    for (auto [x, y] : cells)
+    {
+        int value = at(x, y);
+        if (value == 0)
+            continue;
+
+        for (auto [dx, dy] : directions)
+        {
+            if (runLength(x, y, dx, dy) < 3)
+                continue;
+            toRemove.push_back({x, y});
+            for (int cx = x + dx, cy = y + dy; isValidPosition(cx, cy) && at(cx, cy) == value; cx += dx, cy += dy)
+                toRemove.push_back({cx, cy});
+            for (int cx = x - dx, cy = y - dy; isValidPosition(cx, cy) && at(cx, cy) == value; cx -= dx, cy -= dy)
+                toRemove.push_back({cx, cy});
+        }
+    }
+
+    int removed = 0;
+    for (auto [x, y] : toRemove)
+    {
+        if (at(x, y) != 0)
+        {
+            set(x, y, 0);
+            removed++;
+        }
+    }
+    return removed;
+}
+
+bool HugeBoard::randomEmptyCell(int& x, int& y)
+{
+    long long empty = getEmptyCount();
+    if (empty == 0)
+        return false;
+
+    // Przy luźnej planszy wystarczy losować pola do skutku
+    if (empty * 4 >= static_cast<long long>(width) * height)
+    {
+        std::uniform_int_distribution<int> xDist(0, width - 1);
+        std::uniform_int_distribution<int> yDist(0, height - 1);
+        do
+        {
+            x = xDist(rng);
+            y = yDist(rng);
+        } while (at(x, y) != 0);
+        return true;
+    }
+
+    // Gęsta plansza: losowe puste pole wybrane przez liczniki kawałków
+    long long target = std::uniform_int_distribution<long long>(0, empty - 1)(rng);
+    for (int cy = 0; cy < chunksY; ++cy)
+    {
+        for (int cx = 0; cx < chunksX; ++cx)
+        {
+            const Chunk* chunk = chunkAt(cx, cy);
+            int chunkEmpty = chunkCapacity(cx, cy) - (chunk ? chunk->balls : 0);
+            if (target >= chunkEmpty)
+            {
+                target -= chunkEmpty;
+                continue;
+            }
+
+            int endX = std::min(width, (cx + 1) * ChunkSize);
+            int endY = std::min(height, (cy + 1) * ChunkSize);
+            for (y = cy * ChunkSize; y < endY; ++y)
+            {
+                for (x = cx * ChunkSize; x < endX; ++x)
+                {
+                    if (at(x, y) == 0 && target-- == 0)
+                        return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void HugeBoard::generateNextBalls()
+{
+    nextBalls.clear();
+    for (int i = 0; i < 2; ++i)
+        nextBalls.push_back(static_cast<BallColor>(colorDist(rng)));
+}
+
+std::vector<std::pair<int, int>> HugeBoard::addNewBalls()
+{
+    std::vector<std::pair<int, int>> added;
+    for (BallColor color : nextBalls)
+    {
+        int x, y;
+        if (!randomEmptyCell(x, y))
+            break;
+        set(x, y, static_cast<int>(color) + 1);
+        added.push_back({x, y});
+    }
+    generateNextBalls();
+    return added;
+}
+
+bool HugeBoard::moveBall(int fromX, int fromY, int toX, int toY)
+{
+    if (gameOver || !canMoveTo(fromX, fromY, toX, toY))
+        return false;
+
+    set(toX, toY, at(fromX, fromY));
+    set(fromX, fromY, 0);
+
+    // Ta sama kolejność co w HeadlessGame::playMove: linia albo nowe kulki,
+    // po każdym usunięciu linii dokładane są kulki. Usuwanie nie tworzy linii,
+    // więc combo po dołożeniu kulek zawsze wraca do 1.
+    int removed = clearLinesThrough({{toX, toY}});
+    if (removed == 0)
+        removed = clearLinesThrough(addNewBalls());
+    while (removed > 0)
+    {
+        score += BoardState::pointsForClear(removed, 1);
+        removed = clearLinesThrough(addNewBalls());
+    }
+
+    if (getEmptyCount() < 2 || !hasAvailableMoves())
+        gameOver = true;
+    return true;
+}
+
+bool HugeBoard::hasAvailableMoves() const
+{
+    // Kulka może się ruszyć, gdy ma pusty sąsiedni pas.
+    // Kawałek częściowo zajęty zawsze ma taką kulkę (pola kawałka są spójne),
+    // więc pola trzeba oglądać tylko na styku pełnego kawałka z niepełnym.
+    auto balls = [this](int cx, int cy) {
+        const Chunk* chunk = chunkAt(cx, cy);
+        return chunk ? chunk->balls : 0;
+    };
+
+    for (int cy = 0; cy < chunksY; ++cy)
+    {
+        for (int cx = 0; cx < chunksX; ++cx)
+        {
+            int count = balls(cx, cy);
+            if (count > 0 && count < chunkCapacity(cx, cy))
+                return true;
+        }
+    }
+
+    for (int cy = 0; cy < chunksY; ++cy)
+    {
+        for (int cx = 0; cx < chunksX; ++cx)
+        {
+            if (balls(cx, cy) != chunkCapacity(cx, cy))
+                continue;
+            // Pełny kawałek obok pustego - kulka z brzegu ma dokąd pójść
+            const int neighbours[4][2] = {{cx, cy - 1}, {cx, cy + 1}, {cx - 1, cy}, {cx + 1, cy}};
+            for (const auto& n : neighbours)
+            {
+                if (n[0] >= 0 && n[0] < chunksX && n[1] >= 0 && n[1] < chunksY && balls(n[0], n[1]) == 0)
+                    return true;
+            }
+        }
+    }
+    return false;
+}
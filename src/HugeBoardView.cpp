@@ -0,0 +1,175 @@
+#include "../include/HugeBoardView.hpp"
+#include <algorithm>
+#include <cmath>
+#include "../include/Ball.hpp"
+
+namespace
+{
+    // Poniżej tylu pikseli na pole kulki i tak zlewają się w plamy - kawałek to jeden prostokąt
+    const float ChunkDetailPixels = 2.0f;
+    const sf::Color Background(40, 40, 40);
+
+    sf::Color averageColor(const HugeBoard::Chunk& chunk, int capacity)
+    {
+        // Puste pola mają kolor tła
+        int empty = capacity - chunk.balls;
+        int r = Background.r * empty, g = Background.g * empty, b = Background.b * empty;
+        for (int value = 1; value < static_cast<int>(chunk.colorBalls.size()); ++value)
+        {
+            BallRgb rgb = ballRgb(static_cast<BallColor>(value - 1));
+            r += rgb.r * chunk.colorBalls[value];
+            g += rgb.g * chunk.colorBalls[value];
+            b += rgb.b * chunk.colorBalls[value];
+        }
+        return sf::Color(static_cast<std::uint8_t>(r / capacity), static_cast<std::uint8_t>(g / capacity),
+                         static_cast<std::uint8_t>(b / capacity));
+    }
+}
+
+HugeBoardView::HugeBoardView(HugeBoard& b, sf::FloatRect area)
+    : board(b), viewport(area), center{b.getWidth() / 2.0f, b.getHeight() / 2.0f}, cellPixels(12.0f),
+      selectedX(-1), selectedY(-1), lastVisibleChunks(0)
+{
+}
+
+sf::Vector2f HugeBoardView::toBoard(sf::Vector2f pixel) const
+{
+    float midX = viewport.position.x + viewport.size.x / 2.0f;
+    float midY = viewport.position.y + viewport.size.y / 2.0f;
+    return {center.x + (pixel.x - midX) / cellPixels, center.y + (pixel.y - midY) / cellPixels};
+}
+
+void HugeBoardView::pan(float dx, float dy)
+{
+    center.x = std::clamp(center.x + dx / cellPixels, 0.0f, static_cast<float>(board.getWidth()));
+    center.y = std::clamp(center.y + dy / cellPixels, 0.0f, static_cast<float>(board.getHeight()));
+}
+
+void HugeBoardView::zoom(float factor, sf::Vector2f pixel)
+{
+    sf::Vector2f before = toBoard(pixel);
+    // Od całej planszy w oknie do kilkudziesięciu pikseli na pole
+    float minPixels = std::min(viewport.size.x / board.getWidth(), viewport.size.y / board.getHeight());
+    cellPixels = std::clamp(cellPixels * factor, minPixels, 64.0f);
+    sf::Vector2f after = toBoard(pixel);
+    center.x += before.x - after.x;
+    center.y += before.y - after.y;
+}
+
+void HugeBoardView::handleClick(sf::Vector2f pixel)
+{
+    sf::Vector2f cell = toBoard(pixel);
+    int x = static_cast<int>(std::floor(cell.x));
+    int y = static_cast<int>(std::floor(cell.y));
+    if (!board.isValidPosition(x, y) || board.isGameOver())
+        return;
+
+    // Ta sama obsługa co Board::handleMouseClick: wybór, odznaczenie, ruch
+    if (board.at(x, y) != 0)
+    {
+        bool same = x == selectedX && y == selectedY;
+        selectedX = same ? -1 : x;
+        selectedY = same ? -1 : y;
+    }
+    else if (selectedX >= 0 && board.moveBall(selectedX, selectedY, x, y))
+    {
+        selectedX = -1;
+        selectedY = -1;
+    }
+}
+
+void HugeBoardView::appendQuad(float x0, float y0, float x1, float y1, sf::Color color)
+{
+    const sf::Vector2f corners[6] = {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y0}, {x1, y1}, {x0, y1}};
+    for (const auto& corner : corners)
+        vertices.push_back(sf::Vertex{corner, color, {}});
+}
+
+void HugeBoardView::draw(sf::RenderTarget& window)
+{
+    vertices.clear();
+
+    // Widoczny prostokąt w polach, przycięty do planszy
+    sf::Vector2f topLeft = toBoard(viewport.position);
+    sf::Vector2f bottomRight = toBoard(viewport.position + viewport.size);
+    int x0 = std::max(0, static_cast<int>(std::floor(topLeft.x)));
+    int y0 = std::max(0, static_cast<int>(std::floor(topLeft.y)));
+    int x1 = std::min(board.getWidth(), static_cast<int>(std::ceil(bottomRight.x)));
+    int y1 = std::min(board.getHeight(), static_cast<int>(std::ceil(bottomRight.y)));
+    if (x0 >= x1 || y0 >= y1)
+        return;
+
+    auto screenX = [&](float x) { return viewport.position.x + viewport.size.x / 2.0f + (x - center.x) * cellPixels; };
+    auto screenY = [&](float y) { return viewport.position.y + viewport.size.y / 2.0f + (y - center.y) * cellPixels; };
+
+    // Tło widocznej części planszy - jeden prostokąt zamiast kształtu na pole
+    appendQuad(screenX(x0), screenY(y0), screenX(x1), screenY(y1), Background);
+
+    // Siatka tylko przy zbliżeniu - przy kilku pikselach na pole byłaby szumem
+    if (cellPixels >= 8.0f)
+    {
+        sf::Color gridColor(80, 80, 80);
+        for (int x = x0; x <= x1; ++x)
+            appendQuad(screenX(x), screenY(y0), screenX(x) + 1.0f, screenY(y1), gridColor);
+        for (int y = y0; y <= y1; ++y)
+            appendQuad(screenX(x0), screenY(y), screenX(x1), screenY(y) + 1.0f, gridColor);
+    }
+
+    // Kulki tylko z widocznych, niepustych kawałków
+    float inset = cellPixels >= 4.0f ? cellPixels * 0.15f : 0.0f;
+    int chunkX0 = x0 >> HugeBoard::ChunkBits, chunkX1 = (x1 - 1) >> HugeBoard::ChunkBits;
+    int chunkY0 = y0 >> HugeBoard::ChunkBits, chunkY1 = (y1 - 1) >> HugeBoard::ChunkBits;
+    lastVisibleChunks = 0;
+    for (int cy = chunkY0; cy <= chunkY1; ++cy)
+    {
+        for (int cx = chunkX0; cx <= chunkX1; ++cx)
+        {
+            const HugeBoard::Chunk* chunk = board.chunkAt(cx, cy);
+            if (!chunk)
+                continue;
+            lastVisibleChunks++;
+
+            // Z daleka: cały kawałek jednym prostokątem zamiast do 1024 kulek
+            if (cellPixels < ChunkDetailPixels)
+            {
+                int left = cx * HugeBoard::ChunkSize, top = cy * HugeBoard::ChunkSize;
+                int right = std::min(board.getWidth(), left + HugeBoard::ChunkSize);
+                int bottom = std::min(board.getHeight(), top + HugeBoard::ChunkSize);
+                appendQuad(screenX(left), screenY(top), screenX(right), screenY(bottom),
+                           averageColor(*chunk, board.chunkCapacity(cx, cy)));
+                continue;
+            }
+
+            int startX = std::max(x0, cx * HugeBoard::ChunkSize);
+            int endX = std::min(x1, (cx + 1) * HugeBoard::ChunkSize);
+            int startY = std::max(y0, cy * HugeBoard::ChunkSize);
+            int endY = std::min(y1, (cy + 1) * HugeBoard::ChunkSize);
+            for (int y = startY; y < endY; ++y)
+            {
+                for (int x = startX; x < endX; ++x)
+                {
+                    int value = chunk->cells[(y - cy * HugeBoard::ChunkSize) * HugeBoard::ChunkSize +
+                                             (x - cx * HugeBoard::ChunkSize)];
+                    if (value == 0)
+                        continue;
+                    appendQuad(screenX(x) + inset, screenY(y) + inset,
+                               screenX(x + 1) - inset, screenY(y + 1) - inset, toSFMLColor(static_cast<BallColor>(value - 1)));
+                }
+            }
+        }
+    }
+
+    // Wybrana kulka - biała ramka
+    if (selectedX >= x0 && selectedX < x1 && selectedY >= y0 && selectedY < y1)
+    {
+        float left = screenX(selectedX), top = screenY(selectedY);
+        float right = screenX(selectedX + 1), bottom = screenY(selectedY + 1);
+        float t = std::max(1.0f, cellPixels * 0.1f);
+        appendQuad(left, top, right, top + t, sf::Color::White);
+        appendQuad(left, bottom - t, right, bottom, sf::Color::White);
+        appendQuad(left, top, left + t, bottom, sf::Color::White);
+        appendQuad(right - t, top, right, bottom, sf::Color::White);
+    }
+
+    window.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles);
+}
@@ -0,0 +1,79 @@
+#include "../include/InputLatency.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    float millisecondsBetween(InputLatency::Clock::time_point from, InputLatency::Clock::time_point to)
+    {
+        return std::chrono::duration<float, std::milli>(to - from).count();
+    }
+
+    double percentileOf(std::vector<float> values, double p)
+    {
+        if (values.empty())
+            return 0.0;
+        size_t rank = static_cast<size_t>(std::lround(std::clamp(p, 0.0, 100.0) / 100.0 * (values.size() - 1)));
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank), values.end());
+        return values[rank];
+    }
+}
+
+void InputLatency::received()
+{
+    receivedAt = Clock::now();
+    receiving = true;
+}
+
+void InputLatency::handled(bool moved)
+{
+    if (!receiving)
+        return;
+    receiving = false;
+    handleMs.push_back(millisecondsBetween(receivedAt, Clock::now()));
+    waiting.push_back(receivedAt);
+    waitingMoved.push_back(moved);
+}
+
+void InputLatency::presented()
+{
+    if (waiting.empty())
+        return;
+
+    Clock::time_point now = Clock::now();
+    for (size_t i = 0; i < waiting.size(); ++i)
+    {
+        float ms = millisecondsBetween(waiting[i], now);
+        presentMs.push_back(ms);
+        if (waitingMoved[i])
+            movedPresentMs.push_back(ms);
+    }
+    waiting.clear();
+    waitingMoved.clear();
+}
+
+void InputLatency::clear()
+{
+    receiving = false;
+    waiting.clear();
+    waitingMoved.clear();
+    handleMs.clear();
+    presentMs.clear();
+    movedPresentMs.clear();
+}
+
+double InputLatency::presentedPercentile(double p, bool movedOnly) const
+{
+    return percentileOf(movedOnly ? movedPresentMs : presentMs, p);
+}
+
+void InputLatency::report(std::ostream& out) const
+{
+    out << "Opóźnienie kliknięć (" << handleMs.size() << ", z ruchem " << movedPresentMs.size() << "), ms:" << std::endl;
+    out << "  obsługa:        p50 " << percentileOf(handleMs, 50) << ", p99 " << percentileOf(handleMs, 99)
+        << ", max " << percentileOf(handleMs, 100) << std::endl;
+    out << "  do klatki:      p50 " << percentileOf(presentMs, 50) << ", p99 " << percentileOf(presentMs, 99)
+        << ", max " << percentileOf(presentMs, 100) << std::endl;
+    out << "  ruch do klatki: p50 " << percentileOf(movedPresentMs, 50) << ", p99 " << percentileOf(movedPresentMs, 99)
+        << ", max " << percentileOf(movedPresentMs, 100) << std::endl;
+}
@@ -0,0 +1,208 @@
+#include "../include/InputReplay.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include "../include/Game.hpp"
+#include "../include/SelfPlay.hpp"
+
+std::optional<InputEvent> InputReplay::fromEvent(const sf::Event& event, unsigned long frame)
+{
+    InputEvent input;
+    input.frame = frame;
+    if (const auto* mouseEvent = event.getIf<sf::Event::MouseButtonPressed>())
+    {
+        if (mouseEvent->button != sf::Mouse::Button::Left)
+            return std::nullopt;
+        input.type = 'c';
+        input.a = mouseEvent->position.x;
+        input.b = mouseEvent->position.y;
+        return input;
+    }
+    if (const auto* moveEvent = event.getIf<sf::Event::MouseMoved>())
+    {
+        input.type = 'm';
+        input.a = moveEvent->position.x;
+        input.b = moveEvent->position.y;
+        return input;
+    }
+    if (const auto* keyEvent = event.getIf<sf::Event::KeyPressed>())
+    {
+        input.type = 'k';
+        input.a = static_cast<int>(keyEvent->code);
+        return input;
+    }
+    return std::nullopt;
+}
+
+std::optional<sf::Event> InputReplay::toEvent(const InputEvent& input)
+{
+    switch (input.type)
+    {
+        case 'c':
+        {
+            sf::Event::MouseButtonPressed click{};
+            click.button = sf::Mouse::Button::Left;
+            click.position = {input.a, input.b};
+            return sf::Event(click);
+        }
+        case 'm':
+        {
+            sf::Event::MouseMoved move{};
+            move.position = {input.a, input.b};
+            return sf::Event(move);
+        }
+        case 'k':
+        {
+            sf::Event::KeyPressed key{};
+            key.code = static_cast<sf::Keyboard::Key>(input.a);
+            return sf::Event(key);
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+void InputReplay::write(std::ostream& out, const InputEvent& input)
+{
+    out << input.frame << ' ' << input.type << ' ' << input.a << ' ' << input.b << '\n';
+}
+
+bool InputReplay::load(const std::string& path, unsigned int& seed, std::vector<InputEvent>& events)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::cerr << "Nie można otworzyć nagrania: " << path << std::endl;
+        return false;
+    }
+
+    std::string word;
+    if (!(in >> word >> seed) || word != "seed")
+    {
+        std::cerr << "Nagranie bez ziarna: " << path << std::endl;
+        return false;
+    }
+
+    events.clear();
+    InputEvent input;
+    while (in >> input.frame >> input.type >> input.a >> input.b)
+        events.push_back(input);
+    return true;
+}
+
+namespace
+{
+    // Bot w roli gracza: najeżdża i klika kulkę, w następnej klatce pole docelowe
+    class SyntheticPlayer
+    {
+    public:
+        explicit SyntheticPlayer(unsigned int seed) : rng(seed), move{-1, -1, -1, -1}, movesMade(0) {}
+
+        void nextFrame(Board& board, unsigned long frame, std::vector<InputEvent>& out)
+        {
+            if (move.fromX >= 0)
+            {
+                // Druga połowa ruchu: kursor nad celem (podgląd ścieżki), potem klik
+                sf::Vector2f target = board.getCellCenter(move.toX, move.toY);
+                out.push_back(mouse('m', frame, target));
+                out.push_back(mouse('c', frame, target));
+                move.fromX = -1;
+                movesMade++;
+                return;
+            }
+
+            if (board.isGameOver())
+            {
+                out.push_back({frame, 'k', static_cast<int>(sf::Keyboard::Key::R), 0});
+                return;
+            }
+            if (!board.isSettled())
+                return; // Animacja linii - kliknięcia i tak byłyby zignorowane
+
+            move = SelfPlay::chooseMove(board.snapshot(), rng);
+            if (move.fromX < 0)
+                return;
+            sf::Vector2f source = board.getCellCenter(move.fromX, move.fromY);
+            out.push_back(mouse('m', frame, source));
+            out.push_back(mouse('c', frame, source));
+        }
+
+        int getMovesMade() const { return movesMade; }
+
+    private:
+        std::mt19937 rng;
+        Move move;
+        int movesMade;
+
+        static InputEvent mouse(char type, unsigned long frame, sf::Vector2f position)
+        {
+            return {frame, type, static_cast<int>(position.x), static_cast<int>(position.y)};
+        }
+    };
+}
+
+int InputReplay::run(const std::string& source, int moves, double budgetMs)
+{
+    bool synthetic = source == "synthetic";
+    unsigned int seed = 1;
+    std::vector<InputEvent> recorded;
+    if (!synthetic && !load(source, seed, recorded))
+        return 1;
+
+    Game game(true);
+    game.getBoard().reset(seed);
+    SyntheticPlayer player(seed);
+
+    // Nagranie odtwarzamy w tempie 60 klatek/s, bo animacje planszy biegną w czasie rzeczywistym
+    // i szybsze odtwarzanie rozjechałoby się z nagraniem. Ruchy syntetyczne idą bez limitu.
+    const auto frameTime = std::chrono::microseconds(16667);
+    auto frameDeadline = std::chrono::steady_clock::now();
+    auto startTime = frameDeadline;
+
+    std::vector<InputEvent> frameEvents;
+    size_t next = 0;
+    unsigned long frame = 0;
+    while (synthetic ? player.getMovesMade() < moves : next < recorded.size())
+    {
+        frameEvents.clear();
+        if (synthetic)
+            player.nextFrame(game.getBoard(), frame, frameEvents);
+        else
+        {
+            while (next < recorded.size() && recorded[next].frame <= frame)
+                frameEvents.push_back(recorded[next++]);
+        }
+
+        for (const InputEvent& input : frameEvents)
+        {
+            if (auto event = toEvent(input))
+                game.handleEvent(*event);
+        }
+        game.update();
+        game.render();
+        frame++;
+
+        if (!synthetic)
+        {
+            frameDeadline += frameTime;
+            std::this_thread::sleep_until(frameDeadline);
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const Board& board = game.getBoard();
+    std::cout << "Klatki: " << frame << " (" << static_cast<int>(frame / std::max(seconds, 1e-9)) << "/s), wynik: "
+              << board.getScore() << ", tura: " << board.getTurn() << std::endl;
+    game.getLatency().report(std::cout);
+
+    double p99 = game.getLatency().presentedPercentile(99);
+    if (budgetMs > 0.0 && p99 > budgetMs)
+    {
+        std::cerr << "Opóźnienie p99 " << p99 << " ms przekracza budżet " << budgetMs << " ms" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,212 @@
+#include "../include/LiveGameFile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const char Magic[4] = {'K', 'L', 'V', '1'};
+    const std::uint32_t Version = 4;
+
+    struct FileHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t recordBytes;
+        std::uint32_t reserved;
+    };
+
+    const size_t FileBytes = sizeof(FileHeader) + 2 * sizeof(LiveGameRecord);
+}
+
+LiveGameFile::LiveGameFile()
+    : mapped(nullptr), mappedBytes(0), slots(nullptr), writing(nullptr), lastSequence(0), newestSlot(-1),
+      syncedSequence(0), syncTarget(0), syncPending(false), stopping(false)
+{
+}
+
+LiveGameFile::~LiveGameFile()
+{
+    close();
+}
+
+bool LiveGameFile::open(const std::string& path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "Nie można otworzyć pliku bieżącej gry: " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    bool fresh = ::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != FileBytes;
+    if (fresh && ::ftruncate(fd, static_cast<off_t>(FileBytes)) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = ::mmap(nullptr, FileBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd); // Mapowanie zostaje ważne po zamknięciu deskryptora
+    if (view == MAP_FAILED)
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, view, sizeof(header));
+    if (fresh || std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version ||
+        header.recordBytes != sizeof(LiveGameRecord))
+    {
+        // Inny format (np. zapis starszej wersji) - zaczynamy od pustych slotów
+        std::memset(view, 0, FileBytes);
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.recordBytes = sizeof(LiveGameRecord);
+        header.reserved = 0;
+        std::memcpy(view, &header, sizeof(header));
+    }
+
+    mapped = view;
+    mappedBytes = FileBytes;
+    slots = reinterpret_cast<LiveGameRecord*>(static_cast<char*>(view) + sizeof(FileHeader));
+
+    const LiveGameRecord* newest = latest();
+    lastSequence = newest ? newest->sequence : 0;
+    newestSlot = newest ? static_cast<int>(newest - slots) : -1;
+    syncedSequence = lastSequence; // To, co zastaliśmy w pliku
+
+    stopping = false;
+    syncPending = false;
+    syncer = std::thread([this] { syncLoop(); });
+    return true;
+}
+
+void LiveGameFile::close()
+{
+    if (syncer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(syncMutex);
+            stopping = true;
+        }
+        syncWake.notify_one();
+        syncer.join();
+    }
+    if (mapped)
+    {
+        ::msync(mapped, mappedBytes, MS_SYNC);
+        ::munmap(mapped, mappedBytes);
+    }
+    mapped = nullptr;
+    mappedBytes = 0;
+    slots = nullptr;
+    writing = nullptr;
+    lastSequence = 0;
+    newestSlot = -1;
+    syncedSequence = 0;
+    syncTarget = 0;
+}
+
+std::uint64_t LiveGameFile::checksumOf(const LiveGameRecord& record)
+{
+    // Słowa po polu checksum (numer zapisu też się liczy); FNV-1a na słowach 64-bitowych
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&record);
+    std::uint64_t hash = 14695981039346656037ull ^ record.sequence;
+    for (size_t offset = 2 * sizeof(std::uint64_t); offset < sizeof(LiveGameRecord); offset += sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + offset, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    return hash;
+}
+
+bool LiveGameFile::isValid(const LiveGameRecord& record) const
+{
+    return record.sequence != 0 && record.checksum == checksumOf(record) && record.width > 0 && record.height > 0 &&
+           record.width * record.height <= LiveGameRecord::MaxCells && record.nextCount <= LiveGameRecord::MaxNext;
+}
+
+const LiveGameRecord* LiveGameFile::latest() const
+{
+    if (!mapped)
+        return nullptr;
+
+    const LiveGameRecord* newest = nullptr;
+    for (int i = 0; i < 2; ++i)
+    {
+        if (isValid(slots[i]) && (!newest || slots[i].sequence > newest->sequence))
+            newest = &slots[i];
+    }
+    return newest;
+}
+
+LiveGameRecord& LiveGameFile::beginWrite()
+{
+    // Slot nowszego zapisu zostaje nietknięty, dopóki ten nie zostanie zatwierdzony
+    if (newestSlot >= 0)
+    {
+        std::unique_lock<std::mutex> lock(syncMutex);
+        if (syncedSequence < slots[newestSlot].sequence)
+        {
+            // Starszy slot to jedyny zapis na dysku - najpierw spychamy tam nowszy. Zdarza się tylko przy
+            // kilku zmianach szybciej niż msync w tle (np. zaznaczenie tuż po turze).
+            lock.unlock();
+            ::msync(mapped, mappedBytes, MS_SYNC);
+            lock.lock();
+            syncedSequence = std::max(syncedSequence, lastSequence);
+        }
+    }
+    writing = &slots[newestSlot == 0 ? 1 : 0];
+    writing->sequence = 0; // Slot w trakcie zapisu nie jest poprawny
+    return *writing;
+}
+
+void LiveGameFile::commit()
+{
+    if (!writing)
+        return;
+
+    std::atomic_thread_fence(std::memory_order_release);
+    writing->sequence = ++lastSequence;
+    writing->checksum = checksumOf(*writing);
+    newestSlot = writing == &slots[0] ? 0 : 1;
+    writing = nullptr;
+}
+
+void LiveGameFile::requestSync()
+{
+    if (!mapped)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(syncMutex);
+        syncPending = true;
+        syncTarget = lastSequence;
+    }
+    syncWake.notify_one();
+}
+
+void LiveGameFile::syncLoop()
+{
+    std::unique_lock<std::mutex> lock(syncMutex);
+    while (true)
+    {
+        syncWake.wait(lock, [this] { return syncPending || stopping; });
+        if (stopping)
+            return;
+        syncPending = false;
+        std::uint64_t target = syncTarget;
+
+        // Kilka tur w trakcie jednego msync zlewa się w następny
+        lock.unlock();
+        ::msync(mapped, mappedBytes, MS_SYNC);
+        lock.lock();
+        syncedSequence = std::max(syncedSequence, target);
+    }
+}
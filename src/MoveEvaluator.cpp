@@ -0,0 +1,531 @@
+#include "../include/MoveEvaluator.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace
+{
+    // Tani generator do remisów - przy rzadkiej planszy remisów są setki,
+    // a uniform_int_distribution na mt19937 kosztowałby więcej niż sama ocena
+    class TieBreaker
+    {
+    public:
+        explicit TieBreaker(std::uint32_t seed) : state(seed | 1u) {}
+
+        // Czy nowa grupa (weight ruchów) zastępuje dotychczasowy wybór przy łącznej wadze total
+        bool replaces(size_t weight, size_t total)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state % total < weight;
+        }
+
+    private:
+        std::uint32_t state;
+    };
+
+    // Klucz sortowania malejąco po ocenie: bez znaku, większa ocena - mniejszy klucz
+    std::uint32_t descendingKey(int score)
+    {
+        return ~(static_cast<std::uint32_t>(score) ^ 0x80000000u);
+    }
+}
+
+MoveEvaluator::MoveEvaluator(int width, int height, int lineLength)
+    : lineLength(lineLength), nearSpan(2 * lineLength - 1), nearSlots(nearSpan * nearSpan), width(width),
+      height(height), cells(width * height), windows(0)
+{
+    // Potencjał okna z k kulkami jednego koloru: każda kulka więcej to 8 razy więcej,
+    // a pełne okno (linia) przewyższa sumę pozostałych okien pola. Przy linii z 3: 0, 1, 8, 1000.
+    potentialOf.assign(lineLength + 1, 0);
+    for (int k = 1; k < lineLength; ++k)
+        potentialOf[k] = k == 1 ? 1 : potentialOf[k - 1] * 8;
+    potentialOf[lineLength] = 125;
+    for (int k = 2; k < lineLength; ++k)
+        potentialOf[lineLength] *= 8;
+
+    // Kierunki: →, ↓, ↘, ↙ - jak w BoardState::findAllLines
+    const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            for (const auto& d : directions)
+            {
+                int endX = x + d[0] * (lineLength - 1);
+                int endY = y + d[1] * (lineLength - 1);
+                if (endX < 0 || endX >= width || endY >= height)
+                    continue;
+
+                for (int i = 0; i < lineLength; ++i)
+                    windowCells.push_back(static_cast<std::uint16_t>((y + d[1] * i) * width + x + d[0] * i));
+                windows++;
+            }
+        }
+    }
+
+    // Okna każdego pola w jednej tablicy (zliczanie, potem rozkładanie)
+    cellWindowStart.assign(cells + 1, 0);
+    for (std::uint16_t cell : windowCells)
+        cellWindowStart[cell + 1]++;
+    for (int i = 0; i < cells; ++i)
+        cellWindowStart[i + 1] += cellWindowStart[i];
+    cellWindows.resize(cellWindowStart[cells]);
+    std::vector<std::uint32_t> fill(cellWindowStart.begin(), cellWindowStart.end() - 1);
+    for (size_t i = 0; i < windowCells.size(); ++i)
+        cellWindows[fill[windowCells[i]]++] = static_cast<std::uint16_t>(i / lineLength);
+
+    // Pary pól w jednym oknie - poprawka oceny bez przeglądania wszystkich okien pola
+    // (co najwyżej lineLength - 1 okien na parę, wolne miejsca to -1)
+    sharedWindows.assign(cells * nearSlots * (lineLength - 1), -1);
+    for (int w = 0; w < windows; ++w)
+    {
+        const std::uint16_t* window = windowCells.data() + w * lineLength;
+        for (int i = 0; i < lineLength; ++i)
+        {
+            for (int j = 0; j < lineLength; ++j)
+            {
+                if (i == j)
+                    continue;
+                int dx = window[j] % width - window[i] % width;
+                int dy = window[j] / width - window[i] / width;
+                int* shared = sharedWindows.data() + (window[i] * nearSlots + slotOf(dx, dy)) * (lineLength - 1);
+                *std::find(shared, shared + lineLength - 1, -1) = w;
+            }
+        }
+    }
+
+    for (const auto& d : directions)
+    {
+        for (int distance = 1 - lineLength; distance < lineLength; ++distance)
+        {
+            if (distance == 0)
+                continue;
+            int dx = d[0] * distance;
+            int dy = d[1] * distance;
+            nearOffsets.push_back({dx, dy, slotOf(dx, dy)});
+        }
+    }
+
+    cellX.resize(cells);
+    cellY.resize(cells);
+    for (int i = 0; i < cells; ++i)
+    {
+        cellX[i] = i % width;
+        cellY[i] = i / width;
+    }
+
+    windowColor.resize(windows);
+    windowBalls.resize(windows);
+    windowBonus.resize(windows);
+    cellBits.resize(cells);
+    potential.resize(windows);
+    gain.resize(cells * MaxValue);
+    loss.resize(cells);
+    labels.resize(cells);
+    stack.reserve(cells);
+    regionStart.reserve(cells + 1);
+    regionCells.resize(cells);
+    regionBest.resize(cells * MaxValue);
+}
+
+int MoveEvaluator::addedPotential(int window, int color) const
+{
+    if (windowColor[window] == 0)
+        return potentialOf[1];
+    return windowColor[window] == color ? windowBonus[window] : 0;
+}
+
+int MoveEvaluator::removedPotential(const BoardState& state, int window, int cell) const
+{
+    if (windowColor[window] > 0)
+        return potentialOf[windowBalls[window] - 1];
+
+    // Po zabraniu kulki okno z dwoma kolorami może stać się czyste
+    int color = 0;
+    int balls = 0;
+    const std::uint16_t* first = windowCells.data() + window * lineLength;
+    for (const std::uint16_t* other = first; other != first + lineLength; ++other)
+    {
+        int value = state.cells[*other];
+        if (*other == cell || value == 0)
+            continue;
+        if (color != 0 && value != color)
+            return 0;
+        color = value;
+        balls++;
+    }
+    return potentialOf[balls];
+}
+
+void MoveEvaluator::prepare(const BoardState& state)
+{
+    const std::vector<int>& board = state.cells;
+
+    // Kolory okna jako maska bitowa - bez rozgałęzień, które na losowej planszy źle się przewidują
+    for (int cell = 0; cell < cells; ++cell)
+        cellBits[cell] = board[cell] != 0 ? 1u << board[cell] : 0u;
+
+    for (int w = 0; w < windows; ++w)
+    {
+        unsigned mask = 0;
+        int balls = 0;
+        const std::uint16_t* window = windowCells.data() + w * lineLength;
+        for (int i = 0; i < lineLength; ++i)
+        {
+            mask |= cellBits[window[i]];
+            balls += board[window[i]] != 0;
+        }
+        bool pure = mask != 0 && (mask & (mask - 1)) == 0;
+        windowColor[w] = mask == 0 ? 0 : pure ? __builtin_ctz(mask) : -1;
+        windowBalls[w] = balls;
+        potential[w] = pure ? potentialOf[balls] : 0;
+        windowBonus[w] = pure && balls < lineLength ? potentialOf[balls + 1] : 0;
+    }
+
+    for (int cell = 0; cell < cells; ++cell)
+    {
+        const std::uint16_t* first = cellWindows.data() + cellWindowStart[cell];
+        const std::uint16_t* last = cellWindows.data() + cellWindowStart[cell + 1];
+        if (board[cell] == 0)
+        {
+            // Zysk z postawienia kulki: okno puste lub czyste w tym kolorze rośnie, każde inne znika
+            int* cellGain = gain.data() + cell * MaxValue;
+            int lost = 0;
+            int emptyWindows = 0;
+            std::fill(cellGain, cellGain + MaxValue, 0);
+            for (const std::uint16_t* w = first; w != last; ++w)
+            {
+                int color = windowColor[*w];
+                lost += potential[*w];
+                emptyWindows += color == 0;
+                cellGain[color > 0 ? color : 0] += windowBonus[*w]; // Pole 0 nieużywane
+            }
+            for (int color = 1; color < MaxValue; ++color)
+                cellGain[color] += emptyWindows * potentialOf[1] - lost;
+        }
+        else
+        {
+            int total = 0;
+            for (const std::uint16_t* w = first; w != last; ++w)
+                total += removedPotential(state, *w, cell) - potential[*w];
+            loss[cell] = total;
+        }
+    }
+
+    // Obszary pustych pól - jedno zalewanie całej planszy
+    std::fill(labels.begin(), labels.end(), -1);
+    regionStart.clear();
+    int used = 0;
+    for (int start = 0; start < cells; ++start)
+    {
+        if (board[start] != 0 || labels[start] != -1)
+            continue;
+
+        int region = static_cast<int>(regionStart.size());
+        regionStart.push_back(used);
+        labels[start] = region;
+        stack.push_back(start);
+        while (!stack.empty())
+        {
+            int index = stack.back();
+            stack.pop_back();
+            regionCells[used++] = static_cast<std::uint16_t>(index);
+
+            int x = cellX[index];
+            int y = cellY[index];
+            const int neighbours[4] = {y > 0 ? index - width : -1, y + 1 < height ? index + width : -1,
+                                       x > 0 ? index - 1 : -1, x + 1 < width ? index + 1 : -1};
+            for (int n : neighbours)
+            {
+                if (n >= 0 && board[n] == 0 && labels[n] == -1)
+                {
+                    labels[n] = region;
+                    stack.push_back(n);
+                }
+            }
+        }
+    }
+    regionStart.push_back(used);
+
+    // Dwa najlepsze zyski obszaru dla każdego koloru i liczba pól z każdym z nich
+    int regions = static_cast<int>(regionStart.size()) - 1;
+    const int lowest = std::numeric_limits<int>::min();
+    std::fill(regionBest.begin(), regionBest.begin() + regions * MaxValue, RegionBest{lowest, 0, lowest, 0});
+    for (int region = 0; region < regions; ++region)
+    {
+        RegionBest* best = regionBest.data() + region * MaxValue;
+        for (std::uint32_t i = regionStart[region]; i < regionStart[region + 1]; ++i)
+        {
+            const int* cellGain = gain.data() + regionCells[i] * MaxValue;
+            for (int color = 1; color < MaxValue; ++color)
+            {
+                RegionBest& b = best[color];
+                int value = cellGain[color];
+                if (value > b.top)
+                    b = {value, 1, b.top, b.topCount};
+                else if (value == b.top)
+                    b.topCount++;
+                else if (value > b.second)
+                    b = {b.top, b.topCount, value, 1};
+                else if (value == b.second)
+                    b.secondCount++;
+            }
+        }
+    }
+}
+
+int MoveEvaluator::reachableRegions(int cell, int* regions) const
+{
+    int x = cellX[cell];
+    int y = cellY[cell];
+    const int neighbours[4] = {y > 0 ? cell - width : -1, y + 1 < height ? cell + width : -1,
+                               x > 0 ? cell - 1 : -1, x + 1 < width ? cell + 1 : -1};
+    int found = 0;
+    for (int n : neighbours)
+    {
+        if (n < 0 || labels[n] < 0)
+            continue;
+        if (std::find(regions, regions + found, labels[n]) == regions + found)
+            regions[found++] = labels[n];
+    }
+    return found;
+}
+
+template <typename Visit>
+void MoveEvaluator::forEachMove(const BoardState& state, Visit&& visit) const
+{
+    for (int from = 0; from < cells; ++from)
+    {
+        int color = state.cells[from];
+        if (color == 0)
+            continue;
+
+        int regions[4];
+        int found = reachableRegions(from, regions);
+        const int* colorGain = gain.data() + color;
+        int fromX = cellX[from];
+        int fromY = cellY[from];
+        for (int r = 0; r < found; ++r)
+        {
+            for (std::uint32_t i = regionStart[regions[r]]; i < regionStart[regions[r] + 1]; ++i)
+            {
+                int to = regionCells[i];
+                int value = colorGain[to * MaxValue] + loss[from];
+
+                // Poprawka tylko dla pól leżących razem w jakimś oknie
+                int dx = cellX[to] - fromX;
+                int dy = cellY[to] - fromY;
+                if (dx > -lineLength && dx < lineLength && dy > -lineLength && dy < lineLength)
+                    value += sharedCorrection(state, from, slotOf(dx, dy));
+                visit(from, to, value);
+            }
+        }
+    }
+}
+
+int MoveEvaluator::sharedCorrection(const BoardState& state, int from, int slot) const
+{
+    // Okno z oboma polami ma po ruchu te same kulki - jego zmiana to zero,
+    // a zysk i strata policzyły je osobno, więc odejmujemy oba składniki
+    int color = state.cells[from];
+    int correction = 0;
+    const int* shared = sharedWindows.data() + (from * nearSlots + slot) * (lineLength - 1);
+    for (const int* w = shared; w != shared + lineLength - 1 && *w >= 0; ++w)
+        correction -= addedPotential(*w, color) + removedPotential(state, *w, from) - 2 * potential[*w];
+    return correction;
+}
+
+const std::vector<ScoredMove>& MoveEvaluator::evaluate(const BoardState& state)
+{
+    prepare(state);
+    moves.clear();
+    forEachMove(state, [&](int from, int to, int value) {
+        moves.push_back({value, static_cast<std::uint16_t>(from), static_cast<std::uint16_t>(to)});
+    });
+    return moves;
+}
+
+const std::vector<ScoredMove>& MoveEvaluator::rank(const BoardState& state)
+{
+    evaluate(state);
+
+    // Sortowanie pozycyjne po bajtach klucza (stabilne, jak stable_sort) - ruchów jest ~1000,
+    // a porównania sortowania kosztowały dwa razy więcej niż sama ocena. Bajty wspólne
+    // dla wszystkich ocen (zwykle dwa najstarsze) są pomijane.
+    std::uint32_t differing = 0;
+    for (const ScoredMove& move : moves)
+        differing |= descendingKey(move.score) ^ descendingKey(moves.front().score);
+    sorted.resize(moves.size());
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        if (((differing >> shift) & 0xFF) == 0)
+            continue;
+        size_t count[257] = {};
+        for (const ScoredMove& move : moves)
+            count[(descendingKey(move.score) >> shift & 0xFF) + 1]++;
+        for (int digit = 0; digit < 256; ++digit)
+            count[digit + 1] += count[digit];
+        for (const ScoredMove& move : moves)
+            sorted[count[descendingKey(move.score) >> shift & 0xFF]++] = move;
+        moves.swap(sorted);
+    }
+    return moves;
+}
+
+Move MoveEvaluator::choose(const BoardState& state, std::mt19937& rng, float epsilon)
+{
+    prepare(state);
+
+    size_t total = 0;
+    for (int from = 0; from < cells; ++from)
+    {
+        if (state.cells[from] == 0)
+            continue;
+        int regions[4];
+        int found = reachableRegions(from, regions);
+        for (int r = 0; r < found; ++r)
+            total += regionStart[regions[r] + 1] - regionStart[regions[r]];
+    }
+    if (total == 0)
+        return {-1, -1, -1, -1};
+
+    std::uniform_real_distribution<float> explore(0.0f, 1.0f);
+    if (explore(rng) < epsilon)
+    {
+        // Losowy ruch odszukany po rozmiarach obszarów, bez oceniania
+        size_t chosen = std::uniform_int_distribution<size_t>(0, total - 1)(rng);
+        for (int from = 0; from < cells; ++from)
+        {
+            if (state.cells[from] == 0)
+                continue;
+            int regions[4];
+            int found = reachableRegions(from, regions);
+            for (int r = 0; r < found; ++r)
+            {
+                size_t size = regionStart[regions[r] + 1] - regionStart[regions[r]];
+                if (chosen < size)
+                    return {cellX[from], cellY[from], cellX[regionCells[regionStart[regions[r]] + chosen]],
+                            cellY[regionCells[regionStart[regions[r]] + chosen]]};
+                chosen -= size;
+            }
+        }
+    }
+
+    // Pola poza kwadratem nearSpan wokół kulki nie dzielą z nią okna, więc ich ocena to
+    // strata + zysk pola - wystarczy najlepszy zysk obszaru dla koloru kulki. Bliskie pola
+    // liczymy dokładnie. Remisy losowo, grupa pól z najlepszym zyskiem waży tyle, ile ma ruchów.
+    int bestScore = std::numeric_limits<int>::min();
+    size_t bestWeight = 0;
+    int bestFrom = -1;
+    int bestTo = -1; // -1: któreś z dalekich pól obszaru bestRegion z najlepszym zyskiem
+    int bestRegion = -1;
+    int bestGain = 0; // Zysk pól grupy, gdy bestTo == -1
+    TieBreaker ties(static_cast<std::uint32_t>(rng()));
+    auto consider = [&](int value, size_t weight, int from, int to, int region, int toGain) {
+        if (value < bestScore)
+            return;
+        if (value > bestScore)
+        {
+            bestScore = value;
+            bestWeight = 0;
+        }
+        bestWeight += weight;
+        if (ties.replaces(weight, bestWeight))
+        {
+            bestFrom = from;
+            bestTo = to;
+            bestRegion = region;
+            bestGain = toGain;
+        }
+    };
+    // Bliskie pole: w jednej linii z kulką i w odległości mniejszej niż lineLength
+    auto isNear = [&](int from, int to) {
+        int dx = std::abs(cellX[to] - cellX[from]);
+        int dy = std::abs(cellY[to] - cellY[from]);
+        return dx < lineLength && dy < lineLength && (dx == 0 || dy == 0 || dx == dy);
+    };
+
+    for (int from = 0; from < cells; ++from)
+    {
+        int color = state.cells[from];
+        if (color == 0)
+            continue;
+
+        int regions[4];
+        int found = reachableRegions(from, regions);
+        for (int r = 0; r < found; ++r)
+        {
+            int region = regions[r];
+            const RegionBest& best = regionBest[region * MaxValue + color];
+            int nearCells = 0;
+            int nearTop = 0;
+            int nearSecond = 0;
+            for (const auto& offset : nearOffsets)
+            {
+                int x = cellX[from] + offset[0];
+                int y = cellY[from] + offset[1];
+                if (x < 0 || x >= width || y < 0 || y >= height || labels[y * width + x] != region)
+                    continue;
+
+                int to = y * width + x;
+                int toGain = gain[to * MaxValue + color];
+                nearCells++;
+                nearTop += toGain == best.top;
+                nearSecond += toGain == best.second;
+                consider(toGain + loss[from] + sharedCorrection(state, from, offset[2]), 1, from, to, region, toGain);
+            }
+
+            // Najlepsze dalekie pole ma zysk top albo second, chyba że wszystkie takie są blisko
+            int farTop = best.topCount - nearTop;
+            int farSecond = best.secondCount - nearSecond;
+            if (farTop > 0)
+                consider(best.top + loss[from], farTop, from, -1, region, best.top);
+            else if (farSecond > 0)
+                consider(best.second + loss[from], farSecond, from, -1, region, best.second);
+            else if (static_cast<std::uint32_t>(nearCells) < regionStart[region + 1] - regionStart[region])
+            {
+                // Oba poziomy zajęte przez bliskie pola - najlepszy zysk dalekich pól z przeglądu obszaru
+                int farGain = std::numeric_limits<int>::min();
+                int farCount = 0;
+                for (std::uint32_t i = regionStart[region]; i < regionStart[region + 1]; ++i)
+                {
+                    int to = regionCells[i];
+                    int toGain = gain[to * MaxValue + color];
+                    if (toGain < farGain || isNear(from, to))
+                        continue;
+                    farCount = toGain == farGain ? farCount + 1 : 1;
+                    farGain = toGain;
+                }
+                consider(farGain + loss[from], farCount, from, -1, region, farGain);
+            }
+        }
+    }
+
+    if (bestTo < 0)
+    {
+        // Jedno z dalekich pól grupy, każde z tą samą szansą
+        int color = state.cells[bestFrom];
+        int candidates = 0;
+        for (std::uint32_t i = regionStart[bestRegion]; i < regionStart[bestRegion + 1]; ++i)
+        {
+            int to = regionCells[i];
+            if (gain[to * MaxValue + color] == bestGain && !isNear(bestFrom, to))
+                candidates++;
+        }
+        int pick = std::uniform_int_distribution<int>(0, candidates - 1)(rng);
+        for (std::uint32_t i = regionStart[bestRegion]; i < regionStart[bestRegion + 1] && bestTo < 0; ++i)
+        {
+            int to = regionCells[i];
+            if (gain[to * MaxValue + color] == bestGain && !isNear(bestFrom, to) && pick-- == 0)
+                bestTo = to;
+        }
+    }
+    return {cellX[bestFrom], cellY[bestFrom], cellX[bestTo], cellY[bestTo]};
+}
+
+Move MoveEvaluator::toMove(const ScoredMove& move) const
+{
+    return {cellX[move.from], cellY[move.from], cellX[move.to], cellY[move.to]};
+}
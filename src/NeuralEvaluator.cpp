@@ -0,0 +1,401 @@
+#include "../include/NeuralEvaluator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KULKI_X86 1
+#endif
+
+namespace
+{
+    // Jądra obliczeniowe - wersja przenośna i AVX2 wybierana raz przy starcie.
+    // out[j] += sum_k col[k] * weights[k][j]; zerowe aktywacje są pomijane.
+    void accumulateScalar(const float* col, int k, const float* weights, int cout, float* out)
+    {
+        for (int i = 0; i < k; ++i)
+        {
+            float v = col[i];
+            if (v == 0.0f)
+                continue;
+            const float* w = weights + static_cast<std::size_t>(i) * cout;
+            for (int j = 0; j < cout; ++j)
+                out[j] += v * w[j];
+        }
+    }
+
+    void accumulateInt8Scalar(const std::int8_t* col, int k, const std::int8_t* weights, int cout, std::int32_t* out)
+    {
+        for (int i = 0; i < k; ++i)
+        {
+            std::int32_t v = col[i];
+            if (v == 0)
+                continue;
+            const std::int8_t* w = weights + static_cast<std::size_t>(i) * cout;
+            for (int j = 0; j < cout; ++j)
+                out[j] += v * w[j];
+        }
+    }
+
+#ifdef KULKI_X86
+    __attribute__((target("avx2,fma")))
+    void accumulateAvx2(const float* col, int k, const float* weights, int cout, float* out)
+    {
+        const int vectorEnd = cout & ~7;
+        for (int i = 0; i < k; ++i)
+        {
+            float v = col[i];
+            if (v == 0.0f)
+                continue;
+            const float* w = weights + static_cast<std::size_t>(i) * cout;
+            __m256 scale = _mm256_set1_ps(v);
+            int j = 0;
+            for (; j < vectorEnd; j += 8)
+            {
+                __m256 acc = _mm256_loadu_ps(out + j);
+                _mm256_storeu_ps(out + j, _mm256_fmadd_ps(scale, _mm256_loadu_ps(w + j), acc));
+            }
+            for (; j < cout; ++j)
+                out[j] += v * w[j];
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void accumulateInt8Avx2(const std::int8_t* col, int k, const std::int8_t* weights, int cout, std::int32_t* out)
+    {
+        // Pary wierszy (i, i+1) przeplatane do int16 i liczone przez madd
+        const int vectorEnd = cout & ~7;
+        int i = 0;
+        for (; i + 2 <= k; i += 2)
+        {
+            std::int16_t a0 = col[i];
+            std::int16_t a1 = col[i + 1];
+            if (a0 == 0 && a1 == 0)
+                continue;
+
+            const std::int8_t* w0 = weights + static_cast<std::size_t>(i) * cout;
+            const std::int8_t* w1 = w0 + cout;
+            __m256i pair = _mm256_set1_epi32((static_cast<std::int32_t>(a1) << 16) | static_cast<std::uint16_t>(a0));
+            int j = 0;
+            for (; j < vectorEnd; j += 8)
+            {
+                __m128i row0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(w0 + j));
+                __m128i row1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(w1 + j));
+                __m256i wide = _mm256_cvtepi8_epi16(_mm_unpacklo_epi8(row0, row1));
+                __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + j));
+                acc = _mm256_add_epi32(acc, _mm256_madd_epi16(wide, pair));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j), acc);
+            }
+            for (; j < cout; ++j)
+                out[j] += a0 * w0[j] + a1 * w1[j];
+        }
+        if (i < k)
+            accumulateInt8Scalar(col + i, 1, weights + static_cast<std::size_t>(i) * cout, cout, out);
+    }
+#endif
+
+    struct Kernels
+    {
+        void (*accumulate)(const float*, int, const float*, int, float*);
+        void (*accumulateInt8)(const std::int8_t*, int, const std::int8_t*, int, std::int32_t*);
+        const char* name;
+    };
+
+    Kernels selectKernels()
+    {
+#ifdef KULKI_X86
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        {
+            return {accumulateAvx2, accumulateInt8Avx2, "avx2"};
+        }
+#endif
+        return {accumulateScalar, accumulateInt8Scalar, "scalar"};
+    }
+
+    const Kernels& kernels()
+    {
+        static const Kernels selected = selectKernels();
+        return selected;
+    }
+
+    // Okno 3x3 wokół (x, y) z aktywacji w układzie [pozycja][kanał], poza planszą zera
+    template <typename T>
+    void gatherWindow(const T* input, int channels, int width, int height, int x, int y, T* row)
+    {
+        for (int ky = -1; ky <= 1; ++ky)
+        {
+            for (int kx = -1; kx <= 1; ++kx)
+            {
+                int sx = x + kx;
+                int sy = y + ky;
+                if (sx >= 0 && sx < width && sy >= 0 && sy < height)
+                    std::memcpy(row, input + (sy * width + sx) * channels, sizeof(T) * channels);
+                else
+                    std::fill(row, row + channels, T(0));
+                row += channels;
+            }
+        }
+    }
+}
+
+NeuralEvaluator::NeuralEvaluator()
+    : mapping(nullptr), mappingSize(0), quantized(false), channels(0),
+      policyWeights(nullptr), policyBias(nullptr), valueWeights(nullptr), valueBias(nullptr)
+{
+}
+
+NeuralEvaluator::~NeuralEvaluator()
+{
+    unload();
+}
+
+void NeuralEvaluator::unload()
+{
+    if (mapping != nullptr)
+    {
+        munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    layers.clear();
+}
+
+bool NeuralEvaluator::load(const std::string& path)
+{
+    unload();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(NetworkHeader)))
+    {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // Mapowanie zostaje ważne po zamknięciu deskryptora
+    if (data == MAP_FAILED)
+        return false;
+
+    mapping = data;
+    mappingSize = static_cast<std::size_t>(info.st_size);
+
+    const char* base = static_cast<const char*>(data);
+    NetworkHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    if (std::memcmp(header.magic, "KNN1", 4) != 0 || header.version != 1 ||
+        header.inputPlanes != static_cast<std::uint32_t>(kInputPlanes) ||
+        header.channels == 0 || header.channels > 256 ||
+        header.convLayers == 0 || header.convLayers > 16 || header.weightType > 1)
+    {
+        unload();
+        return false;
+    }
+
+    channels = static_cast<int>(header.channels);
+    quantized = header.weightType == 1;
+
+    // Kolejne tensory zaczynają się na granicy 32 bajtów
+    std::size_t offset = sizeof(NetworkHeader);
+    bool truncated = false;
+    auto take = [&](std::size_t bytes) -> const char* {
+        offset = (offset + 31) & ~static_cast<std::size_t>(31);
+        if (offset + bytes > mappingSize)
+        {
+            truncated = true;
+            return nullptr;
+        }
+        const char* ptr = base + offset;
+        offset += bytes;
+        return ptr;
+    };
+
+    for (std::uint32_t l = 0; l < header.convLayers; ++l)
+    {
+        ConvLayer layer;
+        layer.inChannels = l == 0 ? kInputPlanes : channels;
+        layer.outChannels = channels;
+        std::size_t count = static_cast<std::size_t>(layer.outChannels) * layer.inChannels * 9;
+
+        if (quantized)
+        {
+            layer.scales = reinterpret_cast<const float*>(take(sizeof(float) * channels));
+            layer.weightsInt8 = reinterpret_cast<const std::int8_t*>(take(count));
+            layer.weights = nullptr;
+        }
+        else
+        {
+            layer.weights = reinterpret_cast<const float*>(take(sizeof(float) * count));
+            layer.weightsInt8 = nullptr;
+            layer.scales = nullptr;
+        }
+        layer.bias = reinterpret_cast<const float*>(take(sizeof(float) * channels));
+        layers.push_back(layer);
+    }
+
+    policyWeights = reinterpret_cast<const float*>(take(sizeof(float) * 2 * channels));
+    policyBias = reinterpret_cast<const float*>(take(sizeof(float) * 2));
+    valueWeights = reinterpret_cast<const float*>(take(sizeof(float) * channels));
+    valueBias = reinterpret_cast<const float*>(take(sizeof(float)));
+
+    if (truncated)
+    {
+        unload();
+        return false;
+    }
+    return true;
+}
+
+void NeuralEvaluator::encode(const BoardState& state, float* planes) const
+{
+    // Układ [pozycja][płaszczyzna]
+    const int area = state.width * state.height;
+    std::fill(planes, planes + kInputPlanes * area, 0.0f);
+
+    // Płaszczyzny 7-12: ile kulek danego koloru przyjdzie w następnej turze
+    float upcoming[6] = {};
+    for (BallColor color : state.nextBalls)
+        upcoming[static_cast<int>(color)] += 1.0f;
+
+    for (int i = 0; i < area; ++i)
+    {
+        float* cell = planes + i * kInputPlanes;
+        int value = state.cells[i];
+        cell[value == 0 ? 6 : value - 1] = 1.0f; // 0-5 kolory, 6 puste
+        std::copy(upcoming, upcoming + 6, cell + 7);
+    }
+}
+
+void NeuralEvaluator::convolve(const ConvLayer& layer, int width, int height, int batch,
+                               const std::vector<float>& input, std::vector<float>& output) const
+{
+    const int area = width * height;
+    const int rowLength = layer.inChannels * 9;
+    const int cout = layer.outChannels;
+    const Kernels& k = kernels();
+
+    output.resize(static_cast<std::size_t>(batch) * area * cout);
+
+    std::vector<float> row(quantized ? 0 : rowLength);
+    std::vector<std::int8_t> rowInt8(quantized ? rowLength : 0);
+    std::vector<std::int8_t> inputInt8(quantized ? static_cast<std::size_t>(area) * layer.inChannels : 0);
+    std::vector<std::int32_t> accInt8(quantized ? cout : 0);
+
+    for (int b = 0; b < batch; ++b)
+    {
+        const float* in = input.data() + static_cast<std::size_t>(b) * area * layer.inChannels;
+        float scale = 1.0f;
+
+        if (quantized)
+        {
+            // Aktywacje po ReLU są nieujemne - jedna skala na całą pozycję
+            float maxValue = *std::max_element(in, in + inputInt8.size());
+            scale = maxValue > 0.0f ? maxValue / 127.0f : 1.0f;
+            float inverse = 1.0f / scale;
+            for (std::size_t i = 0; i < inputInt8.size(); ++i)
+                inputInt8[i] = static_cast<std::int8_t>(in[i] * inverse + 0.5f);
+        }
+
+        for (int p = 0; p < area; ++p)
+        {
+            float* out = output.data() + (static_cast<std::size_t>(b) * area + p) * cout;
+
+            if (quantized)
+            {
+                gatherWindow(inputInt8.data(), layer.inChannels, width, height, p % width, p / width, rowInt8.data());
+                std::fill(accInt8.begin(), accInt8.end(), 0);
+                k.accumulateInt8(rowInt8.data(), rowLength, layer.weightsInt8, cout, accInt8.data());
+                for (int c = 0; c < cout; ++c)
+                    out[c] = std::max(0.0f, accInt8[c] * scale * layer.scales[c] + layer.bias[c]);
+            }
+            else
+            {
+                gatherWindow(in, layer.inChannels, width, height, p % width, p / width, row.data());
+                std::copy(layer.bias, layer.bias + cout, out);
+                k.accumulate(row.data(), rowLength, layer.weights, cout, out);
+                for (int c = 0; c < cout; ++c)
+                    out[c] = std::max(0.0f, out[c]);
+            }
+        }
+    }
+}
+
+void NeuralEvaluator::evaluateBatch(const std::vector<BoardState>& states, std::vector<Evaluation>& results) const
+{
+    results.resize(states.size());
+    if (!isLoaded() || states.empty())
+        return;
+
+    const int width = states[0].width;
+    const int height = states[0].height;
+    const int area = width * height;
+    const int batch = static_cast<int>(states.size());
+
+    std::vector<float> activations(static_cast<std::size_t>(batch) * kInputPlanes * area);
+    for (int b = 0; b < batch; ++b)
+    {
+        encode(states[b], activations.data() + static_cast<std::size_t>(b) * kInputPlanes * area);
+    }
+
+    std::vector<float> next;
+    for (const auto& layer : layers)
+    {
+        convolve(layer, width, height, batch, activations, next);
+        activations.swap(next);
+    }
+
+    for (int b = 0; b < batch; ++b)
+    {
+        const float* features = activations.data() + static_cast<std::size_t>(b) * area * channels;
+        Evaluation& eval = results[b];
+        eval.fromLogits.resize(area);
+        eval.toLogits.resize(area);
+
+        std::vector<float> pooled(channels, 0.0f);
+        for (int p = 0; p < area; ++p)
+        {
+            const float* cell = features + p * channels;
+            float from = policyBias[0];
+            float to = policyBias[1];
+            for (int c = 0; c < channels; ++c)
+            {
+                from += policyWeights[c] * cell[c];
+                to += policyWeights[channels + c] * cell[c];
+                pooled[c] += cell[c];
+            }
+            eval.fromLogits[p] = from;
+            eval.toLogits[p] = to;
+        }
+
+        float value = valueBias[0];
+        for (int c = 0; c < channels; ++c)
+            value += valueWeights[c] * (pooled[c] / area);
+        eval.value = std::tanh(value);
+    }
+}
+
+Evaluation NeuralEvaluator::evaluate(const BoardState& state) const
+{
+    std::vector<Evaluation> results;
+    evaluateBatch({state}, results);
+    return results.empty() ? Evaluation{} : results[0];
+}
+
+float NeuralEvaluator::scoreMove(const Evaluation& eval, const Move& move, int width)
+{
+    return eval.fromLogits[move.fromY * width + move.fromX] + eval.toLogits[move.toY * width + move.toX];
+}
+
+const char* NeuralEvaluator::kernelName()
+{
+    return kernels().name;
+}
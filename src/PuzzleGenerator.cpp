@@ -0,0 +1,626 @@
+#include "../include/PuzzleGenerator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    std::uint32_t encodeMove(const Move& move)
+    {
+        return (move.fromX << 24) | (move.fromY << 16) | (move.toX << 8) | move.toY;
+    }
+
+    // Stan przeszukiwania: różne zbiory ruchów dające co najmniej `goal` linii
+    struct SearchResult
+    {
+        int goal = 0;
+        std::vector<std::vector<std::uint32_t>> keys; // Najwyżej 2 - więcej nie potrzeba
+        std::vector<Move> solution;
+        bool done() const { return keys.size() >= 2; }
+    };
+
+    // Legalne ruchy na pola `targets` dające co najmniej minLines (>= 1) linii, bez liczenia pozostałych.
+    // Zabranie kulki źródłowej może linie tylko przerwać, więc linie z kulką postawioną na celu (przy źródle
+    // na miejscu) ograniczają z góry każdy ruch tego koloru na ten cel - prawie wszystkie pary (cel, kolor)
+    // odpadają, zanim trzeba policzyć obszary pustych pól. visit(move, lines) zwraca false, żeby przerwać.
+    template <typename Visit>
+    void forEachScoringMove(const BoardState& state, int minLines, const std::vector<int>& targets, Visit visit)
+    {
+        const int Colors = 7;
+        std::vector<int> labels;
+        std::vector<unsigned> regionColors;
+
+        // Kolory kulek przylegających do każdego obszaru pustych pól - tylko one mogą do niego wejść
+        auto labelRegions = [&] {
+            regionColors.assign(state.labelEmptyRegions(labels), 0);
+            for (int y = 0; y < state.height; ++y)
+            {
+                for (int x = 0; x < state.width; ++x)
+                {
+                    int color = state.at(x, y);
+                    if (color == 0)
+                        continue;
+                    const int neighbours[4][2] = {{x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+                    for (const auto& n : neighbours)
+                        if (state.isEmpty(n[0], n[1]))
+                            regionColors[labels[n[1] * state.width + n[0]]] |= 1u << color;
+                }
+            }
+        };
+
+        // Czy kulka (x, y) leży obok obszaru `region`, czyli może do niego wejść
+        auto touches = [&](int x, int y, int region) {
+            const int neighbours[4][2] = {{x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+            for (const auto& n : neighbours)
+                if (state.isEmpty(n[0], n[1]) && labels[n[1] * state.width + n[0]] == region)
+                    return true;
+            return false;
+        };
+
+        BoardState work = state;
+        for (int target : targets)
+        {
+            int toX = target % state.width;
+            int toY = target / state.width;
+            if (!state.isEmpty(toX, toY))
+                continue;
+
+            // Linia przez cel musi mieć kulkę swojego koloru tuż obok niego
+            unsigned nearColors = 0;
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                    if (state.isValidPosition(toX + dx, toY + dy))
+                        nearColors |= 1u << state.at(toX + dx, toY + dy);
+
+            for (int color = 1; color < Colors; ++color)
+            {
+                if (!(nearColors & (1u << color)))
+                    continue;
+                work.set(toX, toY, color);
+                int bound = work.linesThrough(toX, toY);
+                work.set(toX, toY, 0);
+                if (bound < minLines)
+                    continue;
+
+                // Rzadki przypadek - obszary i źródła liczymy dopiero teraz
+                if (labels.empty())
+                    labelRegions();
+                int region = labels[target];
+                if (!(regionColors[region] & (1u << color)))
+                    continue;
+                for (int source = 0; source < state.width * state.height; ++source)
+                {
+                    Move move{source % state.width, source / state.width, toX, toY};
+                    if (state.at(move.fromX, move.fromY) != color || !touches(move.fromX, move.fromY, region))
+                        continue;
+                    int lines = PuzzleGenerator::linesAfterMove(work, move);
+                    if (lines >= minLines && !visit(move, lines))
+                        return;
+                }
+            }
+        }
+    }
+
+    std::vector<int> allCells(const BoardState& state)
+    {
+        std::vector<int> cells(state.width * state.height);
+        for (size_t i = 0; i < cells.size(); ++i)
+            cells[i] = static_cast<int>(i);
+        return cells;
+    }
+
+    // Puste pola, na których kulka jakiegoś koloru zrobiłaby linię
+    std::vector<int> lineTargets(const BoardState& state)
+    {
+        std::vector<int> targets;
+        BoardState work = state;
+        for (int target = 0; target < state.width * state.height; ++target)
+        {
+            int x = target % state.width;
+            int y = target / state.width;
+            if (!state.isEmpty(x, y))
+                continue;
+            for (int color = 1; color < 7; ++color)
+            {
+                work.set(x, y, color);
+                bool line = work.linesThrough(x, y) > 0;
+                work.set(x, y, 0);
+                if (line)
+                {
+                    targets.push_back(target);
+                    break;
+                }
+            }
+        }
+        return targets;
+    }
+
+    // Cele, na których po ruchu bez linii może powstać linia: dawne cele z liniami, zwolnione pole
+    // i pola, przez które biegnie linia do pola docelowego (tylko tam zmieniło się sąsiedztwo)
+    std::vector<int> targetsAfterMove(const BoardState& state, const std::vector<int>& before, const Move& move)
+    {
+        std::vector<char> marked(state.width * state.height, 0);
+        std::vector<int> targets;
+        auto add = [&](int x, int y) {
+            if (state.isValidPosition(x, y) && !marked[y * state.width + x])
+            {
+                marked[y * state.width + x] = 1;
+                targets.push_back(y * state.width + x);
+            }
+        };
+
+        for (int target : before)
+            add(target % state.width, target / state.width);
+        add(move.fromX, move.fromY);
+        const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+        for (const auto& d : directions)
+            for (int k = 1; k < state.lineLength; ++k)
+            {
+                add(move.toX + k * d[0], move.toY + k * d[1]);
+                add(move.toX - k * d[0], move.toY - k * d[1]);
+            }
+        return targets;
+    }
+
+    // Kolejność ruchów nie ma znaczenia - porównujemy posortowane zbiory
+    void addSolution(const std::vector<Move>& path, SearchResult& result)
+    {
+        std::vector<std::uint32_t> key;
+        for (const Move& m : path)
+            key.push_back(encodeMove(m));
+        std::sort(key.begin(), key.end());
+
+        if (std::find(result.keys.begin(), result.keys.end(), key) == result.keys.end())
+        {
+            result.keys.push_back(key);
+            if (result.keys.size() == 1)
+                result.solution = path;
+        }
+    }
+
+    // `targets` (jeśli podane) ogranicza cele ostatniego ruchu - poza nimi na pewno nie powstanie linia
+    void search(const BoardState& state, int depth, int linesSoFar, std::vector<Move>& path, SearchResult& result,
+                const std::vector<int>* targets = nullptr)
+    {
+        if (depth == 1)
+        {
+            if (linesSoFar >= result.goal)
+            {
+                // Cel już osiągnięty - pasuje każdy ruch
+                for (const Move& move : state.legalMoves())
+                {
+                    path.push_back(move);
+                    addSolution(path, result);
+                    path.pop_back();
+                    if (result.done())
+                        return;
+                }
+                return;
+            }
+
+            // Ostatni ruch musi dobić do celu - przeglądamy tylko ruchy z liniami
+            forEachScoringMove(state, result.goal - linesSoFar, targets ? *targets : allCells(state),
+                               [&](const Move& move, int) {
+                                   path.push_back(move);
+                                   addSolution(path, result);
+                                   path.pop_back();
+                                   return !result.done();
+                               });
+            return;
+        }
+
+        std::vector<int> before;
+        if (depth == 2)
+            before = lineTargets(state);
+
+        BoardState work = state;
+        for (const Move& move : state.legalMoves())
+        {
+            int lines = PuzzleGenerator::linesAfterMove(work, move);
+            path.push_back(move);
+
+            BoardState next = state;
+            next.applyMove(move);
+            if (lines > 0)
+            {
+                next.clearLines();
+                search(next, depth - 1, linesSoFar + lines, path, result);
+            }
+            else if (depth == 2)
+            {
+                std::vector<int> after = targetsAfterMove(state, before, move);
+                search(next, depth - 1, linesSoFar, path, result, &after);
+            }
+            else
+                search(next, depth - 1, linesSoFar, path, result);
+
+            path.pop_back();
+            if (result.done())
+                return; // Już wiadomo, że rozwiązanie nie jest jedyne
+        }
+    }
+
+    int searchBest(const BoardState& state, int depth)
+    {
+        if (depth == 1)
+        {
+            int best = 0;
+            forEachScoringMove(state, 1, allCells(state), [&best](const Move&, int lines) {
+                best = std::max(best, lines);
+                return best < 4; // Więcej niż 4 kierunki się nie da
+            });
+            return best;
+        }
+
+        BoardState work = state;
+        int best = 0;
+        for (const Move& move : state.legalMoves())
+        {
+            int lines = PuzzleGenerator::linesAfterMove(work, move);
+            if (depth > 1)
+            {
+                BoardState next = state;
+                next.applyMove(move);
+                if (lines > 0)
+                    next.clearLines();
+                lines += searchBest(next, depth - 1);
+            }
+            best = std::max(best, lines);
+        }
+        return best;
+    }
+
+    // Usuwa przypadkowe "prawie linie", żeby jedynymi liniami były te ułożone celowo.
+    // Kulki z `keep` zostają; ruch złożony wyłącznie z nich to zamierzone rozwiązanie.
+    void quietBackground(std::mt19937& rng, BoardState& state, const std::vector<std::pair<int, int>>& keep)
+    {
+        const std::pair<int, int> directions[] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+        auto isKept = [&keep](int x, int y) {
+            return std::find(keep.begin(), keep.end(), std::make_pair(x, y)) != keep.end();
+        };
+
+        for (int pass = 0; pass < 50; ++pass)
+        {
+            bool changed = false;
+            for (const Move& move : state.legalMoves())
+            {
+                if (state.at(move.fromX, move.fromY) == 0 || !state.isEmpty(move.toX, move.toY))
+                    continue; // Ruch nieaktualny po wcześniejszym usunięciu kulki
+                if (PuzzleGenerator::linesAfterMove(state, move) == 0)
+                    continue;
+
+                if (!isKept(move.fromX, move.fromY))
+                {
+                    state.set(move.fromX, move.fromY, 0);
+                    changed = true;
+                    continue;
+                }
+
+                // Przesuwana kulka jest chroniona - usuń jedną z kulek, z którymi tworzyłaby linię
+                int color = state.at(move.fromX, move.fromY);
+                std::vector<std::pair<int, int>> partners;
+                for (auto [dx, dy] : directions)
+                {
+                    for (int sign = -1; sign <= 1; sign += 2)
+                    {
+                        int x = move.toX + sign * dx;
+                        int y = move.toY + sign * dy;
+                        if (state.isValidPosition(x, y) && state.at(x, y) == color &&
+                            !(x == move.fromX && y == move.fromY) && !isKept(x, y))
+                            partners.push_back({x, y});
+                    }
+                }
+                if (partners.empty())
+                    continue;
+
+                auto [px, py] = partners[std::uniform_int_distribution<size_t>(0, partners.size() - 1)(rng)];
+                state.set(px, py, 0);
+                changed = true;
+            }
+            if (!changed)
+                return;
+        }
+    }
+
+    // Losowa plansza bez gotowych linii
+    BoardState randomBackground(std::mt19937& rng, int width, int height)
+    {
+        BoardState state(width, height);
+        std::uniform_real_distribution<float> fillDist(0.0f, 1.0f);
+        std::uniform_int_distribution<int> colorDist(1, 6);
+
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                if (fillDist(rng) < 0.5f)
+                {
+                    state.set(x, y, colorDist(rng));
+                    if (state.longestRunThrough(x, y) >= 3)
+                        state.set(x, y, 0);
+                }
+            }
+        }
+        return state;
+    }
+
+    // Inne kulki tego koloru, które mogłyby dojść do luki, dostają inny kolor
+    void recolorCompetitors(std::mt19937& rng, BoardState& state, int gapX, int gapY, int color,
+                            const std::vector<std::pair<int, int>>& keep)
+    {
+        std::vector<int> labels;
+        state.labelEmptyRegions(labels);
+        int region = labels[gapY * state.width + gapX];
+        std::uniform_int_distribution<int> colorDist(1, 6);
+
+        for (int y = 0; y < state.height; ++y)
+        {
+            for (int x = 0; x < state.width; ++x)
+            {
+                if (state.at(x, y) != color || std::find(keep.begin(), keep.end(), std::make_pair(x, y)) != keep.end())
+                    continue;
+
+                bool touchesRegion = false;
+                const int neighbours[4][2] = {{x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+                for (const auto& n : neighbours)
+                {
+                    if (state.isValidPosition(n[0], n[1]) && labels[n[1] * state.width + n[0]] == region)
+                        touchesRegion = true;
+                }
+                if (!touchesRegion)
+                    continue;
+
+                int replacement = colorDist(rng);
+                if (replacement == color)
+                    replacement = replacement % 6 + 1;
+                state.set(x, y, replacement);
+                if (state.longestRunThrough(x, y) >= 3)
+                    state.set(x, y, 0);
+            }
+        }
+    }
+
+    // Jeden krok wstecz: ułóż linię (czasem dwie krzyżujące się) i wysuń
+    // z niej jedną kulkę na osiągalne pole. Zwraca liczbę linii do odtworzenia.
+    // Kulki ułożonych linii trafiają do `keep`, żeby kolejne kroki ich nie zmieniały.
+    int placeOpenLine(std::mt19937& rng, BoardState& state, std::vector<std::pair<int, int>>& keep)
+    {
+        const std::pair<int, int> directions[] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+        std::uniform_int_distribution<int> colorDist(1, 6);
+        std::uniform_int_distribution<int> dirDist(0, 3);
+        std::uniform_int_distribution<int> xDist(0, state.width - 1);
+        std::uniform_int_distribution<int> yDist(0, state.height - 1);
+        std::uniform_int_distribution<int> cellDist(0, 2);
+
+        for (int attempt = 0; attempt < 20; ++attempt)
+        {
+            BoardState candidate = state;
+            int direction = dirDist(rng);
+            auto [dx, dy] = directions[direction];
+            int x = xDist(rng);
+            int y = yDist(rng);
+            if (!candidate.isValidPosition(x + 2 * dx, y + 2 * dy))
+                continue;
+
+            int color = colorDist(rng);
+            std::vector<std::pair<int, int>> placed;
+            for (int i = 0; i < 3; ++i)
+            {
+                candidate.set(x + i * dx, y + i * dy, color);
+                placed.push_back({x + i * dx, y + i * dy});
+            }
+
+            // Luka w środku - linię da się wtedy domknąć tylko w jednym miejscu
+            int gapX = x + dx;
+            int gapY = y + dy;
+
+            // Co trzecia zagadka: druga linia przez tę samą lukę - jeden ruch, dwie linie
+            int lines = 1;
+            if (cellDist(rng) == 0)
+            {
+                auto [cx, cy] = directions[(direction + 1 + cellDist(rng)) % 4];
+                if (candidate.isValidPosition(gapX + cx, gapY + cy) && candidate.isValidPosition(gapX - cx, gapY - cy))
+                {
+                    candidate.set(gapX + cx, gapY + cy, color);
+                    candidate.set(gapX - cx, gapY - cy, color);
+                    placed.push_back({gapX + cx, gapY + cy});
+                    placed.push_back({gapX - cx, gapY - cy});
+                    lines = 2;
+                }
+            }
+            candidate.set(gapX, gapY, 0);
+
+            auto reachable = candidate.reachableFrom(gapX, gapY);
+            if (reachable.empty())
+                continue;
+
+            auto [px, py] = reachable[std::uniform_int_distribution<size_t>(0, reachable.size() - 1)(rng)];
+            candidate.set(px, py, color);
+            placed.push_back({px, py});
+
+            std::vector<std::pair<int, int>> protectedCells = keep;
+            protectedCells.insert(protectedCells.end(), placed.begin(), placed.end());
+            recolorCompetitors(rng, candidate, gapX, gapY, color, protectedCells);
+
+            if (candidate.findAllLines().empty())
+            {
+                state = candidate;
+                keep = protectedCells;
+                return lines;
+            }
+        }
+        return 0;
+    }
+}
+
+int PuzzleGenerator::linesAfterMove(BoardState& state, const Move& move)
+{
+    // Zakłada planszę bez linii - nowe linie mogą przechodzić tylko przez pole docelowe
+    int value = state.at(move.fromX, move.fromY);
+    state.set(move.fromX, move.fromY, 0);
+    state.set(move.toX, move.toY, value);
+
+    int lines = state.linesThrough(move.toX, move.toY);
+
+    state.set(move.toX, move.toY, 0);
+    state.set(move.fromX, move.fromY, value);
+    return lines;
+}
+
+int PuzzleGenerator::bestLines(const BoardState& state, int moves)
+{
+    return moves > 0 ? searchBest(state, moves) : 0;
+}
+
+PuzzleAnalysis PuzzleGenerator::analyze(const BoardState& state, int moves, int goalLines)
+{
+    PuzzleAnalysis analysis;
+    analysis.bestShorter = bestLines(state, moves - 1);
+    if (analysis.bestShorter >= goalLines)
+        return analysis; // Da się szybciej - nie ma sensu szukać dalej
+
+    SearchResult result;
+    result.goal = goalLines;
+    std::vector<Move> path;
+    search(state, moves, 0, path, result);
+
+    analysis.solutions = static_cast<int>(result.keys.size());
+    analysis.solution = result.solution;
+    return analysis;
+}
+
+bool PuzzleGenerator::generate(std::mt19937& rng, int width, int height, int moves, Puzzle& puzzle)
+{
+    BoardState state = randomBackground(rng, width, height);
+
+    int goalLines = 0;
+    std::vector<std::pair<int, int>> keep;
+    for (int step = 0; step < moves; ++step)
+    {
+        int lines = placeOpenLine(rng, state, keep);
+        if (lines == 0)
+            return false;
+        goalLines += lines;
+    }
+    quietBackground(rng, state, keep);
+
+    // Każdy ruch musi być potrzebny, a rozwiązanie jedyne
+    PuzzleAnalysis analysis = analyze(state, moves, goalLines);
+    if (analysis.bestShorter >= goalLines || analysis.solutions != 1)
+        return false;
+
+    puzzle.board = state;
+    puzzle.moves = moves;
+    puzzle.goalLines = goalLines;
+    puzzle.solution = analysis.solution;
+    return true;
+}
+
+int PuzzleGenerator::run(const std::string& path, int count, int threads, int moves)
+{
+    threads = std::max(1, threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::atomic<int> produced(0);
+    std::atomic<long> attempts(0);
+    std::mutex resultMutex;
+    std::vector<Puzzle> puzzles;
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()) + t);
+            Puzzle puzzle;
+            while (produced < count)
+            {
+                attempts++;
+                if (!generate(rng, 10, 10, moves, puzzle))
+                    continue;
+
+                if (produced++ < count)
+                {
+                    std::lock_guard<std::mutex> lock(resultMutex);
+                    puzzles.push_back(puzzle);
+                }
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    if (!PuzzleBank::append(path, puzzles))
+    {
+        std::cerr << "Nie można zapisać zagadek do: " << path << std::endl;
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Zagadki: " << puzzles.size() << ", próby: " << attempts
+              << ", zagadek/min: " << static_cast<long>(puzzles.size() * 60.0 / std::max(seconds, 1e-9)) << std::endl;
+    return 0;
+}
+
+bool PuzzleBank::append(const std::string& path, const std::vector<Puzzle>& puzzles)
+{
+    bool exists = std::ifstream(path).good();
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (!file)
+        return false;
+    if (!exists)
+        file.write("KPZ1", 4);
+
+    for (const auto& puzzle : puzzles)
+    {
+        std::vector<std::uint8_t> bytes = {
+            static_cast<std::uint8_t>(puzzle.board.width), static_cast<std::uint8_t>(puzzle.board.height),
+            static_cast<std::uint8_t>(puzzle.moves), static_cast<std::uint8_t>(puzzle.goalLines)};
+        for (int value : puzzle.board.cells)
+            bytes.push_back(static_cast<std::uint8_t>(value));
+        for (const Move& move : puzzle.solution)
+        {
+            bytes.push_back(static_cast<std::uint8_t>(move.fromX));
+            bytes.push_back(static_cast<std::uint8_t>(move.fromY));
+            bytes.push_back(static_cast<std::uint8_t>(move.toX));
+            bytes.push_back(static_cast<std::uint8_t>(move.toY));
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+    return static_cast<bool>(file);
+}
+
+std::vector<Puzzle> PuzzleBank::load(const std::string& path)
+{
+    std::vector<Puzzle> puzzles;
+    std::ifstream file(path, std::ios::binary);
+    char magic[4];
+    if (!file.read(magic, 4) || std::memcmp(magic, "KPZ1", 4) != 0)
+        return puzzles;
+
+    std::uint8_t header[4];
+    while (file.read(reinterpret_cast<char*>(header), sizeof(header)))
+    {
+        Puzzle puzzle;
+        puzzle.board = BoardState(header[0], header[1]);
+        puzzle.moves = header[2];
+        puzzle.goalLines = header[3];
+
+        std::vector<std::uint8_t> cells(header[0] * header[1]);
+        std::vector<std::uint8_t> solution(header[2] * 4);
+        if (!file.read(reinterpret_cast<char*>(cells.data()), cells.size()) ||
+            !file.read(reinterpret_cast<char*>(solution.data()), solution.size()))
+            break;
+
+        std::copy(cells.begin(), cells.end(), puzzle.board.cells.begin());
+        for (size_t i = 0; i + 3 < solution.size(); i += 4)
+            puzzle.solution.push_back({solution[i], solution[i + 1], solution[i + 2], solution[i + 3]});
+        puzzles.push_back(puzzle);
+    }
+    return puzzles;
+}
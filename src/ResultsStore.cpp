@@ -0,0 +1,351 @@
+#include "../include/ResultsStore.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const char Magic[4] = {'K', 'R', 'S', '1'};
+    const std::uint32_t Version = 1;
+    const size_t HeaderSize = 16; // Magic, wersja, rozmiar rekordu, zarezerwowane
+    const int MaxWriteAttempts = 3;
+
+    bool writeAll(int fd, const void* data, size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            ssize_t written = ::write(fd, bytes, size);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+}
+
+ResultsStore::ResultsStore()
+    : fd(-1), mapped(nullptr), mappedCount(0), mappedBytes(0), appendedTotal(0), committedTotal(0), failedTotal(0),
+      stopping(false)
+{
+}
+
+ResultsStore::~ResultsStore()
+{
+    close();
+}
+
+std::uint32_t ResultsStore::checksumOf(const ResultRecord& record)
+{
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&record);
+    std::uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(ResultRecord, checksum); ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool ResultsStore::open(const std::string& filePath)
+{
+    close();
+    std::lock_guard<std::mutex> lock(mutex);
+
+    int file = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (file < 0)
+    {
+        std::cerr << "Nie można otworzyć bazy wyników " << filePath << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    // Jeden piszący proces na plik - inaczej dopisywane bloki mogłyby się przeplatać
+    if (::flock(file, LOCK_EX | LOCK_NB) != 0)
+    {
+        std::cerr << "Baza wyników " << filePath << " jest używana przez inny proces" << std::endl;
+        ::close(file);
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(file, &info) != 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    std::uint32_t header[4] = {0, Version, static_cast<std::uint32_t>(sizeof(ResultRecord)), 0};
+    if (fileSize == 0)
+    {
+        // Nowy plik - tylko nagłówek
+        std::memcpy(header, Magic, sizeof(Magic));
+        if (!writeAll(file, header, sizeof(header)))
+        {
+            ::close(file);
+            return false;
+        }
+        fileSize = HeaderSize;
+    }
+    else
+    {
+        // Istniejący plik nigdy nie jest czyszczony - krótszy od nagłówka albo obcy odrzucamy
+        if (fileSize < HeaderSize || ::pread(file, header, HeaderSize, 0) != static_cast<ssize_t>(HeaderSize) ||
+            std::memcmp(header, Magic, sizeof(Magic)) != 0 || header[1] != Version || header[2] != sizeof(ResultRecord))
+        {
+            std::cerr << "Nieznany format bazy wyników: " << filePath << std::endl;
+            ::close(file);
+            return false;
+        }
+    }
+
+    void* view = nullptr;
+    if (fileSize > HeaderSize)
+    {
+        view = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, file, 0);
+        if (view == MAP_FAILED)
+        {
+            ::close(file);
+            return false;
+        }
+    }
+
+    // Rekordy poprawne aż do pierwszego z błędną sumą - dalej jest urwany zapis
+    const auto* records = view ? reinterpret_cast<const ResultRecord*>(static_cast<const char*>(view) + HeaderSize) : nullptr;
+    size_t count = (fileSize - HeaderSize) / sizeof(ResultRecord);
+    size_t valid = 0;
+    while (valid < count && checksumOf(records[valid]) == records[valid].checksum)
+        valid++;
+
+    size_t validSize = HeaderSize + valid * sizeof(ResultRecord);
+    if (validSize != fileSize)
+    {
+        std::cerr << "Baza wyników: obcięto " << (fileSize - validSize) << " B uszkodzonego końca" << std::endl;
+        if (::ftruncate(file, static_cast<off_t>(validSize)) != 0)
+        {
+            if (view)
+                ::munmap(view, fileSize);
+            ::close(file);
+            return false;
+        }
+    }
+    ::lseek(file, static_cast<off_t>(validSize), SEEK_SET);
+
+    fd = file;
+    path = filePath;
+    mapped = records;
+    mappedCount = valid;
+    mappedBytes = view ? fileSize : 0;
+    appended.clear();
+    scores.clear();
+    seeds.clear();
+    for (size_t row = 0; row < mappedCount; ++row)
+        indexRow(static_cast<std::uint32_t>(row));
+
+    pending.clear();
+    appendedTotal = committedTotal = failedTotal = 0;
+    stopping = false;
+    committer = std::thread(&ResultsStore::commitLoop, this);
+    return true;
+}
+
+void ResultsStore::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0)
+            return;
+        stopping = true;
+    }
+    pendingChanged.notify_all();
+    if (committer.joinable())
+        committer.join();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (mapped)
+        ::munmap(const_cast<char*>(reinterpret_cast<const char*>(mapped) - HeaderSize), mappedBytes);
+    mapped = nullptr;
+    mappedCount = 0;
+    mappedBytes = 0;
+    // Indeksy wskazują wiersze zamkniętego pliku - zapytania po close() nie mogą ich widzieć
+    appended.clear();
+    scores.clear();
+    seeds.clear();
+    pending.clear();
+    ::close(fd); // Zwalnia też flock
+    fd = -1;
+}
+
+bool ResultsStore::isOpen()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return fd >= 0;
+}
+
+const ResultRecord& ResultsStore::record(std::uint32_t row) const
+{
+    return row < mappedCount ? mapped[row] : appended[row - mappedCount];
+}
+
+void ResultsStore::indexRow(std::uint32_t row)
+{
+    const ResultRecord& result = record(row);
+    ScoreIndex& index = scores[result.variant];
+    if (index.entries.empty() || result.score > index.best)
+        index.best = result.score;
+    index.entries.push_back({result.score, row});
+    seeds[result.seed].push_back(row);
+}
+
+void ResultsStore::append(ResultRecord result)
+{
+    if (result.timestamp == 0)
+        result.timestamp = static_cast<std::int64_t>(std::time(nullptr));
+    result.checksum = checksumOf(result);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fd < 0)
+            return;
+        appended.push_back(result);
+        indexRow(static_cast<std::uint32_t>(mappedCount + appended.size() - 1));
+        pending.push_back(result);
+        appendedTotal++;
+    }
+    pendingChanged.notify_one();
+}
+
+void ResultsStore::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    std::uint64_t target = appendedTotal;
+    committedChanged.wait(lock, [&] { return committedTotal + failedTotal >= target || fd < 0; });
+}
+
+void ResultsStore::commitLoop()
+{
+    std::vector<ResultRecord> batch;
+    // Koniec ostatniego trwale zapisanego rekordu - tu wraca plik po nieudanym zapisie
+    off_t committedEnd = ::lseek(fd, 0, SEEK_CUR);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        pendingChanged.wait(lock, [&] { return !pending.empty() || stopping; });
+        if (pending.empty() && stopping)
+            break;
+
+        // Wszystko, co się uzbierało podczas poprzedniego zapisu, idzie jednym blokiem
+        batch.swap(pending);
+        lock.unlock();
+
+        size_t bytes = batch.size() * sizeof(ResultRecord);
+        bool ok = false;
+        for (int attempt = 0; attempt < MaxWriteAttempts && !ok; ++attempt)
+        {
+            if (attempt > 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(100 * attempt));
+            ok = writeAll(fd, batch.data(), bytes) && ::fdatasync(fd) == 0;
+            if (ok)
+                break;
+
+            std::cerr << "Baza wyników: błąd zapisu " << path << ": " << std::strerror(errno) << std::endl;
+            // Urwany blok zostawiłby niewyrównany ogon, przez który przy otwarciu
+            // przepadłyby wszystkie późniejsze rekordy - plik wraca do ostatniego pełnego zapisu
+            if (::ftruncate(fd, committedEnd) != 0 || ::lseek(fd, committedEnd, SEEK_SET) != committedEnd)
+                std::cerr << "Baza wyników: nie można cofnąć urwanego zapisu: " << std::strerror(errno) << std::endl;
+        }
+
+        lock.lock();
+        // Zatwierdzone jest tylko to, co w całości trafiło na dysk; reszta zostaje tylko w pamięci
+        if (ok)
+        {
+            committedEnd += static_cast<off_t>(bytes);
+            committedTotal += batch.size();
+        }
+        else
+        {
+            failedTotal += batch.size();
+        }
+        batch.clear();
+        committedChanged.notify_all();
+    }
+}
+
+size_t ResultsStore::size()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return mappedCount + appended.size();
+}
+
+void ResultsStore::sortIndex(ScoreIndex& index)
+{
+    if (index.sorted == index.entries.size())
+        return;
+    // Posortowany jest tylko nowy ogon; scalenie z resztą jest liniowe
+    auto middle = index.entries.begin() + static_cast<std::ptrdiff_t>(index.sorted);
+    std::sort(middle, index.entries.end());
+    std::inplace_merge(index.entries.begin(), middle, index.entries.end());
+    index.sorted = index.entries.size();
+}
+
+std::vector<ResultRecord> ResultsStore::topK(std::uint16_t variant, size_t k)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ResultRecord> result;
+    auto found = scores.find(variant);
+    if (found == scores.end())
+        return result;
+
+    sortIndex(found->second);
+    const auto& entries = found->second.entries;
+    for (auto it = entries.rbegin(); it != entries.rend() && result.size() < k; ++it)
+        result.push_back(record(it->second));
+    return result;
+}
+
+std::int32_t ResultsStore::percentile(std::uint16_t variant, double p)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = scores.find(variant);
+    if (found == scores.end() || found->second.entries.empty())
+        return 0;
+
+    sortIndex(found->second);
+    const auto& entries = found->second.entries;
+    double rank = std::clamp(p, 0.0, 100.0) / 100.0 * (entries.size() - 1);
+    return entries[static_cast<size_t>(std::lround(rank))].first;
+}
+
+std::int32_t ResultsStore::best(std::uint16_t variant)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = scores.find(variant);
+    return found == scores.end() ? 0 : found->second.best;
+}
+
+std::vector<ResultRecord> ResultsStore::bySeed(std::uint32_t seed)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ResultRecord> result;
+    auto found = seeds.find(seed);
+    if (found == seeds.end())
+        return result;
+    for (std::uint32_t row : found->second)
+        result.push_back(record(row));
+    return result;
+}
@@ -0,0 +1,634 @@
+#include "../include/RetrogradeSolver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    const char Magic[4] = {'K', 'S', 'V', '1'};
+    const std::uint32_t Version = 1;
+    const std::uint16_t NoMove = 0xFFFF;
+    const int MaxCells = 16;
+
+    struct TableHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint16_t width, height, colors, reserved;
+        std::uint32_t horizon;
+    };
+    static_assert(sizeof(TableHeader) == 20, "TableHeader musi mieć 20 bajtów");
+
+    // Równoległa pętla po [0, count) w porcjach - wątki biorą kolejne porcje z licznika
+    template <typename Body>
+    void parallelFor(size_t count, int threads, const Body& body)
+    {
+        const size_t chunk = 2048;
+        std::atomic<size_t> next(0);
+        auto worker = [&] {
+            for (size_t begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk))
+                body(begin, std::min(count, begin + chunk));
+        };
+
+        std::vector<std::thread> workers;
+        for (int t = 1; t < threads && static_cast<size_t>(t) * chunk < count; ++t)
+            workers.emplace_back(worker);
+        worker();
+        for (auto& thread : workers)
+            thread.join();
+    }
+
+    class Solver
+    {
+    public:
+        Solver(const SolverVariant& variant, int threads)
+            : width(variant.width), height(variant.height), cells(variant.width * variant.height),
+              colors(variant.colors), base(variant.colors + 1), pairs(variant.colors * variant.colors),
+              threads(threads), boards(1)
+        {
+            for (int i = 0; i < cells; ++i)
+            {
+                powers[i] = boards;
+                boards *= static_cast<std::uint32_t>(base);
+            }
+        }
+
+        std::uint32_t getBoards() const { return boards; }
+        int getPairs() const { return pairs; }
+
+        void prepare()
+        {
+            flags.assign(boards, 0);
+            settled.assign(boards, 0);
+            layers.assign(cells + 1, {});
+
+            // Flagi i wynik usuwania linii liczone raz, równolegle; warstwy zbierane potem po kolei
+            parallelFor(boards, threads, [&](size_t begin, size_t end) {
+                std::int8_t board[MaxCells];
+                for (size_t index = begin; index < end; ++index)
+                {
+                    decode(static_cast<std::uint32_t>(index), board);
+                    flags[index] = classify(board);
+                    settled[index] = (flags[index] & LineFree) ? static_cast<std::uint32_t>(index) : settle(board);
+                }
+            });
+            for (std::uint32_t index = 0; index < boards; ++index)
+            {
+                if (flags[index] & LineFree)
+                    layers[ballCount(index)].push_back(index);
+            }
+
+            size_t entries = static_cast<size_t>(boards) * pairs;
+            values.assign(entries, 0.0f);
+            survival.assign(entries, 0.0f);
+            moves.assign(entries, NoMove);
+            survivalAverage.assign(boards, 0.0f);
+            // Po 0 turach każda plansza bez końca gry "przetrwała"
+            valueAverage.assign(boards, 1.0f);
+        }
+
+        // Jedna tura horyzontu; zwraca największą zmianę wartości
+        double iterate()
+        {
+            for (const auto& layer : layers)
+            {
+                parallelFor(layer.size(), threads, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                        spawnValues(layer[i]);
+                });
+            }
+
+            std::vector<double> changes;
+            std::mutex changesMutex;
+            for (const auto& layer : layers)
+            {
+                parallelFor(layer.size(), threads, [&](size_t begin, size_t end) {
+                    double change = 0.0;
+                    for (size_t i = begin; i < end; ++i)
+                        change = std::max(change, bestMoves(layer[i]));
+                    std::lock_guard<std::mutex> lock(changesMutex);
+                    changes.push_back(change);
+                });
+            }
+
+            for (const auto& layer : layers)
+            {
+                for (std::uint32_t board : layer)
+                    valueAverage[board] = average(values, board);
+            }
+            return changes.empty() ? 0.0 : *std::max_element(changes.begin(), changes.end());
+        }
+
+        // Pozycje startowe mogą mieć gotowe linie (znikają po pierwszym ruchu) - liczymy je raz, na końcu
+        void finish()
+        {
+            parallelFor(boards, threads, [&](size_t begin, size_t end) {
+                for (size_t index = begin; index < end; ++index)
+                {
+                    if (!(flags[index] & LineFree))
+                        bestMoves(static_cast<std::uint32_t>(index));
+                }
+            });
+        }
+
+        bool write(const std::string& path, int horizon) const
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+
+            TableHeader header = {};
+            std::memcpy(header.magic, Magic, sizeof(Magic));
+            header.version = Version;
+            header.width = static_cast<std::uint16_t>(width);
+            header.height = static_cast<std::uint16_t>(height);
+            header.colors = static_cast<std::uint16_t>(colors);
+            header.horizon = static_cast<std::uint32_t>(horizon);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+            out.write(reinterpret_cast<const char*>(moves.data()), moves.size() * sizeof(std::uint16_t));
+            return static_cast<bool>(out);
+        }
+
+        float startValue() const
+        {
+            // Średnio po wszystkich planszach bez linii i bez końca gry - orientacyjnie
+            double sum = 0.0;
+            size_t count = 0;
+            for (const auto& layer : layers)
+            {
+                for (std::uint32_t board : layer)
+                {
+                    if (!(flags[board] & Terminal))
+                    {
+                        sum += valueAverage[board];
+                        count++;
+                    }
+                }
+            }
+            return count ? static_cast<float>(sum / count) : 0.0f;
+        }
+
+    private:
+        enum Flag : std::uint8_t
+        {
+            LineFree = 1,
+            Terminal = 2 // Bez linii, ale koniec gry: mniej niż 2 puste pola albo brak ruchu
+        };
+
+        int width, height, cells, colors, base, pairs, threads;
+        std::uint32_t boards;
+        std::uint32_t powers[MaxCells];
+
+        std::vector<std::uint8_t> flags;
+        std::vector<std::uint32_t> settled; // Plansza po usunięciu wszystkich linii
+        std::vector<std::vector<std::uint32_t>> layers; // Plansze bez linii wg liczby kulek
+        std::vector<float> values;          // V(plansza, następne kulki) przed ruchem
+        std::vector<float> survival;        // S(plansza, kulki do dołożenia) po ruchu i usunięciu linii
+        std::vector<std::uint16_t> moves;
+        std::vector<float> valueAverage;    // V z poprzedniej tury, średnio po nowych kulkach
+        std::vector<float> survivalAverage; // S z bieżącej tury, średnio po kulkach
+
+        void decode(std::uint32_t index, std::int8_t* board) const
+        {
+            for (int i = 0; i < cells; ++i)
+            {
+                board[i] = static_cast<std::int8_t>(index % base);
+                index /= base;
+            }
+        }
+
+        std::uint32_t encode(const std::int8_t* board) const
+        {
+            std::uint32_t index = 0;
+            for (int i = cells - 1; i >= 0; --i)
+                index = index * base + board[i];
+            return index;
+        }
+
+        int ballCount(std::uint32_t index) const
+        {
+            int count = 0;
+            for (int i = 0; i < cells; ++i, index /= base)
+                count += index % base != 0;
+            return count;
+        }
+
+        float average(const std::vector<float>& table, std::uint32_t board) const
+        {
+            const float* entry = &table[static_cast<size_t>(board) * pairs];
+            double sum = 0.0;
+            for (int pair = 0; pair < pairs; ++pair)
+                sum += entry[pair];
+            return static_cast<float>(sum / pairs);
+        }
+
+        // Ta sama kolejność co BoardState::findAllLines: pole należące już do linii
+        // nie zaczyna kolejnego sprawdzania. Zwraca, czy coś usunięto.
+        bool clearLines(std::int8_t* board) const
+        {
+            static const int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {-1, 1}};
+            bool checked[MaxCells] = {};
+            bool marked[MaxCells] = {};
+            bool found = false;
+
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    int value = board[y * width + x];
+                    if (value == 0 || checked[y * width + x])
+                        continue;
+
+                    for (const auto& direction : directions)
+                    {
+                        int dx = direction[0], dy = direction[1];
+                        int startX = x, startY = y;
+                        while (inside(startX - dx, startY - dy) && board[(startY - dy) * width + startX - dx] == value)
+                        {
+                            startX -= dx;
+                            startY -= dy;
+                        }
+                        int length = 0;
+                        for (int cx = startX, cy = startY; inside(cx, cy) && board[cy * width + cx] == value;
+                             cx += dx, cy += dy)
+                            length++;
+                        if (length < 3)
+                            continue;
+
+                        found = true;
+                        for (int i = 0; i < length; ++i)
+                        {
+                            int cell = (startY + i * dy) * width + startX + i * dx;
+                            checked[cell] = true;
+                            marked[cell] = true;
+                        }
+                    }
+                }
+            }
+
+            for (int i = 0; i < cells; ++i)
+            {
+                if (marked[i])
+                    board[i] = 0;
+            }
+            return found;
+        }
+
+        bool inside(int x, int y) const
+        {
+            return x >= 0 && x < width && y >= 0 && y < height;
+        }
+
+        bool hasMoves(const std::int8_t* board) const
+        {
+            // Jak BoardState::hasAvailableMoves: kulka z pustym sąsiadem
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    if (board[y * width + x] == 0)
+                        continue;
+                    if ((x > 0 && board[y * width + x - 1] == 0) || (x + 1 < width && board[y * width + x + 1] == 0) ||
+                        (y > 0 && board[(y - 1) * width + x] == 0) || (y + 1 < height && board[(y + 1) * width + x] == 0))
+                        return true;
+                }
+            }
+            return false;
+        }
+
+        std::uint8_t classify(const std::int8_t* board) const
+        {
+            std::int8_t copy[MaxCells];
+            std::copy(board, board + cells, copy);
+            if (clearLines(copy))
+                return 0;
+
+            int empty = static_cast<int>(std::count(board, board + cells, 0));
+            return LineFree | ((empty < 2 || !hasMoves(board)) ? Terminal : 0);
+        }
+
+        // Usuwa linie aż do skutku (jak kolejne przebiegi removeLinesAndUpdateScore)
+        std::uint32_t settle(std::int8_t* board) const
+        {
+            while (clearLines(board))
+            {
+            }
+            return encode(board);
+        }
+
+        // Wartość planszy tuż po dołożeniu kulek, średnio po następnej parze kulek
+        float afterSpawn(std::uint32_t index) const
+        {
+            if (flags[index] & LineFree)
+                return (flags[index] & Terminal) ? 0.0f : valueAverage[index];
+
+            // Reakcja łańcuchowa: usunięcie linii i kolejne dokładanie - mniej kulek, warstwa już policzona
+            return survivalAverage[settled[index]];
+        }
+
+        // S(plansza, kulki): średnio po wszystkich uporządkowanych parach pustych pól
+        void spawnValues(std::uint32_t index)
+        {
+            std::int8_t board[MaxCells];
+            decode(index, board);
+            int empty[MaxCells];
+            int emptyCount = 0;
+            for (int i = 0; i < cells; ++i)
+            {
+                if (board[i] == 0)
+                    empty[emptyCount++] = i;
+            }
+
+            float* entry = &survival[static_cast<size_t>(index) * pairs];
+            for (int first = 0; first < colors; ++first)
+            {
+                for (int second = 0; second < colors; ++second)
+                {
+                    double sum = 0.0;
+                    long outcomes = 0;
+                    for (int a = 0; a < emptyCount; ++a)
+                    {
+                        std::uint32_t withFirst = index + (first + 1) * powers[empty[a]];
+                        if (emptyCount == 1)
+                        {
+                            // Jedno wolne pole - trafia tam tylko pierwsza kulka
+                            sum += afterSpawn(withFirst);
+                            outcomes++;
+                            continue;
+                        }
+                        for (int b = 0; b < emptyCount; ++b)
+                        {
+                            if (b == a)
+                                continue;
+                            sum += afterSpawn(withFirst + (second + 1) * powers[empty[b]]);
+                            outcomes++;
+                        }
+                    }
+                    entry[first * colors + second] = outcomes ? static_cast<float>(sum / outcomes) : 0.0f;
+                }
+            }
+            survivalAverage[index] = average(survival, index);
+        }
+
+        // V(plansza, kulki) = max po ruchach S(po ruchu, kulki); zwraca zmianę wartości
+        double bestMoves(std::uint32_t index)
+        {
+            std::int8_t board[MaxCells];
+            decode(index, board);
+
+            // Obszary pustych pól - kulka może wejść na każde pole obszaru, z którym sąsiaduje
+            int region[MaxCells];
+            std::fill(region, region + cells, -1);
+            int regions = 0;
+            int stack[MaxCells];
+            for (int i = 0; i < cells; ++i)
+            {
+                if (board[i] != 0 || region[i] >= 0)
+                    continue;
+                int top = 0;
+                stack[top++] = i;
+                region[i] = regions;
+                while (top > 0)
+                {
+                    int cell = stack[--top];
+                    int x = cell % width, y = cell / width;
+                    const int neighbours[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+                    for (const auto& neighbour : neighbours)
+                    {
+                        if (!inside(neighbour[0], neighbour[1]))
+                            continue;
+                        int next = neighbour[1] * width + neighbour[0];
+                        if (board[next] == 0 && region[next] < 0)
+                        {
+                            region[next] = regions;
+                            stack[top++] = next;
+                        }
+                    }
+                }
+                regions++;
+            }
+
+            float best[MaxCells * MaxCells];
+            std::uint16_t bestMove[MaxCells * MaxCells];
+            std::fill(best, best + pairs, 0.0f);
+            std::fill(bestMove, bestMove + pairs, NoMove);
+
+            for (int from = 0; from < cells; ++from)
+            {
+                if (board[from] == 0)
+                    continue;
+                int x = from % width, y = from / width;
+                bool adjacent[MaxCells] = {};
+                const int neighbours[4][2] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+                for (const auto& neighbour : neighbours)
+                {
+                    if (inside(neighbour[0], neighbour[1]) && board[neighbour[1] * width + neighbour[0]] == 0)
+                        adjacent[region[neighbour[1] * width + neighbour[0]]] = true;
+                }
+
+                for (int to = 0; to < cells; ++to)
+                {
+                    if (board[to] != 0 || !adjacent[region[to]])
+                        continue;
+
+                    std::uint32_t moved = settled[index - board[from] * powers[from] + board[from] * powers[to]];
+
+                    const float* outcome = &survival[static_cast<size_t>(moved) * pairs];
+                    for (int pair = 0; pair < pairs; ++pair)
+                    {
+                        if (bestMove[pair] == NoMove || outcome[pair] > best[pair])
+                        {
+                            best[pair] = outcome[pair];
+                            bestMove[pair] = static_cast<std::uint16_t>(from * cells + to);
+                        }
+                    }
+                }
+            }
+
+            double change = 0.0;
+            float* entry = &values[static_cast<size_t>(index) * pairs];
+            std::uint16_t* entryMoves = &moves[static_cast<size_t>(index) * pairs];
+            for (int pair = 0; pair < pairs; ++pair)
+            {
+                change = std::max(change, static_cast<double>(std::fabs(entry[pair] - best[pair])));
+                entry[pair] = best[pair];
+                entryMoves[pair] = bestMove[pair];
+            }
+            return change;
+        }
+    };
+}
+
+SolverTable::SolverTable()
+    : mapped(nullptr), mappedBytes(0), horizon(0), pairs(0), powers{}, values(nullptr), moves(nullptr)
+{
+}
+
+SolverTable::~SolverTable()
+{
+    close();
+}
+
+bool SolverTable::open(const std::string& path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        std::cerr << "Nie można otworzyć tablicy solvera: " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(TableHeader))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // Mapowanie zostaje ważne po zamknięciu deskryptora
+    if (view == MAP_FAILED)
+        return false;
+
+    TableHeader header;
+    std::memcpy(&header, view, sizeof(header));
+    std::uint64_t boards = 1;
+    bool valid = std::memcmp(header.magic, Magic, sizeof(Magic)) == 0 && header.version == Version &&
+                 header.width * header.height <= MaxCells && header.colors >= 1 && header.colors <= 6;
+    if (valid)
+    {
+        for (int i = 0; i < header.width * header.height; ++i)
+        {
+            powers[i] = boards;
+            boards *= header.colors + 1u;
+        }
+        std::uint64_t entries = boards * header.colors * header.colors;
+        valid = size == sizeof(TableHeader) + entries * (sizeof(float) + sizeof(std::uint16_t));
+    }
+    if (!valid)
+    {
+        std::cerr << "Nieprawidłowa tablica solvera: " << path << std::endl;
+        ::munmap(view, size);
+        return false;
+    }
+
+    mapped = view;
+    mappedBytes = size;
+    variant.width = header.width;
+    variant.height = header.height;
+    variant.colors = header.colors;
+    horizon = static_cast<int>(header.horizon);
+    pairs = header.colors * header.colors;
+    values = reinterpret_cast<const float*>(static_cast<const char*>(view) + sizeof(TableHeader));
+    moves = reinterpret_cast<const std::uint16_t*>(values + boards * pairs);
+    return true;
+}
+
+void SolverTable::close()
+{
+    if (mapped)
+        ::munmap(mapped, mappedBytes);
+    mapped = nullptr;
+    mappedBytes = 0;
+    values = nullptr;
+    moves = nullptr;
+}
+
+bool SolverTable::matches(const BoardState& state) const
+{
+    if (!mapped || state.width != variant.width || state.height != variant.height || state.nextBalls.size() != 2)
+        return false;
+    for (int cell : state.cells)
+    {
+        if (cell < 0 || cell > variant.colors)
+            return false;
+    }
+    return static_cast<int>(state.nextBalls[0]) < variant.colors && static_cast<int>(state.nextBalls[1]) < variant.colors;
+}
+
+size_t SolverTable::entryOf(const BoardState& state) const
+{
+    std::uint64_t board = 0;
+    for (size_t i = 0; i < state.cells.size(); ++i)
+        board += state.cells[i] * powers[i];
+    int pair = static_cast<int>(state.nextBalls[0]) * variant.colors + static_cast<int>(state.nextBalls[1]);
+    return static_cast<size_t>(board * pairs + pair);
+}
+
+float SolverTable::value(const BoardState& state) const
+{
+    return matches(state) ? values[entryOf(state)] : 0.0f;
+}
+
+Move SolverTable::bestMove(const BoardState& state) const
+{
+    if (!matches(state))
+        return {-1, -1, -1, -1};
+
+    std::uint16_t code = moves[entryOf(state)];
+    if (code == NoMove)
+        return {-1, -1, -1, -1};
+    int cells = variant.width * variant.height;
+    int from = code / cells, to = code % cells;
+    return {from % variant.width, from / variant.width, to % variant.width, to / variant.width};
+}
+
+int RetrogradeSolver::run(const std::string& path, const SolverVariant& variant, int horizon, int threads)
+{
+    threads = std::max(1, threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()));
+
+    int cells = variant.width * variant.height;
+    std::uint64_t boards = 1;
+    for (int i = 0; i < cells && boards <= MaxEntries; ++i)
+        boards *= variant.colors + 1u;
+    std::uint64_t entries = boards * variant.colors * variant.colors;
+    if (variant.width < 1 || variant.height < 1 || cells > MaxCells || variant.colors < 1 || variant.colors > 6 ||
+        entries > MaxEntries)
+    {
+        std::cerr << "Wariant " << variant.width << "x" << variant.height << ", " << variant.colors
+                  << " kolory jest za duży dla solvera (limit " << MaxEntries << " wpisów tablicy)" << std::endl;
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    Solver solver(variant, threads);
+    solver.prepare();
+
+    int computed = 0;
+    while (computed < horizon)
+    {
+        double change = solver.iterate();
+        computed++;
+        // Wartości przestały się zmieniać - dalsze tury nic nie wniosą
+        if (change < 1e-7)
+            break;
+    }
+    solver.finish();
+
+    if (!solver.write(path, computed))
+    {
+        std::cerr << "Nie można zapisać tablicy: " << path << std::endl;
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Plansze: " << solver.getBoards() << ", wpisy: " << entries << ", bajty: "
+              << entries * (sizeof(float) + sizeof(std::uint16_t)) << ", tury: " << computed << ", czas: " << seconds
+              << " s" << std::endl;
+    std::cout << "Średnie przetrwanie " << computed << " tur: " << solver.startValue() << std::endl;
+    return 0;
+}
@@ -0,0 +1,341 @@
+#include "../include/RulesSweep.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include "../include/SelfPlay.hpp"
+
+namespace
+{
+    template <typename T>
+    bool readValues(std::istringstream& line, std::vector<T>& values)
+    {
+        values.clear();
+        T value;
+        while (line >> value)
+            values.push_back(value);
+        return !values.empty() && line.eof();
+    }
+
+    // Jedna konfiguracja zasad w trakcie przeglądu
+    struct Arm
+    {
+        enum Status { Running, Resolved, Eliminated, Exhausted };
+
+        GameRules rules;
+        std::vector<double> values; // Posortowane wyniki skończonych gier
+        int started = 0;            // Gry rozdane wątkom
+        Status status = Running;
+        double median = 0.0;
+        double low = 0.0;           // Przedział ufności mediany
+        double high = 0.0;
+
+        // Odległość mediany od celu: najmniejsza i największa zgodna z przedziałem
+        double nearest(double target) const
+        {
+            if (low <= target && target <= high)
+                return 0.0;
+            return std::min(std::abs(low - target), std::abs(high - target));
+        }
+        double farthest(double target) const { return std::max(std::abs(low - target), std::abs(high - target)); }
+    };
+
+    std::string describe(const GameRules& rules)
+    {
+        std::ostringstream text;
+        text << "fill " << std::fixed << std::setprecision(2) << rules.fillRate << ", spawn " << rules.spawnCount
+             << ", colors " << rules.colors << ", line " << rules.lineLength << ", score " << rules.pointsPerBall << ':'
+             << rules.lengthBonus;
+        return text.str();
+    }
+
+    const char* statusName(Arm::Status status)
+    {
+        switch (status)
+        {
+            case Arm::Running: return "w toku";
+            case Arm::Resolved: return "rozstrzygnięta";
+            case Arm::Eliminated: return "odpadła";
+            case Arm::Exhausted: return "limit gier";
+        }
+        return "";
+    }
+
+    // Przedział mediany bez założeń o rozkładzie: statystyki pozycyjne n/2 -+ z * sqrt(n) / 2
+    void medianInterval(Arm& arm, double z)
+    {
+        const std::vector<double>& values = arm.values;
+        double n = static_cast<double>(values.size());
+        int last = static_cast<int>(values.size()) - 1;
+        int lowRank = std::max(0, static_cast<int>(std::floor(n / 2.0 - z * std::sqrt(n) / 2.0)));
+        int highRank = std::min(last, static_cast<int>(std::ceil(n / 2.0 + z * std::sqrt(n) / 2.0)));
+        arm.median = values[values.size() / 2];
+        arm.low = values[lowRank];
+        arm.high = values[highRank];
+    }
+
+    // Decyzje po każdej partii; zwraca liczbę konfiguracji, które jeszcze potrzebują gier
+    int decide(std::vector<Arm>& arms, const SweepSpec& spec, int gamesPlayed)
+    {
+        double best = -1.0;
+        for (Arm& arm : arms)
+        {
+            if (arm.status == Arm::Eliminated || static_cast<int>(arm.values.size()) < spec.minGames)
+                continue;
+            medianInterval(arm, spec.z);
+            if (best < 0.0 || arm.farthest(spec.target) < best)
+                best = arm.farthest(spec.target);
+        }
+
+        int running = 0;
+        for (Arm& arm : arms)
+        {
+            int games = static_cast<int>(arm.values.size());
+            if (arm.status != Arm::Eliminated && games >= spec.minGames)
+            {
+                Arm::Status before = arm.status;
+                if (arm.nearest(spec.target) > best)
+                    arm.status = Arm::Eliminated;
+                else if (arm.status == Arm::Running && arm.high - arm.low <= spec.precision * std::abs(spec.target))
+                    arm.status = Arm::Resolved;
+                else if (arm.status == Arm::Running && games >= spec.maxGames)
+                    arm.status = Arm::Exhausted;
+
+                if (arm.status != before)
+                {
+                    std::cout << "[" << gamesPlayed << " gier] " << describe(arm.rules) << ": "
+                              << statusName(arm.status) << " po " << games << " grach, mediana " << arm.median << " ["
+                              << arm.low << ", " << arm.high << "]" << std::endl;
+                }
+            }
+            if (arm.status == Arm::Running)
+                running++;
+        }
+        return running;
+    }
+}
+
+bool RulesSweep::loadSpec(const std::string& path, SweepSpec& spec)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::cerr << "Nie można otworzyć opisu przeglądu: " << path << std::endl;
+        return false;
+    }
+
+    std::string text;
+    int lineNumber = 0;
+    while (std::getline(in, text))
+    {
+        lineNumber++;
+        text = text.substr(0, text.find('#'));
+        std::istringstream line(text);
+        std::string key;
+        if (!(line >> key))
+            continue;
+
+        bool ok = true;
+        if (key == "fill")
+            ok = readValues(line, spec.fillRates);
+        else if (key == "spawn")
+            ok = readValues(line, spec.spawnCounts);
+        else if (key == "colors")
+            ok = readValues(line, spec.colors);
+        else if (key == "line")
+            ok = readValues(line, spec.lineLengths);
+        else if (key == "score")
+        {
+            std::vector<std::string> pairs;
+            ok = readValues(line, pairs);
+            spec.scorings.clear();
+            for (const std::string& pair : pairs)
+            {
+                int perBall = 0;
+                int bonus = 0;
+                char colon = 0;
+                std::istringstream parts(pair);
+                ok = ok && (parts >> perBall >> colon >> bonus) && colon == ':';
+                spec.scorings.push_back({perBall, bonus});
+            }
+        }
+        else if (key == "board")
+            ok = static_cast<bool>(line >> spec.width >> spec.height);
+        else if (key == "metric")
+        {
+            std::string metric;
+            ok = (line >> metric) && (metric == "turns" || metric == "score");
+            spec.scoreMetric = metric == "score";
+        }
+        else if (key == "target")
+            ok = static_cast<bool>(line >> spec.target);
+        else if (key == "precision")
+            ok = static_cast<bool>(line >> spec.precision);
+        else if (key == "maxturns")
+            ok = static_cast<bool>(line >> spec.maxTurns);
+        else if (key == "games")
+            ok = static_cast<bool>(line >> spec.minGames >> spec.maxGames);
+        else if (key == "batch")
+            ok = static_cast<bool>(line >> spec.batch);
+        else if (key == "z")
+            ok = static_cast<bool>(line >> spec.z);
+        else if (key == "seed")
+            ok = static_cast<bool>(line >> spec.seed);
+        else
+            ok = false;
+
+        if (!ok)
+        {
+            std::cerr << path << ":" << lineNumber << ": nieznane pokrętło lub zła wartość: " << text << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int RulesSweep::run(const SweepSpec& spec, int threads)
+{
+    threads = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+
+    // Iloczyn kartezjański pokręteł (numer konfiguracji rozkładany na indeksy jak liczba w systemie mieszanym);
+    // wartości spoza zakresu gry są odrzucane od razu
+    std::vector<Arm> arms;
+    size_t total = spec.fillRates.size() * spec.spawnCounts.size() * spec.colors.size() * spec.lineLengths.size() *
+                   spec.scorings.size();
+    for (size_t i = 0; i < total; ++i)
+    {
+        size_t rest = i;
+        auto next = [&rest](size_t size) {
+            size_t index = rest % size;
+            rest /= size;
+            return index;
+        };
+        Arm arm;
+        arm.rules.fillRate = spec.fillRates[next(spec.fillRates.size())];
+        arm.rules.spawnCount = spec.spawnCounts[next(spec.spawnCounts.size())];
+        arm.rules.colors = spec.colors[next(spec.colors.size())];
+        arm.rules.lineLength = spec.lineLengths[next(spec.lineLengths.size())];
+        auto [perBall, bonus] = spec.scorings[next(spec.scorings.size())];
+        arm.rules.pointsPerBall = perBall;
+        arm.rules.lengthBonus = bonus;
+
+        const GameRules& rules = arm.rules;
+        if (rules.fillRate < 0.0f || rules.fillRate > 1.0f || rules.spawnCount < 1 || rules.colors < 1 ||
+            rules.colors > 6 || rules.lineLength < 2 || rules.lineLength > 6 ||
+            rules.lineLength > std::max(spec.width, spec.height))
+        {
+            std::cerr << "Pomijam konfigurację spoza zakresu: " << describe(rules) << std::endl;
+            continue;
+        }
+        arms.push_back(arm);
+    }
+    if (arms.empty() || spec.minGames < 1 || spec.maxGames < spec.minGames || spec.batch < 1)
+    {
+        std::cerr << "Pusty przegląd albo złe limity gier" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Konfiguracje: " << arms.size() << ", cel: mediana " << (spec.scoreMetric ? "wyniku" : "tur")
+              << " = " << spec.target << ", wątki: " << threads << std::endl;
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::condition_variable batchDone;
+    int running = static_cast<int>(arms.size());
+    int gamesPlayed = 0;
+    std::vector<std::thread> workers;
+
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&] {
+            std::vector<double> batch;
+            while (true)
+            {
+                // Partia dla konfiguracji w toku z najmniejszą liczbą rozdanych gier
+                size_t chosen = arms.size();
+                int first = 0;
+                int count = 0;
+                GameRules rules;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    while (true)
+                    {
+                        if (running == 0)
+                            return;
+                        for (size_t i = 0; i < arms.size(); ++i)
+                        {
+                            if (arms[i].status == Arm::Running && arms[i].started < spec.maxGames &&
+                                (chosen == arms.size() || arms[i].started < arms[chosen].started))
+                                chosen = i;
+                        }
+                        if (chosen != arms.size())
+                            break;
+                        batchDone.wait(lock); // Wszystkie gry rozdane - czekamy na wyniki
+                    }
+                    first = arms[chosen].started;
+                    count = std::min(spec.batch, spec.maxGames - first);
+                    arms[chosen].started += count;
+                    rules = arms[chosen].rules;
+                }
+
+                batch.clear();
+                HeadlessGame game(spec.width, spec.height, spec.seed);
+                game.setRules(rules);
+                for (int g = first; g < first + count; ++g)
+                {
+                    game.reset(spec.seed + g);
+                    std::mt19937 policyRng(spec.seed * 7919u + g);
+                    while (!game.isGameOver() && game.getTurn() < spec.maxTurns)
+                    {
+                        if (!game.playMove(SelfPlay::chooseMove(game.getState(), policyRng)))
+                            break;
+                    }
+                    batch.push_back(spec.scoreMetric ? game.getScore() : game.getTurn());
+                }
+                std::sort(batch.begin(), batch.end());
+
+                std::lock_guard<std::mutex> lock(mutex);
+                std::vector<double>& values = arms[chosen].values;
+                size_t before = values.size();
+                values.insert(values.end(), batch.begin(), batch.end());
+                std::inplace_merge(values.begin(), values.begin() + before, values.end());
+                gamesPlayed += count;
+                running = decide(arms, spec, gamesPlayed);
+                batchDone.notify_all();
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    for (Arm& arm : arms)
+    {
+        if (!arm.values.empty())
+            medianInterval(arm, spec.z);
+    }
+    std::stable_sort(arms.begin(), arms.end(), [&](const Arm& a, const Arm& b) {
+        return std::abs(a.median - spec.target) < std::abs(b.median - spec.target);
+    });
+
+    std::cout << "Konfiguracje od najbliższej celu:" << std::endl;
+    for (const Arm& arm : arms)
+    {
+        std::cout << "  " << describe(arm.rules) << ": mediana " << arm.median << " [" << arm.low << ", " << arm.high
+                  << "], gry: " << arm.values.size() << ", " << statusName(arm.status) << std::endl;
+    }
+    long fixedBudget = static_cast<long>(arms.size()) * spec.maxGames;
+    std::cout << "Gry: " << gamesPlayed << " zamiast " << fixedBudget << " przy stałym N (" << std::fixed
+              << std::setprecision(1) << 100.0 * gamesPlayed / fixedBudget << "%), czas: " << seconds << " s"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include "../include/SelfPlay.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../include/Dataset.hpp"
+#include "../include/HeadlessGame.hpp"
+#include "../include/Heatmap.hpp"
+#include "../include/MoveEvaluator.hpp"
+#include "../include/ResultsStore.hpp"
+#include "../include/RetrogradeSolver.hpp"
+
+namespace
+{
+    // Co która tura mierzy pełny ranking (MoveEvaluator::rank) - pomiar nie zmienia przebiegu gier
+    const int RankSampleEvery = 64;
+}
+
+Move SelfPlay::chooseMove(const BoardState& state, std::mt19937& rng)
+{
+    // Jeden ewaluator na wątek (bufory bez synchronizacji), odtwarzany przy zmianie planszy lub długości linii
+    thread_local std::unique_ptr<MoveEvaluator> evaluator;
+    if (!evaluator || evaluator->getWidth() != state.width || evaluator->getHeight() != state.height ||
+        evaluator->getLineLength() != state.lineLength)
+        evaluator = std::make_unique<MoveEvaluator>(state.width, state.height, state.lineLength);
+    return evaluator->choose(state, rng, 0.1f);
+}
+
+int SelfPlay::run(const SelfPlayConfig& config)
+{
+    int threads = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+
+    DatasetWriter writer(config.width, config.height);
+    bool writeDataset = !config.outputPath.empty();
+    if (writeDataset && !writer.open(config.outputPath, 2))
+    {
+        std::cerr << "Nie można otworzyć pliku: " << config.outputPath << std::endl;
+        return 1;
+    }
+
+    ResultsStore results;
+    bool storeResults = !config.resultsPath.empty();
+    if (storeResults && !results.open(config.resultsPath))
+        return 1;
+
+    // Tablica jest tylko do odczytu - wątki dzielą jedno mapowanie
+    SolverTable solved;
+    if (!config.solverTable.empty() && !solved.open(config.solverTable))
+        return 1;
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::atomic<int> nextGame(0);
+    std::atomic<std::uint64_t> totalTurns(0);
+    std::atomic<int> gamesLost(0);
+    std::atomic<std::uint64_t> rankSamples(0);
+    std::atomic<std::uint64_t> rankNanos(0);
+    std::atomic<std::uint64_t> rankMoves(0);
+    std::vector<std::thread> workers;
+
+    // Kolektory są lokalne w wątkach; do wspólnego trafiają raz, na końcu wątku
+    HeatmapCollector heatmap(config.width, config.height);
+    std::mutex heatmapMutex;
+    bool collectHeatmap = !config.heatmapPrefix.empty();
+
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t] {
+            std::mt19937 policyRng(config.seed * 7919u + t);
+            HeadlessGame game(config.width, config.height, config.seed);
+            game.setRules(config.rules);
+            GameRecorder recorder;
+            if (writeDataset)
+                game.addObserver(&recorder);
+            HeatmapCollector localHeatmap(config.width, config.height);
+            if (collectHeatmap)
+                game.addObserver(&localHeatmap);
+            std::uint64_t turns = 0;
+            MoveEvaluator ranker(config.width, config.height, config.rules.lineLength);
+            std::uint64_t samples = 0, nanos = 0, ranked = 0;
+
+            for (int g = nextGame++; g < config.games; g = nextGame++)
+            {
+                game.reset(config.seed + g);
+                recorder.start(static_cast<std::uint64_t>(g));
+
+                while (!game.isGameOver() && game.getTurn() < config.maxTurns)
+                {
+                    const BoardState& state = game.getState();
+                    if (game.getTurn() % RankSampleEvery == 0)
+                    {
+                        auto rankStart = std::chrono::steady_clock::now();
+                        ranked += ranker.rank(state).size();
+                        nanos += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now() - rankStart).count();
+                        samples++;
+                    }
+                    Move move = solved.matches(state) ? solved.bestMove(state) : chooseMove(state, policyRng);
+                    if (!game.playMove(move))
+                        break;
+                }
+
+                turns += game.getTurn();
+                if (game.isGameOver())
+                    gamesLost++;
+                if (storeResults)
+                {
+                    ResultRecord result;
+                    result.score = game.getScore();
+                    result.turns = static_cast<std::uint32_t>(game.getTurn());
+                    result.seed = config.seed + g;
+                    result.variant = config.variant;
+                    results.append(result);
+                }
+                if (!writeDataset)
+                    continue;
+
+                // Gra przerwana limitem tur - wynikiem jest bieżący stan
+                if (!recorder.isFinished())
+                    recorder.onGameOver(game.getState());
+                writer.submit(recorder.getRecord());
+            }
+
+            totalTurns += turns;
+            rankSamples += samples;
+            rankNanos += nanos;
+            rankMoves += ranked;
+            if (collectHeatmap)
+            {
+                std::lock_guard<std::mutex> lock(heatmapMutex);
+                heatmap.merge(localHeatmap);
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+    if (writeDataset)
+        writer.close();
+    if (storeResults)
+    {
+        results.flush();
+        std::cout << "Baza wyników: " << results.size() << " gier, najlepszy wynik wariantu " << config.variant
+                  << ": " << results.best(config.variant) << std::endl;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Tury: " << totalTurns << ", tur/s: " << static_cast<std::uint64_t>(totalTurns / std::max(seconds, 1e-9))
+              << ", przegrane gry: " << gamesLost << "/" << config.games << std::endl;
+    if (rankSamples > 0)
+        std::cout << "MoveEvaluator::rank: " << rankNanos / 1000.0 / rankSamples << " us/pozycję (" << rankSamples
+                  << " pozycji, średnio " << rankMoves / rankSamples << " ruchów)" << std::endl;
+
+    if (collectHeatmap)
+    {
+        if (!heatmap.writeAll(config.heatmapPrefix))
+        {
+            std::cerr << "Nie można zapisać map cieplnych: " << config.heatmapPrefix << std::endl;
+            return 1;
+        }
+        std::cout << "Mapy cieplne: " << config.heatmapPrefix << ".csv, " << heatmap.getGames() << " gier zakończonych, "
+                  << heatmap.getTurns() << " tur" << std::endl;
+    }
+    if (!writeDataset)
+        return 0;
+
+    std::uint64_t records = writer.getRecordsWritten();
+    std::cout << "Gry: " << config.games << ", pozycje: " << records
+              << ", bajty: " << writer.getBytesWritten()
+              << ", pozycji/s: " << static_cast<std::uint64_t>(records / std::max(seconds, 1e-9)) << std::endl;
+    return 0;
+}
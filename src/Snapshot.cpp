@@ -0,0 +1,144 @@
+#include "../include/Snapshot.hpp"
+#include <algorithm>
+#include <unordered_set>
+
+CowGrid::CowGrid() : width(0), height(0)
+{
+}
+
+CowGrid::CowGrid(int w, int h) : width(w), height(h)
+{
+    // Na początku wszystkie kawałki wskazują na ten sam pusty
+    auto empty = std::make_shared<const Chunk>(Chunk{});
+    chunks.assign((w * h + ChunkCells - 1) / ChunkCells, empty);
+}
+
+void CowGrid::set(int x, int y, int value)
+{
+    auto& chunk = chunks[index(x, y) / ChunkCells];
+    if ((*chunk)[index(x, y) % ChunkCells] == value)
+        return;
+
+    // Kopia przy zapisie: cudzy kawałek klonujemy, własny zmieniamy w miejscu
+    std::shared_ptr<Chunk> own;
+    if (chunk.use_count() == 1)
+        own = std::const_pointer_cast<Chunk>(chunk);
+    else
+        own = std::make_shared<Chunk>(*chunk);
+    (*own)[index(x, y) % ChunkCells] = static_cast<std::uint8_t>(value);
+    chunk = own;
+}
+
+CowGrid CowGrid::fromState(const BoardState& state, const CowGrid* previous)
+{
+    const std::vector<int>& cells = state.cells;
+    CowGrid grid;
+    grid.width = state.width;
+    grid.height = state.height;
+    size_t count = (cells.size() + ChunkCells - 1) / ChunkCells;
+    grid.chunks.reserve(count);
+
+    bool comparable = previous && previous->width == state.width && previous->height == state.height;
+    for (size_t c = 0; c < count; ++c)
+    {
+        Chunk values{};
+        for (int i = 0; i < ChunkCells && c * ChunkCells + i < cells.size(); ++i)
+            values[i] = static_cast<std::uint8_t>(cells[c * ChunkCells + i]);
+
+        if (comparable && *previous->chunks[c] == values)
+            grid.chunks.push_back(previous->chunks[c]); // Bez zmian - współdzielony
+        else
+            grid.chunks.push_back(std::make_shared<const Chunk>(values));
+    }
+    return grid;
+}
+
+BoardState CowGrid::toState() const
+{
+    BoardState state(width, height);
+    for (int i = 0; i < width * height; ++i)
+        state.cells[i] = (*chunks[i / ChunkCells])[i % ChunkCells];
+    return state;
+}
+
+BoardState BoardSnapshot::toState() const
+{
+    BoardState state = grid.toState();
+    state.nextBalls = nextBalls;
+    state.score = score;
+    state.combo = combo;
+    return state;
+}
+
+void BoardSnapshot::restoreRng(CountingRng& rng) const
+{
+    // Najwyżej CountingRng::SegmentDraws pobrań do przewinięcia - praktycznie stały czas
+    rng = CountingRng::resume(rngSegmentSeed, rngDraws);
+}
+
+SnapshotHistory::SnapshotHistory(size_t maxSnapshots) : cursor(0), capacity(maxSnapshots)
+{
+}
+
+void SnapshotHistory::clear()
+{
+    snapshots.clear();
+    cursor = 0;
+}
+
+void SnapshotHistory::capture(const BoardState& state, const CountingRng& rng, BoardSnapshot snapshot)
+{
+    const BoardSnapshot* previous = current();
+
+    // Nowa tura po cofnięciu - odcinamy gałąź ponawiania
+    if (!snapshots.empty())
+        snapshots.erase(snapshots.begin() + cursor + 1, snapshots.end());
+
+    snapshot.grid = CowGrid::fromState(state, previous ? &previous->grid : nullptr);
+    snapshot.nextBalls = state.nextBalls;
+    snapshot.score = state.score;
+    snapshot.combo = state.combo;
+
+    snapshot.rngSegmentSeed = rng.segmentSeed;
+    snapshot.rngDraws = rng.draws;
+
+    snapshots.push_back(std::move(snapshot));
+    if (capacity > 0 && snapshots.size() > capacity)
+        snapshots.pop_front();
+    cursor = snapshots.size() - 1;
+}
+
+const BoardSnapshot* SnapshotHistory::current() const
+{
+    return snapshots.empty() ? nullptr : &snapshots[cursor];
+}
+
+const BoardSnapshot* SnapshotHistory::undo()
+{
+    if (!canUndo())
+        return nullptr;
+    return &snapshots[--cursor];
+}
+
+const BoardSnapshot* SnapshotHistory::redo()
+{
+    if (!canRedo())
+        return nullptr;
+    return &snapshots[++cursor];
+}
+
+size_t SnapshotHistory::memoryBytes() const
+{
+    std::unordered_set<const void*> seen;
+    size_t bytes = 0;
+    for (const auto& snapshot : snapshots)
+    {
+        bytes += sizeof(BoardSnapshot) + snapshot.grid.chunkCount() * sizeof(std::shared_ptr<const CowGrid::Chunk>);
+        for (size_t i = 0; i < snapshot.grid.chunkCount(); ++i)
+        {
+            if (seen.insert(snapshot.grid.chunk(i).get()).second)
+                bytes += sizeof(CowGrid::Chunk);
+        }
+    }
+    return bytes;
+}
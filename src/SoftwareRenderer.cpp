@@ -0,0 +1,403 @@
+#include "../include/SoftwareRenderer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <thread>
+#include "../include/Dataset.hpp"
+#include "../include/EmbeddedFont.hpp"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    std::uint32_t rgb(int r, int g, int b)
+    {
+        return static_cast<std::uint32_t>(r) | (static_cast<std::uint32_t>(g) << 8) | (static_cast<std::uint32_t>(b) << 16);
+    }
+
+    std::uint32_t ballColor(BallColor color)
+    {
+        BallRgb value = ballRgb(color);
+        return rgb(value.r, value.g, value.b);
+    }
+
+    std::uint32_t blend(std::uint32_t dst, std::uint32_t src, int alpha)
+    {
+        std::uint32_t result = 0;
+        for (int shift = 0; shift < 24; shift += 8)
+        {
+            int d = (dst >> shift) & 0xff;
+            int s = (src >> shift) & 0xff;
+            result |= static_cast<std::uint32_t>(d + ((s - d) * alpha + 127) / 255) << shift;
+        }
+        return result;
+    }
+
+    // Wypełnienie poziomego odcinka - tu spędzamy większość czasu
+    void fillSpan(std::uint32_t* out, int count, std::uint32_t color)
+    {
+        int i = 0;
+#if defined(__SSE2__)
+        __m128i value = _mm_set1_epi32(static_cast<int>(color));
+        for (; i + 16 <= count; i += 16)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), value);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4), value);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), value);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 12), value);
+        }
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), value);
+#endif
+        for (; i < count; ++i)
+            out[i] = color;
+    }
+}
+
+void Image::resize(int w, int h)
+{
+    width = w;
+    height = h;
+    pixels.resize(static_cast<size_t>(w) * h);
+}
+
+bool Image::writePPM(const std::string& path) const
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+    std::vector<std::uint8_t> row(width * 3);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            std::uint32_t p = pixels[y * width + x];
+            row[x * 3] = p & 0xff;
+            row[x * 3 + 1] = (p >> 8) & 0xff;
+            row[x * 3 + 2] = (p >> 16) & 0xff;
+        }
+        std::fwrite(row.data(), 1, row.size(), file);
+    }
+    return std::fclose(file) == 0;
+}
+
+bool Image::writePNG(const std::string& path) const
+{
+    // PNG bez zlib: dane w nieskompresowanych blokach deflate.
+    // Miniatury są małe, a zapis nie kosztuje czasu procesora.
+    static const auto crcTable = []() {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t n = 0; n < 256; ++n)
+        {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        return table;
+    }();
+
+    std::vector<std::uint8_t> out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    auto putU32 = [](std::vector<std::uint8_t>& buffer, std::uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8)
+            buffer.push_back(static_cast<std::uint8_t>(value >> shift));
+    };
+    auto chunk = [&](const char* type, const std::vector<std::uint8_t>& data) {
+        putU32(out, static_cast<std::uint32_t>(data.size()));
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = start; i < out.size(); ++i)
+            crc = crcTable[(crc ^ out[i]) & 0xff] ^ (crc >> 8);
+        putU32(out, crc ^ 0xFFFFFFFFu);
+    };
+
+    std::vector<std::uint8_t> header;
+    putU32(header, width);
+    putU32(header, height);
+    header.insert(header.end(), {8, 2, 0, 0, 0}); // 8 bitów, RGB
+    chunk("IHDR", header);
+
+    // Wiersze z filtrem 0 (brak)
+    std::vector<std::uint8_t> raw;
+    raw.reserve(static_cast<size_t>(height) * (width * 3 + 1));
+    for (int y = 0; y < height; ++y)
+    {
+        raw.push_back(0);
+        for (int x = 0; x < width; ++x)
+        {
+            std::uint32_t p = pixels[y * width + x];
+            raw.push_back(p & 0xff);
+            raw.push_back((p >> 8) & 0xff);
+            raw.push_back((p >> 16) & 0xff);
+        }
+    }
+
+    std::vector<std::uint8_t> zlib = {0x78, 0x01};
+    for (size_t pos = 0; pos < raw.size() || pos == 0;)
+    {
+        size_t length = std::min<size_t>(65535, raw.size() - pos);
+        bool last = pos + length == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(length & 0xff);
+        zlib.push_back(length >> 8);
+        zlib.push_back(~length & 0xff);
+        zlib.push_back((~length >> 8) & 0xff);
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + length);
+        pos += length;
+        if (last)
+            break;
+    }
+    std::uint32_t a = 1, b = 0;
+    for (std::uint8_t byte : raw)
+    {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    putU32(zlib, (b << 16) | a);
+    chunk("IDAT", zlib);
+    chunk("IEND", {});
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+SoftwareRenderer::SoftwareRenderer(float imageScale) : scale(imageScale)
+{
+    buildGlyphs();
+}
+
+void SoftwareRenderer::buildGlyphs()
+{
+    // Tekst wyniku w grze ma 30 px; wielkie litery zajmują ok. 70% wysokości
+    glyphHeight = std::max(7, static_cast<int>(std::lround(21.0f * scale)));
+    glyphWidth = std::max(5, glyphHeight * 5 / 7);
+
+    for (int c = 32; c < 127; ++c)
+    {
+        if (!EmbeddedFont::glyph(static_cast<char>(c)))
+            continue;
+        std::vector<std::uint8_t> mask(glyphWidth * glyphHeight);
+        EmbeddedFont::rasterize(static_cast<char>(c), glyphWidth, glyphHeight, mask.data());
+        glyphs[c] = std::move(mask);
+    }
+}
+
+void SoftwareRenderer::fillRect(Image& image, float x0, float y0, float x1, float y1, std::uint32_t color) const
+{
+    int left = std::max(0, static_cast<int>(std::lround(x0 * scale)));
+    int top = std::max(0, static_cast<int>(std::lround(y0 * scale)));
+    // Linie o grubości 1 px w grze nie mogą zniknąć po zmniejszeniu
+    int right = std::min(image.width, std::max(left + 1, static_cast<int>(std::lround(x1 * scale))));
+    int bottom = std::min(image.height, std::max(top + 1, static_cast<int>(std::lround(y1 * scale))));
+
+    for (int y = top; y < bottom; ++y)
+        fillSpan(&image.pixels[y * image.width + left], right - left, color);
+}
+
+void SoftwareRenderer::fillCircle(Image& image, float cx, float cy, float radius, std::uint32_t color) const
+{
+    cx *= scale;
+    cy *= scale;
+    radius *= scale;
+
+    int top = std::max(0, static_cast<int>(std::floor(cy - radius)));
+    int bottom = std::min(image.height - 1, static_cast<int>(std::ceil(cy + radius)));
+    for (int y = top; y <= bottom; ++y)
+    {
+        float dy = y + 0.5f - cy;
+        float squared = radius * radius - dy * dy;
+        if (squared <= 0.0f)
+            continue;
+
+        // Środek odcinka pełnym kolorem, brzegi z pokryciem proporcjonalnym do części piksela
+        float half = std::sqrt(squared);
+        float spanLeft = cx - half;
+        float spanRight = cx + half;
+        int innerLeft = std::max(0, static_cast<int>(std::ceil(spanLeft)));
+        int innerRight = std::min(image.width, static_cast<int>(std::floor(spanRight)));
+
+        std::uint32_t* row = &image.pixels[y * image.width];
+        if (innerRight > innerLeft)
+            fillSpan(row + innerLeft, innerRight - innerLeft, color);
+
+        int edgeLeft = innerLeft - 1;
+        if (edgeLeft >= 0 && edgeLeft < image.width)
+            row[edgeLeft] = blend(row[edgeLeft], color, static_cast<int>((innerLeft - spanLeft) * 255));
+        if (innerRight >= 0 && innerRight < image.width && innerRight >= innerLeft)
+            row[innerRight] = blend(row[innerRight], color, static_cast<int>((spanRight - innerRight) * 255));
+    }
+}
+
+void SoftwareRenderer::drawText(Image& image, float x, float y, const std::string& text, std::uint32_t color) const
+{
+    int penX = static_cast<int>(std::lround(x * scale));
+    int penY = static_cast<int>(std::lround(y * scale));
+    int advance = glyphWidth + std::max(1, glyphWidth / 5);
+
+    for (char c : text)
+    {
+        const auto& mask = glyphs[static_cast<unsigned char>(c) & 0x7f];
+        if (!mask.empty())
+        {
+            for (int gy = 0; gy < glyphHeight && penY + gy < image.height; ++gy)
+            {
+                for (int gx = 0; gx < glyphWidth && penX + gx < image.width; ++gx)
+                {
+                    int alpha = mask[gy * glyphWidth + gx];
+                    if (alpha == 0 || penY + gy < 0 || penX + gx < 0)
+                        continue;
+                    std::uint32_t& pixel = image.pixels[(penY + gy) * image.width + penX + gx];
+                    pixel = alpha == 255 ? color : blend(pixel, color, alpha);
+                }
+            }
+        }
+        penX += advance;
+    }
+}
+
+void SoftwareRenderer::render(const BoardState& state, Image& image, bool gameOver) const
+{
+    // Stałe z Board::initializeGraphics i Board::draw
+    const float cellSize = 50.0f;
+    const float offsetX = 100.0f;
+    const float offsetY = 50.0f;
+
+    image.resize(static_cast<int>(std::lround(800 * scale)), static_cast<int>(std::lround(600 * scale)));
+    fillSpan(image.pixels.data(), static_cast<int>(image.pixels.size()), rgb(0, 0, 0));
+
+    // Pola: obrys 1 px na zewnątrz prostokąta 48x48, jak sf::RectangleShape z outline
+    for (int y = 0; y < state.height; ++y)
+    {
+        for (int x = 0; x < state.width; ++x)
+        {
+            float left = offsetX + x * cellSize + 1.0f;
+            float top = offsetY + y * cellSize + 1.0f;
+            fillRect(image, left - 1.0f, top - 1.0f, left + cellSize - 1.0f, top + cellSize - 1.0f, rgb(100, 100, 100));
+            std::uint32_t fill = state.at(x, y) == 0 ? rgb(40, 40, 40) : rgb(30, 30, 30);
+            fillRect(image, left, top, left + cellSize - 2.0f, top + cellSize - 2.0f, fill);
+        }
+    }
+
+    // Siatka
+    for (int x = 0; x <= state.width; ++x)
+        fillRect(image, offsetX + x * cellSize, offsetY, offsetX + x * cellSize + 1.0f,
+                 offsetY + state.height * cellSize, rgb(80, 80, 80));
+    for (int y = 0; y <= state.height; ++y)
+        fillRect(image, offsetX, offsetY + y * cellSize, offsetX + state.width * cellSize,
+                 offsetY + y * cellSize + 1.0f, rgb(80, 80, 80));
+
+    // Kulki o promieniu 20 na środku pól
+    for (int y = 0; y < state.height; ++y)
+    {
+        for (int x = 0; x < state.width; ++x)
+        {
+            int value = state.at(x, y);
+            if (value != 0)
+                fillCircle(image, offsetX + x * cellSize + cellSize / 2.0f, offsetY + y * cellSize + cellSize / 2.0f,
+                           20.0f, ballColor(static_cast<BallColor>(value - 1)));
+        }
+    }
+
+    // Podgląd następnych kulek (Board::drawNextBalls)
+    for (size_t i = 0; i < state.nextBalls.size(); ++i)
+        fillCircle(image, 650.0f + 15.0f, 150.0f + i * 40.0f + 15.0f, 15.0f, ballColor(state.nextBalls[i]));
+
+    drawText(image, 20.0f, 10.0f + 8.0f, "Score: " + std::to_string(state.score), rgb(255, 255, 255));
+
+    if (gameOver)
+    {
+        // Półprzezroczysta nakładka jak w Board::draw
+        int left = static_cast<int>(std::lround(offsetX * scale));
+        int top = static_cast<int>(std::lround(offsetY * scale));
+        int right = std::min(image.width, static_cast<int>(std::lround((offsetX + state.width * cellSize) * scale)));
+        int bottom = std::min(image.height, static_cast<int>(std::lround((offsetY + state.height * cellSize) * scale)));
+        for (int y = top; y < bottom; ++y)
+        {
+            for (int x = left; x < right; ++x)
+                image.pixels[y * image.width + x] = blend(image.pixels[y * image.width + x], 0, 150);
+        }
+    }
+}
+
+int SoftwareRenderer::runThumbnails(const std::string& datasetPath, const std::string& outputDir,
+                                    int threads, int every, bool ppm)
+{
+    DatasetReader reader;
+    if (!reader.open(datasetPath))
+    {
+        std::cerr << "Nie można otworzyć pliku: " << datasetPath << std::endl;
+        return 1;
+    }
+    threads = threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(1, threads);
+    every = std::max(1, every);
+
+    SoftwareRenderer renderer;
+    std::map<std::uint64_t, int> scores; // Wynik przed ruchem = suma wcześniejszych zmian w grze
+    std::vector<DatasetRecord> records;
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::int64_t> renderMicros{0};
+    std::uint64_t index = 0;
+    auto startTime = std::chrono::steady_clock::now();
+
+    while (reader.readBlock(records))
+    {
+        std::vector<std::pair<BoardState, std::string>> jobs;
+        for (const auto& record : records)
+        {
+            int& score = scores[record.gameId];
+            if (index++ % every == 0)
+            {
+                BoardState state(reader.getWidth(), reader.getHeight());
+                state.cells.assign(record.cells.begin(), record.cells.end());
+                state.nextBalls = record.nextBalls;
+                state.score = score;
+                std::string name = outputDir + "/g" + std::to_string(record.gameId) + "_t" +
+                                   std::to_string(record.turn) + (ppm ? ".ppm" : ".png");
+                jobs.push_back({std::move(state), std::move(name)});
+            }
+            score += record.scoreDelta;
+        }
+
+        // Blok dzielony po równo między wątki; każdy ma własny bufor obrazu
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t]() {
+                Image image;
+                std::int64_t micros = 0;
+                for (size_t i = t; i < jobs.size(); i += threads)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    renderer.render(jobs[i].first, image);
+                    micros += std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+
+                    if (ppm ? image.writePPM(jobs[i].second) : image.writePNG(jobs[i].second))
+                        written++;
+                }
+                renderMicros += micros;
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    double renderSeconds = renderMicros / 1e6;
+    std::cout << "Miniatury: " << written << " w " << seconds << " s, samo rysowanie "
+              << (renderSeconds > 0 ? written / renderSeconds : 0) << " obrazów/s na wątek" << std::endl;
+    return written > 0 ? 0 : 1;
+}
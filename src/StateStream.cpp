@@ -0,0 +1,462 @@
+#include "../include/StateStream.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+
+namespace
+{
+    enum : std::uint8_t
+    {
+        OpSnapshot = 0x01,
+        OpSelection = 0x03,
+        OpMarks = 0x04,
+        OpScore = 0x05,
+        OpNextBalls = 0x06,
+        OpGameOver = 0x07,
+        OpCell = 0x10 // 0x10-0x16: wartość pola w kodzie operacji
+    };
+
+    void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    std::uint64_t zigzag(std::int64_t value)
+    {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t value)
+    {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    // Odczyt z bufora, który może kończyć się w środku operacji
+    struct Reader
+    {
+        const std::uint8_t* data;
+        size_t size;
+        size_t pos;
+
+        bool byte(std::uint8_t& value)
+        {
+            if (pos >= size)
+                return false;
+            value = data[pos++];
+            return true;
+        }
+
+        bool varint(std::uint64_t& value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64 && pos < size; shift += 7)
+            {
+                std::uint8_t b = data[pos++];
+                value |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+                if ((b & 0x80) == 0)
+                    return true;
+            }
+            return false;
+        }
+    };
+
+    const long Incomplete = -2;
+    const long Corrupt = -1;
+}
+
+MirrorBoard::MirrorBoard()
+    : width(0), height(0), score(0), combo(1), selectedX(-1), selectedY(-1), gameOver(false), synced(false)
+{
+}
+
+long MirrorBoard::apply(const std::uint8_t* data, size_t size)
+{
+    Reader in{data, size, 0};
+    size_t consumed = 0;
+
+    // Jedna operacja; Incomplete gdy brakuje bajtów, Corrupt dla złych danych
+    auto applyOne = [this, &in]() -> long {
+        std::uint8_t op;
+        std::uint64_t a, b;
+        if (!in.byte(op))
+            return Incomplete;
+
+        if (op == OpSnapshot)
+        {
+            std::uint64_t w, h;
+            if (!in.varint(w) || !in.varint(h))
+                return Incomplete;
+            if (w == 0 || h == 0 || w * h > (1u << 24))
+                return Corrupt;
+            size_t count = static_cast<size_t>(w * h);
+            if (in.size - in.pos < (count + 1) / 2)
+                return Incomplete;
+
+            std::vector<std::uint8_t> newCells(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                std::uint8_t packed = in.data[in.pos + i / 2];
+                newCells[i] = (i % 2 == 0) ? (packed & 0x0f) : (packed >> 4);
+                if (newCells[i] > 6)
+                    return Corrupt;
+            }
+            in.pos += (count + 1) / 2;
+
+            std::uint8_t nextCount, over;
+            if (!in.byte(nextCount) || in.size - in.pos < nextCount)
+                return Incomplete;
+            std::vector<BallColor> next;
+            for (int i = 0; i < nextCount; ++i)
+                next.push_back(static_cast<BallColor>(in.data[in.pos++] % 6));
+
+            std::uint64_t newScore, newCombo, selection, markCount;
+            if (!in.varint(newScore) || !in.varint(newCombo) || !in.varint(selection) || !in.byte(over) ||
+                !in.varint(markCount))
+                return Incomplete;
+
+            std::vector<std::uint8_t> newMarks(count, 0);
+            std::uint64_t index = 0;
+            for (std::uint64_t i = 0; i < markCount; ++i)
+            {
+                if (!in.varint(a))
+                    return Incomplete;
+                index += a;
+                if (index >= count)
+                    return Corrupt;
+                newMarks[index] = 1;
+            }
+
+            width = static_cast<int>(w);
+            height = static_cast<int>(h);
+            cells = std::move(newCells);
+            marked = std::move(newMarks);
+            nextBalls = std::move(next);
+            score = static_cast<int>(unzigzag(newScore));
+            combo = static_cast<int>(newCombo);
+            selectedX = selection == 0 ? -1 : static_cast<int>((selection - 1) % width);
+            selectedY = selection == 0 ? -1 : static_cast<int>((selection - 1) / width);
+            gameOver = over != 0;
+            synced = true;
+            return 0;
+        }
+
+        if (op >= OpCell && op <= OpCell + 6)
+        {
+            if (!in.varint(a))
+                return Incomplete;
+            if (synced)
+            {
+                if (a >= cells.size())
+                    return Corrupt;
+                cells[a] = op - OpCell;
+            }
+            return 0;
+        }
+
+        switch (op)
+        {
+            case OpSelection:
+                if (!in.varint(a))
+                    return Incomplete;
+                if (synced)
+                {
+                    selectedX = a == 0 ? -1 : static_cast<int>((a - 1) % width);
+                    selectedY = a == 0 ? -1 : static_cast<int>((a - 1) / width);
+                }
+                return 0;
+
+            case OpMarks:
+            {
+                if (!in.varint(a))
+                    return Incomplete;
+                // Najpierw cała lista - przy niepełnej operacji stan zostaje bez zmian
+                size_t start = in.pos;
+                for (std::uint64_t i = 0; i < a; ++i)
+                {
+                    if (!in.varint(b))
+                        return Incomplete;
+                }
+                if (!synced)
+                    return 0;
+
+                std::fill(marked.begin(), marked.end(), 0);
+                in.pos = start;
+                std::uint64_t index = 0;
+                for (std::uint64_t i = 0; i < a; ++i)
+                {
+                    in.varint(b);
+                    index += b;
+                    if (index >= marked.size())
+                        return Corrupt;
+                    marked[index] = 1;
+                }
+                return 0;
+            }
+
+            case OpScore:
+                if (!in.varint(a) || !in.varint(b))
+                    return Incomplete;
+                score += static_cast<int>(unzigzag(a));
+                combo = static_cast<int>(b);
+                return 0;
+
+            case OpNextBalls:
+            {
+                std::uint8_t count;
+                if (!in.byte(count) || in.size - in.pos < count)
+                    return Incomplete;
+                nextBalls.clear();
+                for (int i = 0; i < count; ++i)
+                    nextBalls.push_back(static_cast<BallColor>(in.data[in.pos++] % 6));
+                return 0;
+            }
+
+            case OpGameOver:
+            {
+                std::uint8_t over;
+                if (!in.byte(over))
+                    return Incomplete;
+                gameOver = over != 0;
+                return 0;
+            }
+        }
+        return Corrupt;
+    };
+
+    while (consumed < size)
+    {
+        long result = applyOne();
+        if (result == Incomplete)
+            break;
+        if (result == Corrupt)
+            return Corrupt;
+        consumed = in.pos;
+    }
+    return static_cast<long>(consumed);
+}
+
+BoardState MirrorBoard::toState() const
+{
+    BoardState state(width, height);
+    for (size_t i = 0; i < cells.size(); ++i)
+        state.cells[i] = cells[i];
+    state.nextBalls = nextBalls;
+    state.score = score;
+    state.combo = combo;
+    return state;
+}
+
+void MirrorBoard::encodeSnapshot(std::vector<std::uint8_t>& out) const
+{
+    out.push_back(OpSnapshot);
+    putVarint(out, width);
+    putVarint(out, height);
+    for (size_t i = 0; i < cells.size(); i += 2)
+    {
+        std::uint8_t high = i + 1 < cells.size() ? cells[i + 1] : 0;
+        out.push_back(static_cast<std::uint8_t>(cells[i] | (high << 4)));
+    }
+
+    out.push_back(static_cast<std::uint8_t>(nextBalls.size()));
+    for (BallColor color : nextBalls)
+        out.push_back(static_cast<std::uint8_t>(color));
+
+    putVarint(out, zigzag(score));
+    putVarint(out, combo);
+    putVarint(out, selectedX < 0 ? 0 : selectedY * width + selectedX + 1);
+    out.push_back(gameOver ? 1 : 0);
+
+    size_t markCount = std::count(marked.begin(), marked.end(), 1);
+    putVarint(out, markCount);
+    size_t previous = 0;
+    for (size_t i = 0; i < marked.size(); ++i)
+    {
+        if (marked[i])
+        {
+            putVarint(out, i - previous);
+            previous = i;
+        }
+    }
+}
+
+StateStreamWriter::StateStreamWriter(size_t snapshotEvery, size_t maxSinkBacklog)
+    : bytesSinceSnapshot(0), snapshotInterval(snapshotEvery), maxBacklog(maxSinkBacklog), bytesEncoded(0)
+{
+}
+
+StateStreamWriter::~StateStreamWriter()
+{
+    for (auto& sink : sinks)
+        ::close(sink.fd);
+}
+
+void StateStreamWriter::emit(size_t start)
+{
+    // Cień stanu aktualizowany tym samym kodem, którego używa widz
+    shadow.apply(pending.data() + start, pending.size() - start);
+    bytesSinceSnapshot += pending.size() - start;
+    bytesEncoded += pending.size() - start;
+
+    // Okresowy snapshot - widz po zgubionych danych odzyskuje stan bez pytania o niego
+    if (bytesSinceSnapshot >= snapshotInterval && shadow.synced)
+        emitSnapshot();
+}
+
+void StateStreamWriter::emitSnapshot()
+{
+    size_t start = pending.size();
+    shadow.encodeSnapshot(pending);
+    bytesEncoded += pending.size() - start;
+    bytesSinceSnapshot = 0;
+}
+
+void StateStreamWriter::addSink(int fd)
+{
+    // Snapshot z cienia obejmuje też niewysłane jeszcze operacje - flush() ich temu widzowi nie wyśle
+    Sink sink{fd, {}, pending.size()};
+    if (shadow.synced)
+        shadow.encodeSnapshot(sink.backlog);
+    sinks.push_back(std::move(sink));
+}
+
+bool StateStreamWriter::writeSink(Sink& sink)
+{
+    size_t sent = 0;
+    while (sent < sink.backlog.size())
+    {
+        ssize_t written = ::write(sink.fd, sink.backlog.data() + sent, sink.backlog.size() - sent);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            return false; // Widz zamknął potok
+        }
+        sent += static_cast<size_t>(written);
+    }
+    sink.backlog.erase(sink.backlog.begin(), sink.backlog.begin() + sent);
+    return sink.backlog.size() <= maxBacklog;
+}
+
+void StateStreamWriter::flush()
+{
+    if (!pending.empty())
+    {
+        for (auto& sink : sinks)
+            sink.backlog.insert(sink.backlog.end(), pending.begin() + std::min(sink.skip, pending.size()), pending.end());
+        pending.clear();
+    }
+    for (auto& sink : sinks)
+        sink.skip = 0;
+
+    for (size_t i = 0; i < sinks.size();)
+    {
+        if (sinks[i].backlog.empty() || writeSink(sinks[i]))
+        {
+            ++i;
+            continue;
+        }
+        ::close(sinks[i].fd);
+        sinks[i] = std::move(sinks.back());
+        sinks.pop_back();
+    }
+}
+
+void StateStreamWriter::onGameOver(const BoardState&)
+{
+    if (shadow.gameOver)
+        return;
+    size_t start = pending.size();
+    pending.push_back(OpGameOver);
+    pending.push_back(1);
+    emit(start);
+}
+
+void StateStreamWriter::onCellChanged(int x, int y, int value)
+{
+    int index = y * shadow.width + x;
+    if (!shadow.synced || shadow.cells[index] == value)
+        return;
+    size_t start = pending.size();
+    pending.push_back(static_cast<std::uint8_t>(OpCell + value));
+    putVarint(pending, index);
+    emit(start);
+}
+
+void StateStreamWriter::onSelectionChanged(int x, int y)
+{
+    if (!shadow.synced || (x == shadow.selectedX && y == shadow.selectedY))
+        return;
+    size_t start = pending.size();
+    pending.push_back(OpSelection);
+    putVarint(pending, x < 0 ? 0 : y * shadow.width + x + 1);
+    emit(start);
+}
+
+void StateStreamWriter::onLinesMarked(const std::vector<std::pair<int, int>>& cells)
+{
+    if (!shadow.synced)
+        return;
+
+    std::vector<int> indices;
+    for (auto [x, y] : cells)
+        indices.push_back(y * shadow.width + x);
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    size_t start = pending.size();
+    pending.push_back(OpMarks);
+    putVarint(pending, indices.size());
+    int previous = 0;
+    for (int index : indices)
+    {
+        putVarint(pending, index - previous);
+        previous = index;
+    }
+    emit(start);
+}
+
+void StateStreamWriter::onScoreChanged(int score, int combo)
+{
+    if (!shadow.synced || (score == shadow.score && combo == shadow.combo))
+        return;
+    size_t start = pending.size();
+    pending.push_back(OpScore);
+    putVarint(pending, zigzag(score - shadow.score));
+    putVarint(pending, combo);
+    emit(start);
+}
+
+void StateStreamWriter::onNextBalls(const std::vector<BallColor>& balls)
+{
+    if (!shadow.synced)
+        return;
+    size_t start = pending.size();
+    pending.push_back(OpNextBalls);
+    pending.push_back(static_cast<std::uint8_t>(balls.size()));
+    for (BallColor color : balls)
+        pending.push_back(static_cast<std::uint8_t>(color));
+    emit(start);
+}
+
+void StateStreamWriter::onReset(const BoardState& state)
+{
+    shadow.width = state.width;
+    shadow.height = state.height;
+    shadow.cells.assign(state.cells.begin(), state.cells.end());
+    shadow.marked.assign(state.cells.size(), 0);
+    shadow.nextBalls = state.nextBalls;
+    shadow.score = state.score;
+    shadow.combo = state.combo;
+    shadow.selectedX = -1;
+    shadow.selectedY = -1;
+    shadow.gameOver = false;
+    shadow.synced = true;
+    emitSnapshot();
+}
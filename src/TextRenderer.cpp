@@ -0,0 +1,106 @@
+#include "../include/TextRenderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include "../include/EmbeddedFont.hpp"
+
+TextRenderer::Atlas& TextRenderer::atlasFor(unsigned int size)
+{
+    auto found = atlases.find(size);
+    if (found != atlases.end())
+        return *found->second;
+
+    // Wielkie litery zajmują ok. 70% rozmiaru znaku - tak jak w czcionkach TTF
+    auto atlas = std::make_unique<Atlas>();
+    atlas->glyphHeight = std::max(EmbeddedFont::Rows, static_cast<int>(std::lround(size * 0.7f)));
+    atlas->glyphWidth = std::max(EmbeddedFont::Columns, atlas->glyphHeight * EmbeddedFont::Columns / EmbeddedFont::Rows);
+    atlas->advance = atlas->glyphWidth + std::max(1, atlas->glyphWidth / 5);
+    atlas->cellWidth = atlas->glyphWidth + 2; // Odstęp, żeby filtrowanie nie łapało sąsiada
+
+    // Wszystkie znaki w jednym rzędzie: biały kolor, pokrycie w kanale alfa
+    int count = LastChar - FirstChar + 1;
+    unsigned int textureWidth = static_cast<unsigned int>(count * atlas->cellWidth);
+    unsigned int textureHeight = static_cast<unsigned int>(atlas->glyphHeight);
+    std::vector<std::uint8_t> pixels(textureWidth * textureHeight * 4, 0);
+    std::vector<std::uint8_t> mask(atlas->glyphWidth * atlas->glyphHeight);
+
+    for (int c = FirstChar; c <= LastChar; ++c)
+    {
+        if (!EmbeddedFont::glyph(static_cast<char>(c)))
+            continue;
+        EmbeddedFont::rasterize(static_cast<char>(c), atlas->glyphWidth, atlas->glyphHeight, mask.data());
+
+        int left = (c - FirstChar) * atlas->cellWidth;
+        for (int y = 0; y < atlas->glyphHeight; ++y)
+        {
+            for (int x = 0; x < atlas->glyphWidth; ++x)
+            {
+                std::uint8_t* pixel = &pixels[(y * textureWidth + left + x) * 4];
+                pixel[0] = pixel[1] = pixel[2] = 255;
+                pixel[3] = mask[y * atlas->glyphWidth + x];
+            }
+        }
+    }
+
+    if (atlas->texture.resize({textureWidth, textureHeight}))
+        atlas->texture.update(pixels.data());
+
+    return *atlases.emplace(size, std::move(atlas)).first->second;
+}
+
+sf::Vector2f TextRenderer::measure(const std::string& text, unsigned int size)
+{
+    const Atlas& atlas = atlasFor(size);
+    if (text.empty())
+        return {0.0f, 0.0f};
+    return {static_cast<float>(atlas.advance * (static_cast<int>(text.size()) - 1) + atlas.glyphWidth),
+            static_cast<float>(atlas.glyphHeight)};
+}
+
+void TextRenderer::appendText(const Atlas& atlas, const std::string& text, sf::Vector2f position, sf::Color color)
+{
+    float w = static_cast<float>(atlas.glyphWidth);
+    float h = static_cast<float>(atlas.glyphHeight);
+    float penX = std::round(position.x);
+    float penY = std::round(position.y);
+
+    for (char c : text)
+    {
+        if (c != ' ' && EmbeddedFont::glyph(c))
+        {
+            float u = static_cast<float>((c - FirstChar) * atlas.cellWidth);
+            sf::Vertex topLeft{{penX, penY}, color, {u, 0.0f}};
+            sf::Vertex topRight{{penX + w, penY}, color, {u + w, 0.0f}};
+            sf::Vertex bottomLeft{{penX, penY + h}, color, {u, h}};
+            sf::Vertex bottomRight{{penX + w, penY + h}, color, {u + w, h}};
+            vertices.insert(vertices.end(), {topLeft, topRight, bottomLeft, topRight, bottomRight, bottomLeft});
+        }
+        penX += atlas.advance;
+    }
+}
+
+void TextRenderer::draw(sf::RenderTarget& window, const std::string& text, sf::Vector2f position, unsigned int size,
+                        sf::Color fill, sf::Color outline)
+{
+    const Atlas& atlas = atlasFor(size);
+    vertices.clear();
+
+    // Obrys jak outlineThickness = 1: napis przesunięty w czterech kierunkach pod spodem
+    if (outline.a > 0)
+    {
+        appendText(atlas, text, {position.x - 1.0f, position.y}, outline);
+        appendText(atlas, text, {position.x + 1.0f, position.y}, outline);
+        appendText(atlas, text, {position.x, position.y - 1.0f}, outline);
+        appendText(atlas, text, {position.x, position.y + 1.0f}, outline);
+    }
+    appendText(atlas, text, position, fill);
+
+    if (!vertices.empty())
+        window.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles, &atlas.texture);
+}
+
+void TextRenderer::drawCentered(sf::RenderTarget& window, const std::string& text, sf::Vector2f center,
+                                unsigned int size, sf::Color fill, sf::Color outline)
+{
+    sf::Vector2f extent = measure(text, size);
+    draw(window, text, {center.x - extent.x / 2.0f, center.y - extent.y / 2.0f}, size, fill, outline);
+}
@@ -1,8 +1,219 @@
 #include <SFML/Graphics.hpp>
+#include <cerrno>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/BoardKernels.hpp"
+#include "../include/BotProtocol.hpp"
 #include "../include/Game.hpp"
+#include "../include/GameServer.hpp"
+#include "../include/GameVerifier.hpp"
+#include "../include/InputReplay.hpp"
+#include "../include/PuzzleGenerator.hpp"
+#include "../include/ResultsStore.hpp"
+#include "../include/RetrogradeSolver.hpp"
+#include "../include/RulesSweep.hpp"
+#include "../include/SelfPlay.hpp"
+#include "../include/SoftwareRenderer.hpp"
+#include "../include/StateStream.hpp"
 
-int main()
+static GameServer* runningServer = nullptr;
+
+int main(int argc, char* argv[])
 {
+   // kulki --selfplay <plik> [gry] [wątki] [baza wyników] - eksport danych bez okna
+   if (argc >= 3 && std::string(argv[1]) == "--selfplay")
+   {
+      SelfPlayConfig config;
+      config.outputPath = argv[2];
+      if (argc >= 4) config.games = std::stoi(argv[3]);
+      if (argc >= 5) config.threads = std::stoi(argv[4]);
+      if (argc >= 6) config.resultsPath = argv[5];
+      return SelfPlay::run(config);
+   }
+
+   // kulki --results <baza> [wariant] [k] - najlepsze wyniki i percentyle z bazy wyników
+   if (argc >= 3 && std::string(argv[1]) == "--results")
+   {
+      ResultsStore results;
+      if (!results.open(argv[2]))
+         return 1;
+      auto variant = static_cast<std::uint16_t>(argc >= 4 ? std::stoi(argv[3]) : 0);
+      size_t k = argc >= 5 ? static_cast<size_t>(std::stoul(argv[4])) : 10;
+
+      std::cout << "Gry w bazie: " << results.size() << std::endl;
+      int place = 1;
+      for (const ResultRecord& result : results.topK(variant, k))
+         std::cout << place++ << ". " << result.score << " (tury: " << result.turns << ", ziarno: " << result.seed << ")"
+                   << std::endl;
+      std::cout << "p50: " << results.percentile(variant, 50) << ", p90: " << results.percentile(variant, 90)
+                << ", p99: " << results.percentile(variant, 99) << ", najlepszy: " << results.best(variant) << std::endl;
+      return 0;
+   }
+
+   // kulki --heatmap <prefiks> [gry] [wątki] [wypełnienie] - mapy cieplne z self-play, bez pliku z danymi
+   if (argc >= 3 && std::string(argv[1]) == "--heatmap")
+   {
+      SelfPlayConfig config;
+      config.heatmapPrefix = argv[2];
+      config.games = argc >= 4 ? std::stoi(argv[3]) : 100000;
+      if (argc >= 5) config.threads = std::stoi(argv[4]);
+      if (argc >= 6) config.rules.fillRate = std::stof(argv[5]);
+      return SelfPlay::run(config);
+   }
+
+   // kulki --solve <tablica> [szer] [wys] [kolory] [tury] [wątki] - pełne rozwiązanie małego wariantu
+   if (argc >= 3 && std::string(argv[1]) == "--solve")
+   {
+      SolverVariant variant;
+      if (argc >= 4) variant.width = std::stoi(argv[3]);
+      if (argc >= 5) variant.height = std::stoi(argv[4]);
+      if (argc >= 6) variant.colors = std::stoi(argv[5]);
+      int horizon = argc >= 7 ? std::stoi(argv[6]) : 100;
+      int threads = argc >= 8 ? std::stoi(argv[7]) : 0;
+      return RetrogradeSolver::run(argv[2], variant, horizon, threads);
+   }
+
+   // kulki --solved <tablica> [gry] [wątki] - bot grający ruchami z tablicy, do sprawdzenia wyników solvera
+   if (argc >= 3 && std::string(argv[1]) == "--solved")
+   {
+      SolverTable table;
+      if (!table.open(argv[2]))
+         return 1;
+      SelfPlayConfig config;
+      config.solverTable = argv[2];
+      config.width = table.getVariant().width;
+      config.height = table.getVariant().height;
+      config.rules.colors = table.getVariant().colors;
+      config.maxTurns = table.getHorizon();
+      config.games = argc >= 4 ? std::stoi(argv[3]) : 10000;
+      if (argc >= 5) config.threads = std::stoi(argv[4]);
+      return SelfPlay::run(config);
+   }
+
+   // kulki --sweep <opis> [wątki] - przegląd zasad, konfiguracje odpadają, gdy ich przedziały się rozejdą
+   if (argc >= 3 && std::string(argv[1]) == "--sweep")
+   {
+      SweepSpec spec;
+      if (!RulesSweep::loadSpec(argv[2], spec))
+         return 1;
+      return RulesSweep::run(spec, argc >= 4 ? std::stoi(argv[3]) : 0);
+   }
+
+   // kulki --verify <plik> [wątki] - odtwarza zgłoszone gry od ziarna i odrzuca nielegalne ruchy oraz złe wyniki
+   if (argc >= 3 && std::string(argv[1]) == "--verify")
+      return GameVerifier::run(argv[2], argc >= 4 ? std::stoi(argv[3]) : 0);
+
+   // kulki --puzzles <plik> [liczba] [wątki] [ruchy] - dopisuje zagadki do banku
+   if (argc >= 3 && std::string(argv[1]) == "--puzzles")
+   {
+      int count = argc >= 4 ? std::stoi(argv[3]) : 1000;
+      int threads = argc >= 5 ? std::stoi(argv[4]) : 0;
+      int moves = argc >= 6 ? std::stoi(argv[5]) : 2;
+      return PuzzleGenerator::run(argv[2], count, threads, moves);
+   }
+
+   // kulki --bot [seed] - protokół tekstowy na stdin/stdout dla zewnętrznych silników
+   if (argc >= 2 && std::string(argv[1]) == "--bot")
+   {
+      unsigned int seed = argc >= 3 ? static_cast<unsigned int>(std::stoul(argv[2])) : 1;
+      BotProtocol protocol(10, 10, seed);
+      return protocol.run();
+   }
+
+   // kulki --server <gniazdo> [wątki] [obudzone] - wiele plansz naraz, protokół jak w --bot
+   if (argc >= 3 && std::string(argv[1]) == "--server")
+   {
+      GameServer server(argv[2], 10, 10, argc >= 5 ? std::stoul(argv[4]) : 100000);
+      runningServer = &server;
+      std::signal(SIGINT, [](int) { runningServer->stop(); });
+      std::signal(SIGTERM, [](int) { runningServer->stop(); });
+      return server.run(argc >= 4 ? std::stoi(argv[3]) : 0);
+   }
+
+   // kulki --thumbnails <plik> <katalog> [wątki] [co_który] [ppm] - miniatury pozycji z self-play
+   if (argc >= 4 && std::string(argv[1]) == "--thumbnails")
+   {
+      int threads = argc >= 5 ? std::stoi(argv[4]) : 0;
+      int every = argc >= 6 ? std::stoi(argv[5]) : 1;
+      bool ppm = argc >= 7 && std::string(argv[6]) == "ppm";
+      return SoftwareRenderer::runThumbnails(argv[2], argv[3], threads, every, ppm);
+   }
+
+   // kulki --watch - widz: czyta strumień delt ze stdin i rysuje planszę tekstem
+   if (argc >= 2 && std::string(argv[1]) == "--watch")
+   {
+      MirrorBoard mirror;
+      std::vector<std::uint8_t> buffer;
+      std::uint8_t chunk[4096];
+      ssize_t received;
+      while ((received = ::read(STDIN_FILENO, chunk, sizeof(chunk))) > 0)
+      {
+         buffer.insert(buffer.end(), chunk, chunk + received);
+         long used = mirror.apply(buffer.data(), buffer.size());
+         if (used < 0)
+         {
+            std::cerr << "Uszkodzony strumień" << std::endl;
+            return 1;
+         }
+         buffer.erase(buffer.begin(), buffer.begin() + used);
+         if (!mirror.synced)
+            continue;
+
+         std::string text = "\x1b[H\x1b[2J";
+         for (int y = 0; y < mirror.height; ++y)
+         {
+            for (int x = 0; x < mirror.width; ++x)
+            {
+               int value = mirror.cells[y * mirror.width + x];
+               text += value == 0 ? '.' : static_cast<char>('0' + value);
+            }
+            text += '\n';
+         }
+         text += "Score: " + std::to_string(mirror.score) + (mirror.gameOver ? "  GAME OVER\n" : "\n");
+         std::cout << text << std::flush;
+      }
+      return 0;
+   }
+
+   // kulki --replay <nagranie|synthetic> [ruchy] [budżet ms] - odtwarza wejście bez okna, mierzy opóźnienie
+   if (argc >= 3 && std::string(argv[1]) == "--replay")
+   {
+      int moves = argc >= 4 ? std::stoi(argv[3]) : 200;
+      double budget = argc >= 5 ? std::stod(argv[4]) : 0.0;
+      return InputReplay::run(argv[2], moves, budget);
+   }
+
+   // kulki --selftest - każda wersja jąder planszy dostępna na tym procesorze daje te same wyniki
+   if (argc >= 2 && std::string(argv[1]) == "--selftest")
+      return BoardKernels::selfTest(std::cout) ? 0 : 1;
+
    Game game;
+
+   // kulki --record <plik> - gra w oknie, wejście zapisywane do odtworzenia przez --replay
+   if (argc >= 3 && std::string(argv[1]) == "--record" && !game.recordInput(argv[2]))
+      return 1;
+
+   // kulki --stream <potok> [...] - gra w oknie, zmiany stanu idą do widzów
+   if (argc >= 3 && std::string(argv[1]) == "--stream")
+   {
+      for (int i = 2; i < argc; ++i)
+      {
+         // Bez blokowania: potok bez czytelnika nie wstrzymuje startu gry (open zwraca wtedy ENXIO)
+         int fd = ::open(argv[i], O_WRONLY | O_CREAT | O_NONBLOCK | O_CLOEXEC, 0644);
+         if (fd < 0)
+         {
+            if (errno == ENXIO)
+               std::cerr << "Potok " << argv[i] << " nie ma widza - pomijamy (widz otwiera go pierwszy)" << std::endl;
+            else
+               std::cerr << "Nie można otworzyć: " << argv[i] << std::endl;
+            continue;
+         }
+         game.addSpectator(fd);
+      }
+   }
+
    return game.run();
-}
\ No newline at end of file
+}
@@ -0,0 +1,84 @@
+#include "Test.hpp"
+#include <cstdio>
+#include <fstream>
+#include "../include/GameVerifier.hpp"
+
+namespace
+{
+    // Gra losowymi ruchami od ziarna - do końca albo do limitu tur
+    std::vector<Move> playGame(std::uint32_t seed, int maxTurns, int& score, bool& finished)
+    {
+        std::mt19937 pick(seed);
+        HeadlessGame game(10, 10, 0);
+        game.reset(seed);
+        std::vector<Move> moves;
+        while (!game.isGameOver() && static_cast<int>(moves.size()) < maxTurns)
+        {
+            moves.push_back(randomMove(game.getState(), pick));
+            game.playMove(moves.back());
+        }
+        score = game.getScore();
+        finished = game.isGameOver();
+        return moves;
+    }
+}
+
+TEST(gameVerifierVerdicts)
+{
+    int score = 0;
+    bool finished = false;
+    std::vector<Move> moves = playGame(1, 3000, score, finished);
+    CHECK(finished && moves.size() > 3);
+    if (!finished || moves.size() <= 3)
+        return;
+
+    GameBatch batch;
+    batch.add(1, score, moves);
+    batch.add(1, score + 10, moves);
+
+    std::vector<Move> illegal = moves;
+    illegal[3] = {-1, 0, 0, 0}; // Spoza planszy
+    batch.add(1, score, illegal);
+
+    std::vector<Move> afterEnd = moves;
+    afterEnd.push_back(moves.back());
+    batch.add(1, score, afterEnd);
+
+    GameVerifier verifier;
+    std::vector<Verification> results;
+    CHECK(verifier.verify(batch, results, 2) > 0);
+    CHECK(results.size() == 4);
+    CHECK(results[0].verdict == Verification::Valid && results[0].move == -1 && results[0].score == score);
+    CHECK(results[1].verdict == Verification::ScoreMismatch);
+    CHECK(results[2].verdict == Verification::IllegalMove && results[2].move == 3);
+    CHECK(results[3].verdict == Verification::MoveAfterEnd &&
+          results[3].move == static_cast<std::int32_t>(moves.size()));
+}
+
+TEST(gameVerifierLoadsBatchAndReportsExitCode)
+{
+    int score = 0;
+    bool finished = false;
+    std::vector<Move> moves = playGame(9, 80, score, finished);
+
+    std::string path = tempPath("games.txt");
+    {
+        std::ofstream out(path);
+        out << "# ziarno wynik ruchy\n" << 9 << " " << score;
+        for (const Move& move : moves)
+            out << " " << move.fromX << " " << move.fromY << " " << move.toX << " " << move.toY;
+        out << "\n";
+    }
+    GameBatch batch;
+    CHECK(GameVerifier::loadBatch(path, batch));
+    CHECK(batch.size() == 1 && batch.moves.size() == moves.size() && batch.claimedScores[0] == score);
+    CHECK(GameVerifier::run(path, 1) == 0);
+
+    {
+        std::ofstream out(path, std::ios::app);
+        out << 9 << " " << score + 1 << "\n";
+    }
+    CHECK(GameVerifier::run(path, 1) == 2);
+    std::remove(path.c_str());
+    CHECK(GameVerifier::run(path, 1) == 1);
+}
@@ -0,0 +1,82 @@
+#include "Test.hpp"
+#include "../include/Board.hpp"
+#include "../include/HeadlessGame.hpp"
+
+namespace
+{
+    bool sameGame(const HeadlessGame& a, const HeadlessGame& b)
+    {
+        const BoardState& x = a.getState();
+        const BoardState& y = b.getState();
+        return x.cells == y.cells && x.nextBalls == y.nextBalls && x.score == y.score && x.combo == y.combo &&
+               a.getTurn() == b.getTurn() && a.isGameOver() == b.isGameOver();
+    }
+}
+
+TEST(compactGameRoundTripContinuesIdentically)
+{
+    std::mt19937 pick(5);
+    HeadlessGame game(9, 9, 0);
+    game.reset(777);
+    // Uśpienie w kilku punktach gry, także po wielu odcinkach generatora
+    for (int checkpoint = 0; checkpoint < 6 && !game.isGameOver(); ++checkpoint)
+    {
+        for (int turn = 0; turn < 40 && !game.isGameOver(); ++turn)
+            game.playMove(randomMove(game.getState(), pick));
+
+        CompactGame compact;
+        CHECK(game.hibernate(compact));
+        HeadlessGame woken(9, 9, 0);
+        CHECK(woken.restore(compact));
+        CHECK(sameGame(game, woken));
+
+        HeadlessGame copy = game;
+        bool same = true;
+        std::mt19937 follow(checkpoint);
+        for (int turn = 0; turn < 30 && !copy.isGameOver(); ++turn)
+        {
+            Move move = randomMove(copy.getState(), follow);
+            copy.playMove(move);
+            woken.playMove(move);
+            same = same && sameGame(copy, woken);
+        }
+        CHECK(same);
+    }
+}
+
+TEST(compactGameRejectsLargeBoards)
+{
+    HeadlessGame game(11, 11, 3);
+    CompactGame compact;
+    CHECK(!game.hibernate(compact));
+}
+
+TEST(headlessGameMatchesBoardDrawForDraw)
+{
+    // Te same ziarna i ruchy - te same kulki, wyniki i koniec gry co w oknie
+    for (unsigned int seed = 1; seed <= 5; ++seed)
+    {
+        std::mt19937 pick(seed);
+        Board board(9, 9);
+        board.reset(seed * 1000);
+        HeadlessGame game(9, 9, 0);
+        game.reset(seed * 1000);
+
+        bool same = board.snapshot().cells == game.getState().cells;
+        for (int turn = 0; turn < 400 && same && !board.isGameOver(); ++turn)
+        {
+            Move move = randomMove(board.snapshot(), pick);
+            if (move.fromX < 0)
+                break;
+            board.moveBall(move.fromX, move.fromY, move.toX, move.toY);
+            board.settleAnimations();
+            game.playMove(move);
+
+            BoardState state = board.snapshot();
+            same = state.cells == game.getState().cells && state.nextBalls == game.getState().nextBalls &&
+                   board.getScore() == game.getScore() && board.getCombo() == game.getState().combo &&
+                   board.isGameOver() == game.isGameOver();
+        }
+        CHECK(same);
+    }
+}
@@ -0,0 +1,98 @@
+#include "Test.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/Board.hpp"
+#include "../include/LiveGameFile.hpp"
+
+namespace
+{
+    const size_t FileHeaderBytes = 16;
+
+    void writeRecord(LiveGameFile& file, int score)
+    {
+        LiveGameRecord& record = file.beginWrite();
+        record.width = 9;
+        record.height = 9;
+        record.score = score;
+        record.nextCount = 0;
+        file.commit();
+    }
+}
+
+TEST(liveGameFilePicksNewestValidSlot)
+{
+    std::string path = tempPath("slots.live");
+    {
+        LiveGameFile file;
+        CHECK(file.open(path));
+        CHECK(file.latest() == nullptr);
+        for (int score = 1; score <= 3; ++score)
+            writeRecord(file, score);
+        CHECK(file.latest() && file.latest()->score == 3);
+    }
+    {
+        LiveGameFile file;
+        CHECK(file.open(path));
+        CHECK(file.latest() && file.latest()->score == 3);
+    }
+
+    // Zapisy idą na przemian do slotów 0, 1, 0 - psujemy najnowszy (slot 0), wygrywa starszy
+    int fd = ::open(path.c_str(), O_WRONLY);
+    CHECK(fd >= 0);
+    std::uint8_t torn = 0x5A;
+    CHECK(::pwrite(fd, &torn, 1, FileHeaderBytes + offsetof(LiveGameRecord, cells) + 10) == 1);
+    ::close(fd);
+
+    LiveGameFile file;
+    CHECK(file.open(path));
+    CHECK(file.latest() && file.latest()->score == 2);
+    // Następny zapis trafia do uszkodzonego slotu, a nie do jedynego poprawnego
+    writeRecord(file, 4);
+    CHECK(file.latest() && file.latest()->score == 4);
+    file.close();
+    std::remove(path.c_str());
+}
+
+TEST(boardResumesLiveGameAndContinuesIdentically)
+{
+    std::string path = tempPath("board.live");
+    std::mt19937 pick(3);
+    LiveGameFile file;
+    CHECK(file.open(path));
+    Board original(9, 9);
+    original.attachLiveFile(&file);
+    original.reset(123);
+    for (int turn = 0; turn < 60 && !original.isGameOver(); ++turn)
+    {
+        Move move = randomMove(original.snapshot(), pick);
+        original.moveBall(move.fromX, move.fromY, move.toX, move.toY);
+        original.settleAnimations();
+    }
+    original.attachLiveFile(nullptr);
+    file.close();
+
+    LiveGameFile reopened;
+    CHECK(reopened.open(path));
+    Board resumed(9, 9);
+    CHECK(reopened.latest() && resumed.resumeLive(*reopened.latest()));
+    CHECK(resumed.snapshot().cells == original.snapshot().cells);
+    CHECK(resumed.getScore() == original.getScore());
+
+    bool same = true;
+    for (int turn = 0; turn < 100 && same && !original.isGameOver(); ++turn)
+    {
+        Move move = randomMove(original.snapshot(), pick);
+        original.moveBall(move.fromX, move.fromY, move.toX, move.toY);
+        original.settleAnimations();
+        resumed.moveBall(move.fromX, move.fromY, move.toX, move.toY);
+        resumed.settleAnimations();
+        same = original.snapshot().cells == resumed.snapshot().cells &&
+               original.snapshot().nextBalls == resumed.snapshot().nextBalls &&
+               original.getScore() == resumed.getScore();
+    }
+    CHECK(same);
+    reopened.close();
+    std::remove(path.c_str());
+}
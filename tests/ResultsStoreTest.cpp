@@ -0,0 +1,102 @@
+#include "Test.hpp"
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/ResultsStore.hpp"
+
+namespace
+{
+    ResultRecord makeResult(std::int32_t score, std::uint32_t seed, std::uint16_t variant)
+    {
+        ResultRecord result;
+        result.score = score;
+        result.seed = seed;
+        result.variant = variant;
+        result.turns = 10;
+        result.timestamp = 1;
+        return result;
+    }
+
+    off_t fileSize(const std::string& path)
+    {
+        struct stat info;
+        return ::stat(path.c_str(), &info) == 0 ? info.st_size : -1;
+    }
+}
+
+TEST(resultsStoreReopenKeepsCommittedRecords)
+{
+    std::string path = tempPath("results.db");
+    {
+        ResultsStore store;
+        CHECK(store.open(path));
+        for (int i = 0; i < 100; ++i)
+            store.append(makeResult(i * 10, static_cast<std::uint32_t>(i), static_cast<std::uint16_t>(i % 2)));
+        store.flush();
+    }
+
+    ResultsStore store;
+    CHECK(store.open(path));
+    CHECK(store.size() == 100);
+    CHECK(store.best(0) == 980);
+    CHECK(store.best(1) == 990);
+    std::vector<ResultRecord> top = store.topK(1, 3);
+    CHECK(top.size() == 3 && top[0].score == 990 && top[2].score == 950);
+    std::vector<ResultRecord> bySeed = store.bySeed(42);
+    CHECK(bySeed.size() == 1 && bySeed[0].score == 420);
+    store.close();
+    std::remove(path.c_str());
+}
+
+TEST(resultsStoreTruncatesTornTail)
+{
+    std::string path = tempPath("torn.db");
+    {
+        ResultsStore store;
+        CHECK(store.open(path));
+        for (int i = 0; i < 5; ++i)
+            store.append(makeResult(i, static_cast<std::uint32_t>(i), 0));
+        store.flush();
+    }
+    off_t complete = fileSize(path);
+
+    // Urwany zapis: pół rekordu na końcu
+    int fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+    CHECK(fd >= 0);
+    char garbage[sizeof(ResultRecord) / 2] = {1, 2, 3};
+    CHECK(::write(fd, garbage, sizeof(garbage)) == static_cast<ssize_t>(sizeof(garbage)));
+    ::close(fd);
+
+    ResultsStore store;
+    CHECK(store.open(path));
+    CHECK(store.size() == 5);
+    CHECK(fileSize(path) == complete);
+    store.append(makeResult(100, 100, 0));
+    store.flush();
+    store.close();
+
+    CHECK(store.open(path));
+    CHECK(store.size() == 6);
+    CHECK(store.best(0) == 100);
+    store.close();
+    std::remove(path.c_str());
+}
+
+TEST(resultsStoreRejectsForeignFileWithoutTouchingIt)
+{
+    // Plik krótszy od nagłówka i plik z obcym nagłówkiem - oba zostają nietknięte
+    const char* contents[] = {"KRS", "not a results database"};
+    for (const char* text : contents)
+    {
+        std::string path = tempPath("foreign.db");
+        FILE* file = std::fopen(path.c_str(), "wb");
+        std::fputs(text, file);
+        std::fclose(file);
+
+        ResultsStore store;
+        CHECK(!store.open(path));
+        CHECK(fileSize(path) == static_cast<off_t>(std::string(text).size()));
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,78 @@
+#include "Test.hpp"
+#include <cmath>
+#include <cstdio>
+#include "../include/RetrogradeSolver.hpp"
+
+namespace
+{
+    // Losowa plansza bez linii z dwiema następnymi kulkami
+    BoardState randomLineFree(std::mt19937& pick, int colors)
+    {
+        BoardState state(3, 3);
+        do
+        {
+            for (int& cell : state.cells)
+                cell = pick() % 2 ? static_cast<int>(1 + pick() % colors) : 0;
+        } while (!state.findAllLines().empty());
+        state.nextBalls = {static_cast<BallColor>(pick() % colors), static_cast<BallColor>(pick() % colors)};
+        return state;
+    }
+}
+
+TEST(retrogradeTableIndexesEveryState)
+{
+    std::string path = tempPath("solver.ksv");
+    SolverVariant variant;
+    variant.colors = 2;
+    CHECK(RetrogradeSolver::run(path, variant, 3, 2) == 0);
+
+    SolverTable table;
+    CHECK(table.open(path));
+    CHECK(table.getVariant().width == 3 && table.getVariant().colors == 2);
+
+    std::mt19937 pick(31);
+    bool inRange = true, colorSymmetric = true, legalBest = true;
+    for (int i = 0; i < 2000; ++i)
+    {
+        BoardState state = randomLineFree(pick, 2);
+        float value = table.value(state);
+        inRange = inRange && value >= 0.0f && value <= 1.0f;
+
+        // Zasady nie zależą od koloru - zamiana kolorów w planszy i kulkach nie zmienia wartości.
+        // Zły indeks (potęgi, kolejność pól, para kulek) trafiłby tu w inny wpis tablicy.
+        BoardState swapped = state;
+        for (int& cell : swapped.cells)
+            cell = cell == 0 ? 0 : 3 - cell;
+        for (BallColor& ball : swapped.nextBalls)
+            ball = static_cast<BallColor>(1 - static_cast<int>(ball));
+        colorSymmetric = colorSymmetric && std::fabs(table.value(swapped) - value) < 1e-5f;
+
+        Move best = table.bestMove(state);
+        if (best.fromX >= 0)
+        {
+            std::vector<int> labels;
+            state.labelEmptyRegions(labels);
+            legalBest = legalBest && !state.isEmpty(best.fromX, best.fromY) && state.canReach(labels, best);
+        }
+        else
+        {
+            legalBest = legalBest && state.legalMoves().empty();
+        }
+    }
+    CHECK(inRange);
+    CHECK(colorSymmetric);
+    CHECK(legalBest);
+
+    // Pełna plansza bez linii: koniec gry, brak ruchu
+    BoardState full(3, 3);
+    full.cells = {1, 1, 2, 2, 2, 1, 1, 1, 2};
+    full.nextBalls = {BallColor(0), BallColor(1)};
+    CHECK(full.findAllLines().empty());
+    CHECK(table.value(full) == 0.0f);
+    CHECK(table.bestMove(full).fromX == -1);
+
+    // Inny rozmiar planszy nie należy do wariantu
+    CHECK(!table.matches(BoardState(4, 4)));
+    table.close();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,125 @@
+#include "Test.hpp"
+#include "../include/Board.hpp"
+#include "../include/Snapshot.hpp"
+
+namespace
+{
+    void playTurn(Board& board, const Move& move)
+    {
+        board.moveBall(move.fromX, move.fromY, move.toX, move.toY);
+        board.settleAnimations();
+    }
+
+    bool sameState(const BoardState& a, const BoardState& b)
+    {
+        return a.cells == b.cells && a.nextBalls == b.nextBalls && a.score == b.score && a.combo == b.combo;
+    }
+}
+
+TEST(countingRngResumeContinuesStream)
+{
+    // Punkty wznowienia na granicach odcinków i w ich środku
+    const std::uint64_t points[] = {0, 1, 1023, 1024, 1025, 2048, 5000};
+    for (std::uint64_t point : points)
+    {
+        CountingRng rng(12345);
+        for (std::uint64_t i = 0; i < point; ++i)
+            rng();
+        CountingRng resumed = CountingRng::resume(rng.segmentSeed, rng.draws);
+        bool same = true;
+        for (int i = 0; i < 3000; ++i)
+            same = same && rng() == resumed();
+        CHECK(same);
+        CHECK(resumed.draws == rng.draws);
+        CHECK(resumed.segmentSeed == rng.segmentSeed);
+    }
+}
+
+TEST(cowGridRoundTripSharesUnchangedChunks)
+{
+    std::mt19937 pick(7);
+    BoardState state(9, 9);
+    for (int& cell : state.cells)
+        cell = static_cast<int>(pick() % 7);
+
+    CowGrid grid = CowGrid::fromState(state, nullptr);
+    CHECK(grid.toState().cells == state.cells);
+    bool cellsMatch = true;
+    for (int y = 0; y < 9; ++y)
+        for (int x = 0; x < 9; ++x)
+            cellsMatch = cellsMatch && grid.at(x, y) == state.at(x, y);
+    CHECK(cellsMatch);
+
+    // Jedno zmienione pole - nowy jest tylko jego kawałek
+    state.set(4, 4, state.at(4, 4) % 6 + 1);
+    CowGrid next = CowGrid::fromState(state, &grid);
+    CHECK(next.toState().cells == state.cells);
+    size_t changed = 0;
+    for (size_t i = 0; i < next.chunkCount(); ++i)
+        changed += next.chunk(i) != grid.chunk(i);
+    CHECK(changed == 1);
+
+    // Zapis do kopii nie zmienia oryginału
+    CowGrid copy = next;
+    int before = next.at(0, 0);
+    copy.set(0, 0, before % 6 + 1);
+    CHECK(next.at(0, 0) == before);
+    CHECK(copy.at(0, 0) == before % 6 + 1);
+}
+
+TEST(snapshotHistoryDropsOldestTurns)
+{
+    SnapshotHistory history(3);
+    BoardState state(9, 9);
+    CountingRng rng(1);
+    for (int turn = 0; turn < 5; ++turn)
+    {
+        state.score = turn;
+        BoardSnapshot extra;
+        extra.turn = turn;
+        history.capture(state, rng, extra);
+    }
+    CHECK(history.size() == 3);
+    CHECK(history.current()->turn == 4);
+    CHECK(history.undo()->turn == 3);
+    CHECK(history.undo()->turn == 2);
+    CHECK(!history.canUndo());
+    CHECK(history.redo()->score == 3);
+}
+
+TEST(boardUndoRedoRestoresEveryTurn)
+{
+    std::mt19937 pick(11);
+    Board board(9, 9);
+    board.reset(2024);
+    std::vector<BoardState> states{board.snapshot()};
+    std::vector<Move> moves;
+    for (int turn = 0; turn < 25 && !board.isGameOver(); ++turn)
+    {
+        Move move = randomMove(board.snapshot(), pick);
+        moves.push_back(move);
+        playTurn(board, move);
+        states.push_back(board.snapshot());
+    }
+
+    bool undone = true;
+    for (size_t i = states.size() - 1; i > 0; --i)
+        undone = undone && board.undo() && sameState(board.snapshot(), states[i - 1]);
+    CHECK(undone);
+    CHECK(!board.undo());
+
+    bool redone = true;
+    for (size_t i = 1; i < states.size(); ++i)
+        redone = redone && board.redo() && sameState(board.snapshot(), states[i]);
+    CHECK(redone);
+    CHECK(!board.redo());
+
+    // Po cofnięciu generator wraca razem z planszą - ten sam ruch daje te same nowe kulki
+    const size_t back = 5;
+    for (size_t i = 0; i < back; ++i)
+        board.undo();
+    size_t turn = states.size() - 1 - back;
+    playTurn(board, moves[turn]);
+    CHECK(sameState(board.snapshot(), states[turn + 1]));
+    CHECK(!board.redo());
+}
@@ -0,0 +1,91 @@
+#include "Test.hpp"
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/Board.hpp"
+#include "../include/StateStream.hpp"
+
+namespace
+{
+    bool mirrors(const MirrorBoard& mirror, const Board& board)
+    {
+        BoardState seen = mirror.toState();
+        BoardState state = board.snapshot();
+        return mirror.synced && seen.cells == state.cells && seen.nextBalls == state.nextBalls &&
+               seen.score == state.score && seen.combo == state.combo && mirror.gameOver == board.isGameOver();
+    }
+
+    // Bajty podawane w kawałkach losowej długości - niepełna operacja czeka na resztę
+    bool applyInPieces(MirrorBoard& mirror, std::vector<std::uint8_t>& buffer, const std::vector<std::uint8_t>& bytes,
+                       std::mt19937& pick)
+    {
+        for (size_t offset = 0; offset < bytes.size();)
+        {
+            size_t piece = std::min<size_t>(bytes.size() - offset, 1 + pick() % 7);
+            buffer.insert(buffer.end(), bytes.begin() + offset, bytes.begin() + offset + piece);
+            offset += piece;
+            long used = mirror.apply(buffer.data(), buffer.size());
+            if (used < 0)
+                return false;
+            buffer.erase(buffer.begin(), buffer.begin() + used);
+        }
+        return true;
+    }
+}
+
+TEST(stateStreamRoundTripMirrorsBoard)
+{
+    std::mt19937 pick(21);
+    StateStreamWriter writer;
+    Board board(9, 9);
+    board.addObserver(&writer);
+    board.reset(99);
+
+    MirrorBoard mirror;
+    std::vector<std::uint8_t> buffer;
+    bool ok = true;
+    for (int turn = 0; turn < 200 && ok && !board.isGameOver(); ++turn)
+    {
+        Move move = randomMove(board.snapshot(), pick);
+        board.moveBall(move.fromX, move.fromY, move.toX, move.toY);
+        board.settleAnimations();
+
+        ok = applyInPieces(mirror, buffer, writer.pendingBytes(), pick) && mirrors(mirror, board);
+        writer.flush();
+    }
+    CHECK(ok);
+    CHECK(buffer.empty());
+    board.removeObserver(&writer);
+}
+
+TEST(stateStreamSinkJoiningMidFrameStartsFromSnapshot)
+{
+    std::mt19937 pick(22);
+    StateStreamWriter writer;
+    Board board(9, 9);
+    board.addObserver(&writer);
+    board.reset(100);
+
+    // Pierwsza połowa ruchu w buforze, zanim widz dołączy
+    Move move = randomMove(board.snapshot(), pick);
+    board.selectBall(move.fromX, move.fromY);
+    int fds[2];
+    CHECK(::pipe(fds) == 0);
+    ::fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    writer.addSink(fds[1]);
+    board.moveBall(move.fromX, move.fromY, move.toX, move.toY);
+    board.settleAnimations();
+    writer.flush();
+
+    std::vector<std::uint8_t> bytes(1 << 16);
+    ssize_t got = ::read(fds[0], bytes.data(), bytes.size());
+    CHECK(got > 0);
+    bytes.resize(got > 0 ? static_cast<size_t>(got) : 0);
+
+    MirrorBoard mirror;
+    CHECK(mirror.apply(bytes.data(), bytes.size()) == static_cast<long>(bytes.size()));
+    CHECK(mirrors(mirror, board));
+
+    board.removeObserver(&writer);
+    ::close(fds[0]);
+}
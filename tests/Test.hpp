@@ -0,0 +1,48 @@
+#pragma once
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../include/BoardState.hpp"
+
+// Minimalne testy bez zewnętrznych bibliotek: TEST rejestruje funkcję, CHECK zlicza niespełnione warunki,
+// a test jest nieudany, gdy po jego przebiegu licznik wzrósł.
+struct TestCase
+{
+    const char* name;
+    void (*body)();
+};
+
+std::vector<TestCase>& testRegistry();
+int& testFailures();
+// Ścieżka pliku tymczasowego unikalna dla przebiegu (usuwana przed zwróceniem)
+std::string tempPath(const std::string& name);
+
+// Losowy legalny ruch (gry testowe); {-1, -1, -1, -1}, gdy nie ma żadnego
+inline Move randomMove(const BoardState& state, std::mt19937& pick)
+{
+    std::vector<Move> moves = state.legalMoves();
+    if (moves.empty())
+        return {-1, -1, -1, -1};
+    return moves[pick() % moves.size()];
+}
+
+struct TestRegistrar
+{
+    TestRegistrar(const char* name, void (*body)()) { testRegistry().push_back({name, body}); }
+};
+
+#define TEST(name)                                       \
+    static void name();                                  \
+    static TestRegistrar name##Registrar(#name, name);   \
+    static void name()
+
+#define CHECK(condition)                                                                              \
+    do                                                                                                \
+    {                                                                                                 \
+        if (!(condition))                                                                             \
+        {                                                                                             \
+            testFailures()++;                                                                         \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": niespełnione: " #condition << std::endl;   \
+        }                                                                                             \
+    } while (false)
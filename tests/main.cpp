@@ -0,0 +1,38 @@
+#include "Test.hpp"
+#include <cstdio>
+#include <unistd.h>
+
+std::vector<TestCase>& testRegistry()
+{
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+int& testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+std::string tempPath(const std::string& name)
+{
+    std::string path = "/tmp/kulki_test_" + std::to_string(::getpid()) + "_" + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+// make test: wszystkie testy po kolei; kod wyjścia 1, gdy którykolwiek się nie powiódł
+int main()
+{
+    int failed = 0;
+    for (const auto& test : testRegistry())
+    {
+        int before = testFailures();
+        test.body();
+        bool ok = testFailures() == before;
+        failed += !ok;
+        std::cout << (ok ? "[ OK ] " : "[BŁĄD] ") << test.name << std::endl;
+    }
+    std::cout << testRegistry().size() - failed << "/" << testRegistry().size() << " testów poprawnych" << std::endl;
+    return failed == 0 ? 0 : 1;
+}